@@ -51,12 +51,7 @@ struct sorter
         std::list<T> new_higher(do_sort(chunk_data));
 
         result.splice(result.end(),new_higher);
-        while(!new_lower.is_ready())
-        {
-            pool.schedule_one_or_yield();
-        }
-
-        result.splice(result.begin(),new_lower.get());
+        result.splice(result.begin(),new_lower.get(pool));
         return result;
     }
 };
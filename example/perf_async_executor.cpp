@@ -0,0 +1,83 @@
+//  (C) Copyright 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// This performance test measures the cost of async(ex, f).get() on a thread pool, directly and through the
+// polymorphic executor_adaptor, and counts the heap allocations done by each call.
+
+#define BOOST_THREAD_VERSION 4
+#define BOOST_THREAD_PROVIDES_EXECUTORS
+#define BOOST_THREAD_USES_CHRONO
+
+#include <iostream>
+#include <limits>
+#include <new>
+#include <cstdlib>
+#include <boost/thread/future.hpp>
+#include <boost/thread/executors/basic_thread_pool.hpp>
+#include <boost/thread/executors/executor_adaptor.hpp>
+#include <boost/atomic.hpp>
+#include <boost/chrono/chrono_io.hpp>
+
+boost::atomic<long> allocations(0);
+
+void* operator new(std::size_t size)
+{
+  allocations.fetch_add(1, boost::memory_order_relaxed);
+  if (void* p = std::malloc(size)) return p;
+  throw std::bad_alloc();
+}
+void operator delete(void* p) BOOST_NOEXCEPT
+{
+  std::free(p);
+}
+
+const int calls = 100000;
+
+typedef boost::chrono::high_resolution_clock Clock;
+
+int identity(int i)
+{
+  return i;
+}
+
+template <class Executor>
+Clock::duration async_get(Executor& ex, long& allocs)
+{
+  long sum = 0;
+  long const a = allocations.load();
+  Clock::time_point s = Clock::now();
+  for (int i = 0; i < calls; ++i)
+  {
+    sum += boost::async(ex, &identity, i).get();
+  }
+  Clock::time_point e = Clock::now();
+  allocs = allocations.load() - a;
+  if (sum == 0) std::cout << sum << std::endl;
+  return e - s;
+}
+
+int main()
+{
+  boost::basic_thread_pool pool(1);
+  boost::executor_adaptor<boost::basic_thread_pool> adaptor(1);
+  Clock::duration best_pool(std::numeric_limits<Clock::duration::rep>::max BOOST_PREVENT_MACRO_SUBSTITUTION ());
+  Clock::duration best_adaptor(std::numeric_limits<Clock::duration::rep>::max BOOST_PREVENT_MACRO_SUBSTITUTION ());
+  long allocs_pool = 0;
+  long allocs_adaptor = 0;
+  for (int i = 5; i > 0; --i)
+  {
+    best_pool = std::min BOOST_PREVENT_MACRO_SUBSTITUTION (best_pool, async_get(pool, allocs_pool));
+    best_adaptor = std::min BOOST_PREVENT_MACRO_SUBSTITUTION (best_adaptor, async_get(adaptor, allocs_adaptor));
+  }
+  std::cout << "async(basic_thread_pool, f).get() Best Time spent:" << best_pool << std::endl;
+  std::cout << "async(basic_thread_pool, f).get() Time spent/call:" << best_pool / calls << std::endl;
+  std::cout << "async(basic_thread_pool, f).get() allocations/call:" << double(allocs_pool) / calls << std::endl;
+  std::cout << "async(executor_adaptor, f).get() Best Time spent:" << best_adaptor << std::endl;
+  std::cout << "async(executor_adaptor, f).get() Time spent/call:" << best_adaptor / calls << std::endl;
+  std::cout << "async(executor_adaptor, f).get() allocations/call:" << double(allocs_adaptor) / calls << std::endl;
+
+  return 0;
+}
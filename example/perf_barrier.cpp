@@ -0,0 +1,53 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Measures the latency of a phase of boost::barrier and boost::tree_barrier from 2 to 128 participants, each of them
+// waiting on the barrier in a loop.
+
+#define BOOST_THREAD_VERSION 4
+
+#include <iostream>
+#include <boost/thread/barrier.hpp>
+#include <boost/thread/tree_barrier.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/chrono/chrono_io.hpp>
+
+const int phases = 2000;
+
+template <class Barrier>
+void participate(Barrier& b)
+{
+  for (int i = 0; i < phases; ++i) b.wait();
+}
+
+template <class Barrier>
+boost::chrono::nanoseconds run(unsigned participants)
+{
+  typedef boost::chrono::high_resolution_clock Clock;
+  Clock::duration best_time((Clock::duration::max)());
+  for (int i = 3; i > 0; --i)
+  {
+    Barrier b(participants);
+    Clock::time_point s1 = Clock::now();
+    boost::thread_group g;
+    for (unsigned t = 1; t < participants; ++t) g.create_thread(boost::bind(participate<Barrier>, boost::ref(b)));
+    participate(b);
+    Clock::time_point f1 = Clock::now();
+    g.join_all();
+    best_time = (std::min)(best_time, f1 - s1);
+  }
+  return boost::chrono::duration_cast<boost::chrono::nanoseconds>(best_time) / phases;
+}
+
+int main()
+{
+  for (unsigned participants = 2; participants <= 128; participants *= 2)
+  {
+    std::cout << participants << " participants: barrier " << run<boost::barrier>(participants)
+              << " tree_barrier " << run<boost::tree_barrier>(participants) << " per phase" << std::endl;
+  }
+  return 0;
+}
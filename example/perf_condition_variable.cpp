@@ -11,6 +11,7 @@
 
 #include <boost/thread/condition_variable.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/fast_condition_variable.hpp>
 #include <boost/chrono/stopwatches/simple_stopwatch.hpp>
 
 #include <condition_variable>
@@ -63,6 +64,13 @@ namespace
     typedef boost::mutex::scoped_lock scoped_lock;
   };
 
+  struct FastTypes
+  {
+    typedef boost::fast_condition_variable condition_variable;
+    typedef boost::fast_mutex mutex;
+    typedef boost::unique_lock<boost::fast_mutex> scoped_lock;
+  };
+
   struct StdTypes
   {
     typedef std::condition_variable condition_variable;
@@ -187,6 +195,8 @@ namespace
 
  Condition variable with thread cancellation support is boost::condition_variable from
  boost-1.51. Without - std::condition_variable that comes with gcc-4.7.2.
+ On Linux, boost::condition_variable and boost::fast_condition_variable now support the cancellation
+ without an internal mutex, and the latter requeues the waiters of notify_all() to its mutex.
 
  One producer, one to CONSUMER_MAX consumers. The benchmark calls
  condition_variable::notify_all() without holding a mutex to maximize contention within this
@@ -209,7 +219,7 @@ int main()
 
   struct
   {
-    Stopwatch::rep boost, std;
+    Stopwatch::rep boost, std, fast;
   } best_times[CONSUMER_MAX] = {};
 
   for (unsigned i = 1; i <= CONSUMER_MAX; ++i)
@@ -219,19 +229,23 @@ int main()
     b.std = benchmark_ping_pong<StdTypes> (i);
     std::printf("BOOST: %d\n", i);
     b.boost = benchmark_ping_pong<BoostTypes> (i);
+    std::printf("FAST: %d\n", i);
+    b.fast = benchmark_ping_pong<FastTypes> (i);
 
     std::printf("consumers:                 %4d\n", i);
     std::printf("best std producer time:   %15.9fsec\n", b.std * 1e-9);
     std::printf("best boost producer time: %15.9fsec\n", b.boost * 1e-9);
+    std::printf("best fast producer time:  %15.9fsec\n", b.fast * 1e-9);
     std::printf("(std - boost) / std:       %7.2f%%\n", (b.std - b.boost) * 100. / b.std);
+    std::printf("(std - fast) / std:        %7.2f%%\n", (b.std - b.fast) * 100. / b.std);
   }
 
   printf("\ncsv:\n\n");
-  printf("consumers,(std-boost)/std,std,boost\n");
+  printf("consumers,(std-boost)/std,(std-fast)/std,std,boost,fast\n");
   for (unsigned i = 1; i <= CONSUMER_MAX; ++i)
   {
     auto& b = best_times[i - 1];
-    printf("%d,%f,%lld,%lld\n", i, (b.std - b.boost) * 100. / b.std, b.std, b.boost);
+    printf("%d,%f,%f,%lld,%lld,%lld\n", i, (b.std - b.boost) * 100. / b.std, (b.std - b.fast) * 100. / b.std, b.std, b.boost, b.fast);
   }
   return 1;
 }
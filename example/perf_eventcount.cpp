@@ -0,0 +1,128 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Blocking on a lock-free stock of items: a producer adds items that 1 to 8 consumers take with a compare and swap,
+// the consumers blocking when it is empty on a boost::eventcount, and on a mutex and a condition variable that the
+// producer locks to notify, as the executors wait for work.
+
+#define BOOST_THREAD_VERSION 4
+
+#include <iostream>
+#include <boost/thread/eventcount.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/chrono/chrono_io.hpp>
+
+const int items = 200000;
+
+class stock
+{
+  boost::atomic<int> count_;
+public:
+  stock() : count_(0) {}
+  void add()
+  {
+    count_.fetch_add(1, boost::memory_order_release);
+  }
+  bool try_take()
+  {
+    int c = count_.load(boost::memory_order_relaxed);
+    while (c > 0)
+    {
+      if (count_.compare_exchange_weak(c, c - 1, boost::memory_order_acquire, boost::memory_order_relaxed)) return true;
+    }
+    return false;
+  }
+};
+
+class locked_stock : stock
+{
+  boost::mutex mutex_;
+  boost::condition_variable cond_;
+  int waiting_;
+public:
+  locked_stock() : waiting_(0) {}
+  void add()
+  {
+    stock::add();
+    boost::unique_lock<boost::mutex> lk(mutex_);
+    if (waiting_ != 0)
+    {
+      lk.unlock();
+      cond_.notify_one();
+    }
+  }
+  void take()
+  {
+    if (try_take()) return;
+    boost::unique_lock<boost::mutex> lk(mutex_);
+    ++waiting_;
+    while (! try_take()) cond_.wait(lk);
+    --waiting_;
+  }
+};
+
+class eventcount_stock : stock
+{
+  boost::eventcount ec_;
+public:
+  void add()
+  {
+    stock::add();
+    ec_.notify_one();
+  }
+  void take()
+  {
+    while (! try_take())
+    {
+      boost::eventcount::key_type key = ec_.prepare_wait();
+      if (try_take())
+      {
+        ec_.cancel_wait();
+        return;
+      }
+      ec_.commit_wait(key);
+    }
+  }
+};
+
+template <class Stock>
+void consume(Stock& s, int n)
+{
+  for (int i = 0; i < n; ++i) s.take();
+}
+
+template <class Stock>
+boost::chrono::nanoseconds run(int consumers)
+{
+  typedef boost::chrono::high_resolution_clock Clock;
+  Clock::duration best_time((Clock::duration::max)());
+  for (int i = 5; i > 0; --i)
+  {
+    Stock s;
+    boost::thread_group g;
+    for (int t = 0; t < consumers; ++t) g.create_thread(boost::bind(consume<Stock>, boost::ref(s), items / consumers));
+    Clock::time_point s1 = Clock::now();
+    for (int j = 0; j < items; ++j) s.add();
+    g.join_all();
+    Clock::time_point f1 = Clock::now();
+    best_time = (std::min)(best_time, f1 - s1);
+  }
+  return boost::chrono::duration_cast<boost::chrono::nanoseconds>(best_time) / items;
+}
+
+int main()
+{
+  // the number of consumers divides items.
+  for (int consumers = 1; consumers <= 8; consumers *= 2)
+  {
+    std::cout << consumers << " consumers: locked stock " << run<locked_stock>(consumers)
+              << " eventcount stock " << run<eventcount_stock>(consumers) << " per item" << std::endl;
+  }
+  return 0;
+}
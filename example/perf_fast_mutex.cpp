@@ -0,0 +1,57 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Compares boost::fast_mutex with boost::mutex (a pthread_mutex_t) from 1 to 64 threads incrementing a counter.
+
+#define BOOST_THREAD_VERSION 4
+
+#include <iostream>
+#include <boost/thread/fast_mutex.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/lock_guard.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/chrono/chrono_io.hpp>
+
+const int cycles = 100000;
+
+template <class Mutex>
+void increment(Mutex& mtx, long& counter)
+{
+  for (int i = 0; i < cycles; ++i)
+  {
+    boost::lock_guard<Mutex> lk(mtx);
+    ++counter;
+  }
+}
+
+template <class Mutex>
+boost::chrono::nanoseconds run(int threads)
+{
+  typedef boost::chrono::high_resolution_clock Clock;
+  Clock::duration best_time((Clock::duration::max)());
+  for (int i = 5; i > 0; --i)
+  {
+    Mutex mtx;
+    long counter = 0;
+    Clock::time_point s1 = Clock::now();
+    boost::thread_group g;
+    for (int t = 0; t < threads; ++t) g.create_thread(boost::bind(increment<Mutex>, boost::ref(mtx), boost::ref(counter)));
+    g.join_all();
+    Clock::time_point f1 = Clock::now();
+    best_time = (std::min)(best_time, f1 - s1);
+  }
+  return boost::chrono::duration_cast<boost::chrono::nanoseconds>(best_time) / (cycles * threads);
+}
+
+int main()
+{
+  for (int threads = 1; threads <= 64; threads *= 2)
+  {
+    std::cout << threads << " threads: mutex " << run<boost::mutex>(threads)
+              << " fast_mutex " << run<boost::fast_mutex>(threads) << " per lock" << std::endl;
+  }
+  return 0;
+}
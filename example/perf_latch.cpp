@@ -0,0 +1,87 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Fan-in of tiny tasks: from 1 to 64 threads count down a boost::latch, whose count down is an atomic decrement,
+// and a latch whose count down locks a mutex and notifies a condition variable, as boost::latch used to do.
+
+#define BOOST_THREAD_VERSION 4
+
+#include <iostream>
+#include <boost/thread/latch.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/chrono/chrono_io.hpp>
+
+const int count_downs = 100000;
+
+class locked_latch
+{
+  boost::mutex mutex_;
+  boost::condition_variable cond_;
+  std::size_t count_;
+public:
+  explicit locked_latch(std::size_t count) : count_(count) {}
+  void count_down()
+  {
+    boost::unique_lock<boost::mutex> lk(mutex_);
+    if (--count_ == 0)
+    {
+      lk.unlock();
+      cond_.notify_all();
+    }
+  }
+  void wait()
+  {
+    boost::unique_lock<boost::mutex> lk(mutex_);
+    while (count_ != 0) cond_.wait(lk);
+  }
+};
+
+struct atomic_latch : boost::latch
+{
+  explicit atomic_latch(std::size_t count) : boost::latch(count + 1) {}
+  void wait()
+  {
+    count_down_and_wait();
+  }
+};
+
+template <class Latch>
+void count_down(Latch& l, int n)
+{
+  for (int i = 0; i < n; ++i) l.count_down();
+}
+
+template <class Latch>
+boost::chrono::nanoseconds run(int threads)
+{
+  typedef boost::chrono::high_resolution_clock Clock;
+  Clock::duration best_time((Clock::duration::max)());
+  for (int i = 5; i > 0; --i)
+  {
+    Latch l(count_downs);
+    Clock::time_point s1 = Clock::now();
+    boost::thread_group g;
+    for (int t = 0; t < threads; ++t) g.create_thread(boost::bind(count_down<Latch>, boost::ref(l), count_downs / threads));
+    l.wait();
+    Clock::time_point f1 = Clock::now();
+    g.join_all();
+    best_time = (std::min)(best_time, f1 - s1);
+  }
+  return boost::chrono::duration_cast<boost::chrono::nanoseconds>(best_time) / count_downs;
+}
+
+int main()
+{
+  // the number of threads divides count_downs.
+  for (int threads = 1; threads <= 32; threads *= 2)
+  {
+    std::cout << threads << " threads: locked latch " << run<locked_latch>(threads)
+              << " latch " << run<atomic_latch>(threads) << " per count down" << std::endl;
+  }
+  return 0;
+}
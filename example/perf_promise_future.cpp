@@ -0,0 +1,74 @@
+//  (C) Copyright 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// This performance test measures the cost of creating a promise/future pair, making it ready and
+// retrieving the value, which is dominated by the size of the shared state and by the
+// synchronization needed to observe that it is ready.
+
+#define BOOST_THREAD_VERSION 4
+#define BOOST_THREAD_USES_CHRONO
+
+#include <iostream>
+#include <limits>
+#include <boost/thread/future.hpp>
+#include <boost/chrono/chrono_io.hpp>
+
+const int pairs = 1000000;
+
+typedef boost::chrono::high_resolution_clock Clock;
+
+// set the value before retrieving it: the future is always ready when get() is called.
+Clock::duration ready_get()
+{
+  Clock::time_point s = Clock::now();
+  long sum = 0;
+  for (int i = 0; i < pairs; ++i)
+  {
+    boost::promise<int> p;
+    boost::future<int> f = p.get_future();
+    p.set_value(i);
+    sum += f.get();
+  }
+  Clock::time_point e = Clock::now();
+  if (sum == 0) std::cout << sum << std::endl;
+  return e - s;
+}
+
+// poll the state of a ready future several times before retrieving the value.
+Clock::duration ready_poll_get()
+{
+  Clock::time_point s = Clock::now();
+  long sum = 0;
+  for (int i = 0; i < pairs; ++i)
+  {
+    boost::promise<int> p;
+    boost::future<int> f = p.get_future();
+    p.set_value(i);
+    while (!f.is_ready()) {}
+    if (f.has_value() && !f.has_exception()) sum += f.get();
+  }
+  Clock::time_point e = Clock::now();
+  if (sum == 0) std::cout << sum << std::endl;
+  return e - s;
+}
+
+int main()
+{
+  Clock::duration best_get(std::numeric_limits<Clock::duration::rep>::max BOOST_PREVENT_MACRO_SUBSTITUTION ());
+  Clock::duration best_poll(std::numeric_limits<Clock::duration::rep>::max BOOST_PREVENT_MACRO_SUBSTITUTION ());
+  for (int i = 5; i > 0; --i)
+  {
+    best_get = std::min BOOST_PREVENT_MACRO_SUBSTITUTION (best_get, ready_get());
+    best_poll = std::min BOOST_PREVENT_MACRO_SUBSTITUTION (best_poll, ready_poll_get());
+  }
+  std::cout << "sizeof(shared_state<int>):" << sizeof(boost::detail::shared_state<int>) << std::endl;
+  std::cout << "set_value/get Best Time spent:" << best_get << std::endl;
+  std::cout << "set_value/get Time spent/pair:" << best_get / pairs << std::endl;
+  std::cout << "set_value/is_ready/get Best Time spent:" << best_poll << std::endl;
+  std::cout << "set_value/is_ready/get Time spent/pair:" << best_poll / pairs << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,86 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Hand-off of items: a producer releases items that 1 to 8 consumers acquire, through a boost::counting_semaphore and
+// through a semaphore made of a mutex, a condition variable and a count of waiters, as sync_bounded_queue waits.
+
+#define BOOST_THREAD_VERSION 4
+
+#include <iostream>
+#include <boost/thread/counting_semaphore.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/chrono/chrono_io.hpp>
+
+const int items = 200000;
+
+class locked_semaphore
+{
+  boost::mutex mutex_;
+  boost::condition_variable cond_;
+  int count_;
+  int waiting_;
+public:
+  explicit locked_semaphore(int count) : count_(count), waiting_(0) {}
+  void release()
+  {
+    boost::unique_lock<boost::mutex> lk(mutex_);
+    ++count_;
+    if (waiting_ != 0)
+    {
+      lk.unlock();
+      cond_.notify_one();
+    }
+  }
+  void acquire()
+  {
+    boost::unique_lock<boost::mutex> lk(mutex_);
+    while (count_ == 0)
+    {
+      ++waiting_;
+      cond_.wait(lk);
+      --waiting_;
+    }
+    --count_;
+  }
+};
+
+template <class Semaphore>
+void consume(Semaphore& s, int n)
+{
+  for (int i = 0; i < n; ++i) s.acquire();
+}
+
+template <class Semaphore>
+boost::chrono::nanoseconds run(int consumers)
+{
+  typedef boost::chrono::high_resolution_clock Clock;
+  Clock::duration best_time((Clock::duration::max)());
+  for (int i = 5; i > 0; --i)
+  {
+    Semaphore s(0);
+    boost::thread_group g;
+    for (int t = 0; t < consumers; ++t) g.create_thread(boost::bind(consume<Semaphore>, boost::ref(s), items / consumers));
+    Clock::time_point s1 = Clock::now();
+    for (int j = 0; j < items; ++j) s.release();
+    g.join_all();
+    Clock::time_point f1 = Clock::now();
+    best_time = (std::min)(best_time, f1 - s1);
+  }
+  return boost::chrono::duration_cast<boost::chrono::nanoseconds>(best_time) / items;
+}
+
+int main()
+{
+  // the number of consumers divides items.
+  for (int consumers = 1; consumers <= 8; consumers *= 2)
+  {
+    std::cout << consumers << " consumers: locked semaphore " << run<locked_semaphore>(consumers)
+              << " counting_semaphore " << run<boost::counting_semaphore>(consumers) << " per item" << std::endl;
+  }
+  return 0;
+}
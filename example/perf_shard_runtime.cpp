@@ -0,0 +1,75 @@
+//  (C) Copyright 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// This performance test measures the latency of a message bouncing between two shards of a shard_runtime, and the
+// throughput of a shard sending messages to another one, which benefits from the messages being published by
+// batches.
+
+#define BOOST_THREAD_VERSION 4
+#define BOOST_THREAD_PROVIDES_EXECUTORS
+#define BOOST_THREAD_USES_CHRONO
+
+#include <iostream>
+#include <boost/thread/executors/shard_runtime.hpp>
+#include <boost/chrono/chrono_io.hpp>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+
+const int round_trips = 100000;
+const int messages = 1000000;
+
+typedef boost::chrono::high_resolution_clock Clock;
+
+boost::shard_runtime* runtime = 0;
+boost::atomic<int> received(0);
+boost::atomic<bool> finished(false);
+
+void ping(int n)
+{
+  if (n == 0)
+  {
+    finished = true;
+    return;
+  }
+  runtime->submit_to(1 - runtime->this_shard(), boost::bind(ping, n - 1));
+}
+
+void receive()
+{
+  received.fetch_add(1, boost::memory_order_relaxed);
+}
+
+void send_all()
+{
+  for (int i = 0; i < messages; ++i)
+  {
+    runtime->submit_to(1, receive);
+    // let the shard publish what it has sent before its queue to the receiver is exhausted.
+    if (i % 512 == 511) runtime->try_executing_one();
+  }
+}
+
+int main()
+{
+  boost::shard_runtime rt(2);
+  runtime = &rt;
+
+  Clock::time_point s = Clock::now();
+  rt.submit_to(0, boost::bind(ping, 2 * round_trips));
+  while (! finished) boost::this_thread::yield();
+  Clock::duration latency = Clock::now() - s;
+
+  s = Clock::now();
+  rt.submit_to(0, send_all);
+  while (received.load(boost::memory_order_relaxed) != messages) boost::this_thread::yield();
+  Clock::duration throughput = Clock::now() - s;
+
+  std::cout << "round trip Time spent:" << latency << std::endl;
+  std::cout << "round trip Time spent/round trip:" << latency / round_trips << std::endl;
+  std::cout << "one way Time spent:" << throughput << std::endl;
+  std::cout << "one way Time spent/message:" << throughput / messages << std::endl;
+  return 0;
+}
@@ -12,61 +12,67 @@
 
 #include <iostream>
 #include <boost/thread/lock_types.hpp>
-#include <boost/thread/thread_only.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
 #include <boost/chrono/chrono_io.hpp>
 
 #include <boost/thread/shared_mutex.hpp>
+#include <boost/thread/reader_biased_shared_mutex.hpp>
 
 using namespace boost;
 
-shared_mutex mtx;
 const int cycles = 10000;
 
-void shared()
+template <class SharedMutex>
+void shared(SharedMutex& mtx)
 {
   int cycle(0);
   while (++cycle < cycles)
   {
-    shared_lock<shared_mutex> lock(mtx);
+    shared_lock<SharedMutex> lock(mtx);
   }
 }
 
-void unique()
+template <class SharedMutex>
+void unique(SharedMutex& mtx)
 {
   int cycle(0);
   while (++cycle < cycles)
   {
-    unique_lock<shared_mutex> lock(mtx);
+    unique_lock<SharedMutex> lock(mtx);
   }
 }
 
-int main()
+// runs readers shared threads and writers unique threads on the same mutex.
+template <class SharedMutex>
+void run(const char* name, int readers, int writers)
 {
   boost::chrono::high_resolution_clock::duration best_time(std::numeric_limits<boost::chrono::high_resolution_clock::duration::rep>::max BOOST_PREVENT_MACRO_SUBSTITUTION ());
   for (int i =100; i>0; --i) {
+    SharedMutex mtx;
     boost::chrono::high_resolution_clock clock;
     boost::chrono::high_resolution_clock::time_point s1 = clock.now();
-    thread t0(shared);
-    thread t1(shared);
-    thread t2(unique);
-    //thread t11(shared);
-    //thread t12(shared);
-    //thread t13(shared);
-
-    t0.join();
-    t1.join();
-    t2.join();
-    //t11.join();
-//    t12.join();
-  //  t13.join();
+    thread_group g;
+    for (int r = 0; r < readers; ++r) g.create_thread(boost::bind(shared<SharedMutex>, boost::ref(mtx)));
+    for (int w = 0; w < writers; ++w) g.create_thread(boost::bind(unique<SharedMutex>, boost::ref(mtx)));
+    g.join_all();
     boost::chrono::high_resolution_clock::time_point f1 = clock.now();
     //std::cout << "     Time spent:" << (f1 - s1) << std::endl;
     best_time = std::min BOOST_PREVENT_MACRO_SUBSTITUTION (best_time, f1 - s1);
 
   }
+  std::cout << name << " " << readers << " readers " << writers << " writers" << std::endl;
   std::cout << "Best Time spent:" << best_time << std::endl;
-  std::cout << "Time spent/cycle:" << best_time/cycles/3 << std::endl;
+  std::cout << "Time spent/cycle:" << best_time/cycles/(readers + writers) << std::endl;
+}
+
+int main()
+{
+  run<shared_mutex>("shared_mutex", 2, 1);
+  run<reader_biased_shared_mutex>("reader_biased_shared_mutex", 2, 1);
+  // read-mostly
+  run<shared_mutex>("shared_mutex", 3, 0);
+  run<reader_biased_shared_mutex>("reader_biased_shared_mutex", 3, 0);
 
   return 1;
 }
-
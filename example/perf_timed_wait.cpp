@@ -0,0 +1,74 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Measures the overhead of the timed waits of boost::condition_variable, whose deadline has already been reached:
+// the clock conversions and the wait that times out at once.
+// Build it with and without BOOST_THREAD_DONT_USE_CONDATTR_SET_CLOCK_MONOTONIC to compare the condition variables
+// waiting on CLOCK_MONOTONIC with the ones waiting on CLOCK_REALTIME.
+
+#define BOOST_THREAD_VERSION 4
+
+#include <iostream>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/chrono/chrono_io.hpp>
+
+const int cycles = 10000;
+
+typedef boost::chrono::high_resolution_clock Clock;
+
+struct wait_until_steady
+{
+  void operator()(boost::condition_variable& cv, boost::unique_lock<boost::mutex>& lk) const
+  {
+    cv.wait_until(lk, boost::chrono::steady_clock::now());
+  }
+};
+
+struct wait_until_system
+{
+  void operator()(boost::condition_variable& cv, boost::unique_lock<boost::mutex>& lk) const
+  {
+    cv.wait_until(lk, boost::chrono::system_clock::now());
+  }
+};
+
+struct wait_for
+{
+  void operator()(boost::condition_variable& cv, boost::unique_lock<boost::mutex>& lk) const
+  {
+    cv.wait_for(lk, boost::chrono::nanoseconds(0));
+  }
+};
+
+template <class Wait>
+boost::chrono::nanoseconds run()
+{
+  Clock::duration best_time((Clock::duration::max)());
+  boost::condition_variable cv;
+  boost::mutex m;
+  for (int i = 5; i > 0; --i)
+  {
+    boost::unique_lock<boost::mutex> lk(m);
+    Clock::time_point s1 = Clock::now();
+    for (int c = 0; c < cycles; ++c) Wait()(cv, lk);
+    Clock::time_point f1 = Clock::now();
+    best_time = (std::min)(best_time, f1 - s1);
+  }
+  return boost::chrono::duration_cast<boost::chrono::nanoseconds>(best_time) / cycles;
+}
+
+int main()
+{
+#if defined BOOST_THREAD_HAS_CONDATTR_SET_CLOCK_MONOTONIC
+  std::cout << "condition variables on CLOCK_MONOTONIC" << std::endl;
+#else
+  std::cout << "condition variables on CLOCK_REALTIME" << std::endl;
+#endif
+  std::cout << "wait_until(steady_clock): " << run<wait_until_steady>() << " per wait" << std::endl;
+  std::cout << "wait_until(system_clock): " << run<wait_until_system>() << " per wait" << std::endl;
+  std::cout << "wait_for:                 " << run<wait_for>() << " per wait" << std::endl;
+  return 0;
+}
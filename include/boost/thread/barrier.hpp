@@ -13,11 +13,13 @@
 #include <boost/thread/detail/delete.hpp>
 
 #include <boost/throw_exception.hpp>
+#include <boost/exception_ptr.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/lock_types.hpp>
 #include <boost/thread/condition_variable.hpp>
 #include <string>
 #include <stdexcept>
+#include <vector>
 #include <boost/thread/detail/nullary_function.hpp>
 #include <boost/type_traits/is_same.hpp>
 #include <boost/type_traits/is_void.hpp>
@@ -114,6 +116,34 @@ namespace boost
   }
   class barrier
   {
+  public:
+    /// The phase of the barrier at which a thread has arrived, to wait for its completion.
+    class arrival_token
+    {
+      friend class barrier;
+      unsigned int generation_;
+      explicit arrival_token(unsigned int generation) : generation_(generation)
+      {
+      }
+    };
+
+  private:
+    /// Submits a closure to an executor once the phase of the barrier is completed.
+    template <typename Executor, typename Closure>
+    struct submitter
+    {
+      Executor* ex_;
+      Closure closure_;
+      submitter(Executor& ex, Closure const& closure) : ex_(&ex), closure_(closure)
+      {
+      }
+      void operator()()
+      {
+        ex_->submit(closure_);
+      }
+    };
+    typedef std::vector<detail::nullary_function<void()> > continuations_type;
+
     static inline unsigned int check_counter(unsigned int count)
     {
       if (count == 0) boost::throw_exception(
@@ -128,7 +158,7 @@ namespace boost
     BOOST_THREAD_NO_COPYABLE( barrier)
 
     explicit barrier(unsigned int count) :
-      m_count(check_counter(count)), m_generation(0), fct_(BOOST_THREAD_MAKE_RV_REF(thread_detail::default_barrier_reseter(count)))
+      m_count(check_counter(count)), m_generation(0), m_dropped(0), fct_(BOOST_THREAD_MAKE_RV_REF(thread_detail::default_barrier_reseter(count)))
     {
     }
 
@@ -141,7 +171,7 @@ namespace boost
         >::type=0
     )
     : m_count(check_counter(count)),
-      m_generation(0),
+      m_generation(0), m_dropped(0),
       fct_(BOOST_THREAD_MAKE_RV_REF(thread_detail::void_functor_barrier_reseter(count,
         boost::move(funct)))
     )
@@ -156,7 +186,7 @@ namespace boost
         >::type=0
     )
     : m_count(check_counter(count)),
-      m_generation(0),
+      m_generation(0), m_dropped(0),
       fct_(BOOST_THREAD_MAKE_RV_REF(thread_detail::void_functor_barrier_reseter(count,
         funct))
     )
@@ -172,7 +202,7 @@ namespace boost
         >::type=0
     )
     : m_count(check_counter(count)),
-      m_generation(0),
+      m_generation(0), m_dropped(0),
       fct_(boost::move(funct))
     {
     }
@@ -185,13 +215,13 @@ namespace boost
         >::type=0
     )
     : m_count(check_counter(count)),
-      m_generation(0),
+      m_generation(0), m_dropped(0),
       fct_(funct)
     {
     }
 
     barrier(unsigned int count, void(*funct)()) :
-      m_count(check_counter(count)), m_generation(0),
+      m_count(check_counter(count)), m_generation(0), m_dropped(0),
       fct_(funct
           ? BOOST_THREAD_MAKE_RV_REF(thread_detail::size_completion_function(BOOST_THREAD_MAKE_RV_REF(thread_detail::void_fct_ptr_barrier_reseter(count, funct))))
           : BOOST_THREAD_MAKE_RV_REF(thread_detail::size_completion_function(BOOST_THREAD_MAKE_RV_REF(thread_detail::default_barrier_reseter(count))))
@@ -199,7 +229,7 @@ namespace boost
     {
     }
     barrier(unsigned int count, unsigned int(*funct)()) :
-      m_count(check_counter(count)), m_generation(0),
+      m_count(check_counter(count)), m_generation(0), m_dropped(0),
       fct_(funct
           ? BOOST_THREAD_MAKE_RV_REF(thread_detail::size_completion_function(funct))
           : BOOST_THREAD_MAKE_RV_REF(thread_detail::size_completion_function(BOOST_THREAD_MAKE_RV_REF(thread_detail::default_barrier_reseter(count))))
@@ -214,10 +244,7 @@ namespace boost
 
       if (--m_count == 0)
       {
-        m_generation++;
-        m_count = static_cast<unsigned int>(fct_());
-        BOOST_ASSERT(m_count != 0);
-        m_cond.notify_all();
+        complete(lock);
         return true;
       }
 
@@ -231,12 +258,98 @@ namespace boost
       wait();
     }
 
+    /// Effects: arrives at the current phase without blocking. The last thread to arrive completes the phase.
+    /// Returns: the token to wait for the completion of the phase.
+    arrival_token arrive()
+    {
+      boost::unique_lock < boost::mutex > lock(m_mutex);
+      arrival_token token(m_generation);
+      if (--m_count == 0)
+      {
+        complete(lock);
+      }
+      return token;
+    }
+
+    /// Effects: blocks until the phase of @c token is completed.
+    void wait(arrival_token const& token)
+    {
+      boost::unique_lock < boost::mutex > lock(m_mutex);
+      while (token.generation_ == m_generation)
+        m_cond.wait(lock);
+    }
+
+    /// Effects: arrives at the current phase without blocking, and removes the calling thread from the next phases.
+    void arrive_and_drop()
+    {
+      boost::unique_lock < boost::mutex > lock(m_mutex);
+      ++m_dropped;
+      if (--m_count == 0)
+      {
+        complete(lock);
+      }
+    }
+
+    /**
+     * Effects: submits @c closure to @c ex once the phase of @c token is completed, from the thread completing it,
+     * or at once if it is already completed. The calling thread doesn't block.
+     */
+    template <typename Executor, typename Closure>
+    void async_wait(Executor& ex, arrival_token const& token, Closure closure)
+    {
+      {
+        boost::unique_lock < boost::mutex > lock(m_mutex);
+        if (token.generation_ == m_generation)
+        {
+          submitter<Executor, Closure> continuation(ex, closure);
+          m_continuations.push_back(detail::nullary_function<void()>(continuation));
+          return;
+        }
+      }
+      ex.submit(closure);
+    }
+
   private:
+    /**
+     * Effects: starts the next phase, releases the threads waiting for the current one and submits its continuations.
+     * Throws: the first exception thrown by the submission of a continuation, once all of them have been submitted.
+     */
+    void complete(boost::unique_lock < boost::mutex >& lock)
+    {
+      m_generation++;
+      unsigned int const count = static_cast<unsigned int>(fct_());
+      BOOST_ASSERT(count > m_dropped || (count == m_dropped && m_dropped != 0));
+      m_count = count - m_dropped;
+      m_cond.notify_all();
+      if (! m_continuations.empty())
+      {
+        continuations_type continuations;
+        continuations.swap(m_continuations);
+        lock.unlock();
+        exception_ptr error;
+        for (std::size_t i = 0; i < continuations.size(); ++i)
+        {
+          try
+          {
+            continuations[i]();
+          }
+          catch (...)
+          {
+            if (! error) error = current_exception();
+          }
+        }
+        if (error) boost::rethrow_exception(error);
+      }
+    }
+
     mutex m_mutex;
     condition_variable m_cond;
     unsigned int m_count;
     unsigned int m_generation;
+    /// the number of threads removed from the next phases by arrive_and_drop().
+    unsigned int m_dropped;
     thread_detail::size_completion_function fct_;
+    continuations_type m_continuations;
   };
 
 } // namespace boost
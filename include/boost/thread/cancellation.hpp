@@ -0,0 +1,112 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+// (C) Copyright 2014 Vicente J. Botet Escriba
+
+#ifndef BOOST_THREAD_CANCELLATION_HPP
+#define BOOST_THREAD_CANCELLATION_HPP
+
+#include <boost/thread/detail/config.hpp>
+
+#include <boost/atomic.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <cstddef>
+
+#include <boost/config/abi_prefix.hpp>
+
+namespace boost
+{
+  namespace detail
+  {
+    struct cancellation_state
+    {
+      boost::atomic<bool> requested;
+      boost::atomic<std::size_t> shed;
+
+      cancellation_state() :
+        requested(false), shed(0)
+      {
+      }
+    };
+  }
+
+  class cancellation_source;
+
+  /// A cancellation_token is a cheap copyable handle that lets a task check whether the cancellation_source it was
+  /// obtained from has requested cancellation.
+  class cancellation_token
+  {
+    friend class cancellation_source;
+    shared_ptr<detail::cancellation_state> state_;
+
+    explicit cancellation_token(shared_ptr<detail::cancellation_state> const& st) :
+      state_(st)
+    {
+    }
+  public:
+    /// Effect: Constructs a token not associated to any source, which can never be cancelled.
+    cancellation_token() BOOST_NOEXCEPT
+    {
+    }
+
+    /// Returns: whether this token is associated to a cancellation_source.
+    bool cancellation_possible() const BOOST_NOEXCEPT
+    {
+      return state_ ? true : false;
+    }
+
+    /// Returns: whether the associated source has requested cancellation.
+    bool is_cancellation_requested() const BOOST_NOEXCEPT
+    {
+      return state_ && state_->requested.load(memory_order_acquire);
+    }
+
+    /// Effect: Records on the associated source that a task associated to this token has been skipped.
+    void notify_shed() const BOOST_NOEXCEPT
+    {
+      if (state_) state_->shed.fetch_add(1, memory_order_relaxed);
+    }
+  };
+
+  /// A cancellation_source owns the cancellation request shared by all the tokens obtained from it.
+  class cancellation_source
+  {
+    shared_ptr<detail::cancellation_state> state_;
+  public:
+    /// Effect: Constructs a source on which cancellation has not been requested.
+    cancellation_source() :
+      state_(boost::make_shared<detail::cancellation_state>())
+    {
+    }
+
+    /// Returns: a token associated to this source.
+    cancellation_token get_token() const BOOST_NOEXCEPT
+    {
+      return cancellation_token(state_);
+    }
+
+    /// Effect: Requests cancellation. The tasks associated to any token of this source that have not yet started
+    /// will not be invoked. Tasks already running are not interrupted.
+    void request_cancellation() BOOST_NOEXCEPT
+    {
+      state_->requested.store(true, memory_order_release);
+    }
+
+    /// Returns: whether cancellation has been requested.
+    bool is_cancellation_requested() const BOOST_NOEXCEPT
+    {
+      return state_->requested.load(memory_order_acquire);
+    }
+
+    /// Returns: the number of tasks that have been skipped without being invoked because of a cancellation request.
+    std::size_t shed_count() const BOOST_NOEXCEPT
+    {
+      return state_->shed.load(memory_order_relaxed);
+    }
+  };
+}
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif
@@ -13,6 +13,7 @@
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/lock_types.hpp>
 #include <boost/thread/condition_variable.hpp>
+#include <boost/atomic.hpp>
 #include <boost/chrono/duration.hpp>
 #include <boost/chrono/time_point.hpp>
 #include <boost/assert.hpp>
@@ -61,21 +62,16 @@ namespace boost
       }
     };
 
-    bool count_down(unique_lock<mutex> &lk)
+    /// Effect: Releases the waiters and calls the completion function. Called by the count down that reached zero.
+    void complete(unique_lock<mutex> &lk)
     {
-      BOOST_ASSERT(count_ > 0);
-      if (--count_ == 0)
-      {
-        waiters_.cond_.wait(lk, detail::counter_is_not_zero(waiters_));
-        leavers_.assign_and_notify_all(waiters_);
-        count_.cond_.notify_all();
-        waiters_.cond_.wait(lk, detail::counter_is_zero(waiters_));
-        leavers_.assign_and_notify_all(0);
-        lk.unlock();
-        funct_();
-        return true;
-      }
-      return false;
+      waiters_.cond_.wait(lk, detail::counter_is_not_zero(waiters_));
+      leavers_.assign_and_notify_all(waiters_);
+      count_cond_.notify_all();
+      waiters_.cond_.wait(lk, detail::counter_is_zero(waiters_));
+      leavers_.assign_and_notify_all(0);
+      lk.unlock();
+      funct_();
     }
 
   public:
@@ -112,7 +108,7 @@ namespace boost
     {
       boost::unique_lock<boost::mutex> lk(mutex_);
       around_wait aw(*this, lk);
-      count_.cond_.wait(lk, detail::counter_is_zero(count_));
+      count_cond_.wait(lk, detail::atomic_is_zero(count_));
     }
 
     /// @return true if the internal counter is already 0, false otherwise
@@ -120,7 +116,7 @@ namespace boost
     {
       boost::unique_lock<boost::mutex> lk(mutex_);
       around_wait aw(*this, lk);
-      return (count_ == 0);
+      return count_.load(memory_order_acquire) == 0;
     }
 
     /// try to wait for a specified amount of time
@@ -130,7 +126,7 @@ namespace boost
     {
       boost::unique_lock<boost::mutex> lk(mutex_);
       around_wait aw(*this, lk);
-      return count_.cond_.wait_for(lk, rel_time, detail::counter_is_zero(count_))
+      return count_cond_.wait_for(lk, rel_time, detail::atomic_is_zero(count_))
               ? cv_status::no_timeout
               : cv_status::timeout;
     }
@@ -142,7 +138,7 @@ namespace boost
     {
       boost::unique_lock<boost::mutex> lk(mutex_);
       around_wait aw(*this, lk);
-      return count_.cond_.wait_until(lk, abs_time, detail::counter_is_zero(count_))
+      return count_cond_.wait_until(lk, abs_time, detail::atomic_is_zero(count_))
           ? cv_status::no_timeout
           : cv_status::timeout;
     }
@@ -151,8 +147,13 @@ namespace boost
     /// @Requires count must be greater than 0
     void count_down()
     {
-      unique_lock<mutex> lk(mutex_);
-      count_down(lk);
+      std::size_t const count = count_.fetch_sub(1, memory_order_acq_rel);
+      BOOST_ASSERT(count > 0);
+      if (count == 1)
+      {
+        unique_lock<mutex> lk(mutex_);
+        complete(lk);
+      }
     }
     void signal()
     {
@@ -164,13 +165,17 @@ namespace boost
     /// @Requires count must be greater than 0
     void count_down_and_wait()
     {
+      // the count down and the registration as a waiter must not be interleaved with the completion.
       boost::unique_lock<boost::mutex> lk(mutex_);
-      if (count_down(lk))
+      std::size_t const count = count_.fetch_sub(1, memory_order_acq_rel);
+      BOOST_ASSERT(count > 0);
+      if (count == 1)
       {
+        complete(lk);
         return;
       }
       around_wait aw(*this, lk);
-      count_.cond_.wait(lk, detail::counter_is_zero(count_));
+      count_cond_.wait(lk, detail::atomic_is_zero(count_));
     }
     void sync()
     {
@@ -183,7 +188,7 @@ namespace boost
     {
       boost::lock_guard<boost::mutex> lk(mutex_);
       //BOOST_ASSERT(count_ == 0);
-      count_ = count;
+      count_.store(count, memory_order_release);
     }
 
     /// Resets the latch with the new completion function.
@@ -213,7 +218,9 @@ namespace boost
 
   private:
     mutex mutex_;
-    detail::counter count_;
+    /// decremented without the mutex, except by count_down_and_wait().
+    atomic<std::size_t> count_;
+    condition_variable count_cond_;
     completion_function funct_;
     detail::counter waiters_;
     detail::counter leavers_;
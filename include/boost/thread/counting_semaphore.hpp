@@ -0,0 +1,221 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_THREAD_COUNTING_SEMAPHORE_HPP
+#define BOOST_THREAD_COUNTING_SEMAPHORE_HPP
+
+#include <boost/thread/detail/config.hpp>
+#include <boost/thread/detail/delete.hpp>
+#include <boost/thread/detail/futex.hpp>
+#include <boost/thread/exceptions.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/atomic.hpp>
+#include <boost/assert.hpp>
+#if defined BOOST_THREAD_HAS_FUTEX
+#include <boost/thread/pthread/timespec.hpp>
+#else
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/lock_guard.hpp>
+#include <boost/thread/lock_types.hpp>
+#include <boost/thread/condition_variable.hpp>
+#endif
+#ifdef BOOST_THREAD_USES_CHRONO
+#include <boost/chrono/system_clocks.hpp>
+#include <boost/chrono/ceil.hpp>
+#endif
+#include <climits>
+
+#include <boost/config/abi_prefix.hpp>
+
+namespace boost
+{
+  /**
+   * A semaphore holding a count of permits: @c acquire() takes one, blocking while there is none, @c release() gives
+   * some back.
+   *
+   * The count is an atomic: acquiring an available permit is a compare and swap, and releasing one is an atomic
+   * addition that only makes a system call when threads are blocked. The blocked threads wait on the count itself,
+   * through a futex on Linux, through a condition variable otherwise.
+   *
+   * The waits are not interruption points.
+   */
+  class counting_semaphore
+  {
+    atomic<int> count_;
+    atomic<int> waiters_;
+#if ! defined BOOST_THREAD_HAS_FUTEX
+    mutex mutex_;
+    condition_variable cond_;
+#endif
+
+    static inline int check_count(int count)
+    {
+      if (count < 0) boost::throw_exception(
+          thread_exception(system::errc::invalid_argument, "counting_semaphore constructor: count cannot be negative."));
+      return count;
+    }
+
+#if defined BOOST_THREAD_HAS_FUTEX
+    /// an absolute time of @c CLOCK_MONOTONIC.
+    typedef struct timespec deadline_type;
+
+    static bool expired(deadline_type const& abs_time)
+    {
+      return boost::detail::timespec_ge(boost::detail::timespec_now_monotonic(), abs_time);
+    }
+
+    /// Effects: blocks while there is no permit, until @c abs_time if not null, or a spurious wake-up.
+    void wait_for_permit(deadline_type const* abs_time)
+    {
+      if (abs_time)
+        detail::futex_wait_until(count_, 0, *abs_time, false);
+      else
+        detail::futex_wait(count_, 0);
+    }
+
+    void wake(int n)
+    {
+      detail::futex_wake(count_, n);
+    }
+#else
+    typedef chrono::steady_clock::time_point deadline_type;
+
+    static bool expired(deadline_type const& abs_time)
+    {
+      return chrono::steady_clock::now() >= abs_time;
+    }
+
+    void wait_for_permit(deadline_type const* abs_time)
+    {
+      unique_lock<mutex> lk(mutex_);
+      if (count_.load(memory_order_seq_cst) > 0) return;
+      if (abs_time)
+        cond_.wait_until(lk, *abs_time);
+      else
+        cond_.wait(lk);
+    }
+
+    void wake(int n)
+    {
+      {
+        // a waiter has either seen the permits or is blocked on the condition.
+        lock_guard<mutex> lk(mutex_);
+      }
+      if (n == 1)
+        cond_.notify_one();
+      else
+        cond_.notify_all();
+    }
+#endif
+
+    bool try_acquire_seq_cst()
+    {
+      int c = count_.load(memory_order_seq_cst);
+      while (c > 0)
+      {
+        if (count_.compare_exchange_weak(c, c - 1, memory_order_seq_cst)) return true;
+      }
+      return false;
+    }
+
+    /// Returns: whether a permit has been taken before @c abs_time if not null.
+    bool do_acquire(deadline_type const* abs_time)
+    {
+      if (try_acquire()) return true;
+      // a releaser either sees the waiter, or adds the permits before the waiter reads the count.
+      waiters_.fetch_add(1, memory_order_seq_cst);
+      bool acquired = false;
+      while (!(acquired = try_acquire_seq_cst()) && !(abs_time && expired(*abs_time)))
+      {
+        wait_for_permit(abs_time);
+      }
+      waiters_.fetch_sub(1, memory_order_relaxed);
+      return acquired;
+    }
+
+  public:
+    BOOST_THREAD_NO_COPYABLE(counting_semaphore)
+
+    /// Effects: constructs a semaphore holding @c count permits.
+    /// Throws: thread_exception if @c count is negative.
+    explicit counting_semaphore(int count) :
+      count_(check_count(count)), waiters_(0)
+    {
+    }
+
+    /// Returns: the maximum number of permits.
+    static int (max)() BOOST_NOEXCEPT
+    {
+      return INT_MAX;
+    }
+
+    /// Effects: adds @c update permits, waking as many blocked threads.
+    void release(int update = 1)
+    {
+      BOOST_ASSERT(update >= 0);
+      if (update == 0) return;
+      count_.fetch_add(update, memory_order_seq_cst);
+      if (waiters_.load(memory_order_seq_cst) != 0)
+      {
+        wake(update);
+      }
+    }
+
+    /// Effects: takes a permit if there is one, without blocking.
+    /// Returns: whether a permit has been taken.
+    bool try_acquire()
+    {
+      int c = count_.load(memory_order_relaxed);
+      while (c > 0)
+      {
+        if (count_.compare_exchange_weak(c, c - 1, memory_order_acquire, memory_order_relaxed)) return true;
+      }
+      return false;
+    }
+
+    /// Effects: takes a permit, blocking while there is none.
+    void acquire()
+    {
+      do_acquire(0);
+    }
+
+#ifdef BOOST_THREAD_USES_CHRONO
+    /// Effects: takes a permit, blocking while there is none until @c t.
+    /// Returns: whether a permit has been taken.
+    template <class Duration>
+    bool try_acquire_until(chrono::time_point<chrono::steady_clock, Duration> const& t)
+    {
+      using namespace chrono;
+#if defined BOOST_THREAD_HAS_FUTEX
+      // the steady_clock is CLOCK_MONOTONIC.
+      struct timespec const ts = boost::detail::to_timespec(ceil<nanoseconds>(t.time_since_epoch()));
+      return do_acquire(&ts);
+#else
+      steady_clock::time_point const tp = time_point_cast<steady_clock::duration>(t);
+      return do_acquire(&tp);
+#endif
+    }
+
+    template <class Clock, class Duration>
+    bool try_acquire_until(chrono::time_point<Clock, Duration> const& t)
+    {
+      using namespace chrono;
+      steady_clock::time_point     s_now = steady_clock::now();
+      typename Clock::time_point  c_now = Clock::now();
+      return try_acquire_until(s_now + ceil<nanoseconds>(t - c_now));
+    }
+
+    template <class Rep, class Period>
+    bool try_acquire_for(chrono::duration<Rep, Period> const& d)
+    {
+      return try_acquire_until(chrono::steady_clock::now() + d);
+    }
+#endif
+  };
+}
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif
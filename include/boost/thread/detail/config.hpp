@@ -258,6 +258,18 @@
 #endif
 #endif
 
+// FUTURE_COROUTINES
+#if ! defined BOOST_THREAD_PROVIDES_FUTURE_COROUTINES \
+ && ! defined BOOST_THREAD_DONT_PROVIDE_FUTURE_COROUTINES
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L && \
+    defined(__has_include)
+#if __has_include(<coroutine>)
+#define BOOST_THREAD_PROVIDES_FUTURE_COROUTINES
+#endif
+#endif
+#endif
+
 //    ! defined(BOOST_NO_SFINAE_EXPR) &&
 //    ! defined(BOOST_NO_CXX11_RVALUE_REFERENCES) &&
 //    ! defined(BOOST_NO_CXX11_AUTO) &&
@@ -311,6 +323,14 @@
 #define BOOST_THREAD_PROVIDES_INTERRUPTIONS
 #endif
 
+// CONDATTR_SET_CLOCK_MONOTONIC
+// The condition variables wait on CLOCK_MONOTONIC where pthread_condattr_setclock() supports it,
+// if not stated the opposite defining BOOST_THREAD_DONT_USE_CONDATTR_SET_CLOCK_MONOTONIC
+#if defined BOOST_THREAD_LINUX \
+ && ! defined BOOST_THREAD_DONT_USE_CONDATTR_SET_CLOCK_MONOTONIC
+#define BOOST_THREAD_HAS_CONDATTR_SET_CLOCK_MONOTONIC
+#endif
+
 // CORRELATIONS
 
 // EXPLICIT_LOCK_CONVERSION.
@@ -12,6 +12,7 @@
 //#include <boost/thread/mutex.hpp>
 //#include <boost/thread/lock_types.hpp>
 #include <boost/thread/condition_variable.hpp>
+#include <boost/atomic.hpp>
 #include <boost/chrono/duration.hpp>
 #include <boost/chrono/time_point.hpp>
 #include <boost/assert.hpp>
@@ -85,6 +86,12 @@ namespace boost
       bool operator()() const { return count_ == 0; }
       counter const& count_;
     };
+    struct atomic_is_zero
+    {
+      atomic_is_zero(atomic<std::size_t> const& count) : count_(count) {}
+      bool operator()() const { return count_.load(memory_order_acquire) == 0; }
+      atomic<std::size_t> const& count_;
+    };
     struct is_zero
     {
       is_zero(std::size_t& count) : count_(count) {}
@@ -0,0 +1,190 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_THREAD_DETAIL_FUTEX_HPP
+#define BOOST_THREAD_DETAIL_FUTEX_HPP
+
+#include <boost/thread/detail/config.hpp>
+#include <boost/atomic.hpp>
+#include <boost/static_assert.hpp>
+
+#if defined BOOST_THREAD_LINUX
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <climits>
+#if defined FUTEX_WAIT_BITSET && defined FUTEX_PRIVATE_FLAG && defined SYS_futex
+#define BOOST_THREAD_HAS_FUTEX
+#endif
+#endif
+
+#include <boost/config/abi_prefix.hpp>
+
+namespace boost
+{
+  namespace detail
+  {
+    /// Effects: hints the processor that the calling thread is spinning.
+    inline void cpu_relax()
+    {
+#if (defined __GNUC__ || defined __clang__) && (defined __i386__ || defined __x86_64__)
+      __builtin_ia32_pause();
+#elif defined __GNUC__ && defined __aarch64__
+      __asm__ __volatile__("yield");
+#endif
+    }
+
+#if defined BOOST_THREAD_HAS_FUTEX
+    /// The futexes of the library are private to the process and their waits are bound to a clock.
+    inline int* futex_word(atomic<int>& word)
+    {
+      BOOST_STATIC_ASSERT(sizeof(atomic<int>) == sizeof(int));
+      return reinterpret_cast<int*>(&word);
+    }
+
+    /**
+     * Effects: blocks the calling thread while @c word is equal to @c expected, until woken by @c futex_wake(), a
+     * signal or a spurious wake-up.
+     * Returns: 0 if woken, an errno value otherwise (EAGAIN when @c word is not equal to @c expected).
+     */
+    inline int futex_wait(atomic<int>& word, int expected)
+    {
+      if (::syscall(SYS_futex, futex_word(word), FUTEX_WAIT_PRIVATE, expected, 0, 0, 0) == 0) return 0;
+      return errno;
+    }
+
+    /**
+     * Effects: as @c futex_wait(), until the absolute time @c abs_time of @c CLOCK_REALTIME if @c realtime is true,
+     * of @c CLOCK_MONOTONIC otherwise.
+     * Returns: 0 if woken, an errno value otherwise (ETIMEDOUT once @c abs_time is reached).
+     */
+    inline int futex_wait_until(atomic<int>& word, int expected, struct timespec const& abs_time, bool realtime)
+    {
+      // a time before the epoch of the clock, e.g. converted from a time point of another clock, is rejected by the
+      // kernel with EINVAL: it has been reached.
+      if (abs_time.tv_sec < 0 || abs_time.tv_nsec < 0) return ETIMEDOUT;
+      int op = FUTEX_WAIT_BITSET_PRIVATE;
+#if defined FUTEX_CLOCK_REALTIME
+      if (realtime) op |= FUTEX_CLOCK_REALTIME;
+#endif
+      if (::syscall(SYS_futex, futex_word(word), op, expected, &abs_time, 0, FUTEX_BITSET_MATCH_ANY) == 0) return 0;
+      return errno;
+    }
+
+    /// Effects: wakes up to @c count threads blocked on @c word.
+    /// Returns: the number of woken threads.
+    inline int futex_wake(atomic<int>& word, int count)
+    {
+      long const r = ::syscall(SYS_futex, futex_word(word), FUTEX_WAKE_PRIVATE, count, 0, 0, 0);
+      return r < 0 ? 0 : static_cast<int>(r);
+    }
+
+    /**
+     * Effects: if @c word is still equal to @c expected, wakes up to @c wake_count threads blocked on @c word and moves
+     * up to @c requeue_count of the other ones to the threads blocked on @c target, without waking them.
+     * Returns: the number of woken and moved threads, or -1 if @c word is no longer equal to @c expected.
+     */
+    inline int futex_cmp_requeue(atomic<int>& word, int expected, int wake_count, atomic<int>& target, int requeue_count)
+    {
+      long const r = ::syscall(SYS_futex, futex_word(word), FUTEX_CMP_REQUEUE_PRIVATE, wake_count,
+          static_cast<long>(requeue_count), futex_word(target), expected);
+      return r < 0 ? -1 : static_cast<int>(r);
+    }
+
+    /**
+     * The state of a futex based condition variable: a sequence number, incremented by each notification, on which the
+     * waiters block, and the number of waiters, so that the notifications only make a system call when there are some.
+     *
+     * A waiter registers itself and reads the sequence while holding the mutex of the condition, then blocks while the
+     * sequence has not changed: a notifier either sees the waiter, or changes the sequence after the waiter has read it.
+     */
+    class futex_sequence
+    {
+      atomic<int> seq_;
+      atomic<int> waiters_;
+
+      futex_sequence(futex_sequence const&);
+      futex_sequence& operator=(futex_sequence const&);
+    public:
+      futex_sequence() : seq_(0), waiters_(0)
+      {
+      }
+
+      /// Registers a waiter for its lifetime, also when the wait is interrupted before it starts.
+      class waiter
+      {
+        futex_sequence& seq_;
+      public:
+        /// the sequence read by the waiter.
+        int const value;
+
+        explicit waiter(futex_sequence& seq) : seq_(seq), value(seq.enter())
+        {
+        }
+        ~waiter()
+        {
+          seq_.waiters_.fetch_sub(1, memory_order_relaxed);
+        }
+      };
+
+      int enter()
+      {
+        waiters_.fetch_add(1, memory_order_seq_cst);
+        return seq_.load(memory_order_seq_cst);
+      }
+
+      /// Effects: as @c futex_wait() on the sequence.
+      int wait(waiter const& w)
+      {
+        return futex_wait(seq_, w.value);
+      }
+      /// Effects: as @c futex_wait_until() on the sequence.
+      int wait_until(waiter const& w, struct timespec const& abs_time, bool realtime)
+      {
+        return futex_wait_until(seq_, w.value, abs_time, realtime);
+      }
+
+      /// Effects: changes the sequence.
+      /// Returns: the new sequence, with which a notifier moving the waiters elsewhere compares the futex.
+      int advance()
+      {
+        return seq_.fetch_add(1, memory_order_seq_cst) + 1;
+      }
+      bool has_waiters() const
+      {
+        return waiters_.load(memory_order_seq_cst) != 0;
+      }
+      atomic<int>& word()
+      {
+        return seq_;
+      }
+
+      void notify_one()
+      {
+        advance();
+        if (has_waiters()) futex_wake(seq_, 1);
+      }
+      void notify_all()
+      {
+        advance();
+        if (has_waiters()) futex_wake(seq_, INT_MAX);
+      }
+    };
+
+    /// Returns: whether it makes sense to spin, i.e. whether the machine has more than one online CPU.
+    inline bool futex_spinning_enabled()
+    {
+      static const bool enabled = ::sysconf(_SC_NPROCESSORS_ONLN) > 1;
+      return enabled;
+    }
+#endif
+  }
+}
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif
@@ -26,6 +26,8 @@ namespace boost
     template <>
     class nullary_function<void()>
     {
+    public:
+      /// Base of the closures that are stored without being wrapped, as a future shared state that is its own task.
       struct impl_base
       {
         virtual void call()=0;
@@ -33,6 +35,7 @@ namespace boost
         {
         }
       };
+    private:
       shared_ptr<impl_base> impl;
       template <typename F>
       struct impl_type: impl_base
@@ -70,6 +73,12 @@ namespace boost
       impl(new impl_type_ptr(f))
       {}
 
+      // Shares the ownership of the closure instead of copying it. The argument must be a const lvalue, otherwise
+      // the generic constructor would wrap the shared_ptr.
+      explicit nullary_function(shared_ptr<impl_base> const& task) BOOST_NOEXCEPT:
+      impl(task)
+      {}
+
 #ifdef BOOST_NO_CXX11_RVALUE_REFERENCES
       template<typename F>
       explicit nullary_function(F& f):
@@ -0,0 +1,81 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_THREAD_DETAIL_NUMA_HPP
+#define BOOST_THREAD_DETAIL_NUMA_HPP
+
+#include <boost/thread/detail/config.hpp>
+#include <vector>
+
+#if defined BOOST_THREAD_LINUX
+#include <sched.h>
+#endif
+
+#include <boost/config/abi_prefix.hpp>
+
+namespace boost
+{
+  namespace detail
+  {
+#if defined BOOST_THREAD_LINUX
+    /// Effects: stores in @c nodes the online NUMA nodes, as listed in /sys/devices/system/node/online.
+    /// Returns: whether the nodes could be read.
+    BOOST_THREAD_DECL bool get_numa_nodes(std::vector<unsigned>& nodes);
+    /// Effects: stores in @c cpus the CPUs of NUMA node @c node.
+    /// Returns: whether the CPUs could be read.
+    BOOST_THREAD_DECL bool get_numa_node_cpu_list(unsigned node, std::vector<unsigned>& cpus);
+
+    /// Effects: stores in @c cpus the CPUs the calling thread is allowed to run on, see @c sched_getaffinity().
+    /// Returns: whether the CPUs could be read.
+    inline bool get_allowed_cpu_list(std::vector<unsigned>& cpus)
+    {
+#if defined CPU_ISSET
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      if (sched_getaffinity(0, sizeof(set), &set) != 0) return false;
+      cpus.clear();
+      for (unsigned id = 0; id < CPU_SETSIZE; ++id)
+      {
+        if (CPU_ISSET(id, &set)) cpus.push_back(id);
+      }
+      return ! cpus.empty();
+#else
+      return false;
+#endif
+    }
+
+    /// Returns: the CPU the calling thread is running on, or -1 if unknown.
+    inline int get_current_cpu()
+    {
+#if defined __GLIBC__
+      return sched_getcpu();
+#else
+      return -1;
+#endif
+    }
+#else
+    inline bool get_numa_nodes(std::vector<unsigned>&)
+    {
+      return false;
+    }
+    inline bool get_numa_node_cpu_list(unsigned, std::vector<unsigned>&)
+    {
+      return false;
+    }
+    inline bool get_allowed_cpu_list(std::vector<unsigned>&)
+    {
+      return false;
+    }
+    inline int get_current_cpu()
+    {
+      return -1;
+    }
+#endif
+  }
+}
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif
@@ -0,0 +1,139 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_THREAD_DETAIL_SPSC_QUEUE_HPP
+#define BOOST_THREAD_DETAIL_SPSC_QUEUE_HPP
+
+#include <boost/thread/detail/config.hpp>
+#include <boost/thread/detail/delete.hpp>
+#include <boost/thread/detail/move.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/atomic.hpp>
+#include <cstddef>
+
+#include <boost/config/abi_prefix.hpp>
+
+namespace boost
+{
+namespace detail
+{
+  /**
+   * A bounded wait-free queue with a single producer thread and a single consumer thread.
+   *
+   * The producer and the consumer keep a cached copy of the other side index, so that they only read the cache line
+   * written by the other thread when the queue looks full or empty. The batch operations publish all the values
+   * they transfer with a single store.
+   */
+  template <typename ValueType>
+  class spsc_queue
+  {
+    static std::size_t round_up(std::size_t n)
+    {
+      std::size_t r = 2;
+      while (r < n) r <<= 1;
+      return r;
+    }
+
+    scoped_array<ValueType> data_;
+    std::size_t const mask_;
+    char pad0_[64];
+    /// the next slot to pop, written by the consumer.
+    atomic<std::size_t> head_;
+    std::size_t cached_tail_;
+    char pad1_[64];
+    /// the next slot to push, written by the producer.
+    atomic<std::size_t> tail_;
+    std::size_t cached_head_;
+    char pad2_[64];
+
+  public:
+    BOOST_THREAD_NO_COPYABLE(spsc_queue)
+
+    /// Effects: creates an empty queue able to store at least @c capacity values.
+    explicit spsc_queue(std::size_t capacity) :
+      data_(new ValueType[round_up(capacity)]), mask_(round_up(capacity) - 1),
+      head_(0), cached_tail_(0), tail_(0), cached_head_(0)
+    {
+    }
+
+    std::size_t capacity() const BOOST_NOEXCEPT
+    {
+      return mask_ + 1;
+    }
+
+    /**
+     * Requires: Called by the producer thread.
+     * Effects: moves at most @c n values starting at @c first to the queue, in order.
+     * Returns: the number of values moved, which is less than @c n when the queue becomes full.
+     */
+    std::size_t push_some(ValueType* first, std::size_t n)
+    {
+      std::size_t t = tail_.load(memory_order_relaxed);
+      std::size_t room = capacity() - (t - cached_head_);
+      if (room < n)
+      {
+        cached_head_ = head_.load(memory_order_acquire);
+        room = capacity() - (t - cached_head_);
+        if (room < n) n = room;
+      }
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        data_[(t + i) & mask_] = boost::move(first[i]);
+      }
+      if (n != 0) tail_.store(t + n, memory_order_release);
+      return n;
+    }
+
+    /**
+     * Requires: Called by the producer thread.
+     * Returns: whether @c x has been moved to the queue, which is not the case if it is full.
+     */
+    bool try_push(ValueType& x)
+    {
+      return push_some(&x, 1) == 1;
+    }
+
+    /**
+     * Requires: Called by the consumer thread. @c out is able to store @c n values.
+     * Effects: moves at most @c n values from the queue to @c out, in order.
+     * Returns: the number of values moved.
+     */
+    std::size_t pop_some(ValueType* out, std::size_t n)
+    {
+      std::size_t h = head_.load(memory_order_relaxed);
+      if (cached_tail_ - h < n)
+      {
+        cached_tail_ = tail_.load(memory_order_acquire);
+        if (cached_tail_ - h < n) n = cached_tail_ - h;
+      }
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        out[i] = boost::move(data_[(h + i) & mask_]);
+      }
+      if (n != 0) head_.store(h + n, memory_order_release);
+      return n;
+    }
+
+    /**
+     * Requires: Called by the consumer thread.
+     * Returns: whether a value has been moved from the queue to @c x, which is not the case if it is empty.
+     */
+    bool try_pop(ValueType& x)
+    {
+      return pop_some(&x, 1) == 1;
+    }
+
+    /// Returns: whether the queue was empty at some point during the call.
+    bool empty() const
+    {
+      return head_.load(memory_order_acquire) == tail_.load(memory_order_acquire);
+    }
+  };
+}
+}
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif
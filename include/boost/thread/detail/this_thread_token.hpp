@@ -0,0 +1,44 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_THREAD_DETAIL_THIS_THREAD_TOKEN_HPP
+#define BOOST_THREAD_DETAIL_THIS_THREAD_TOKEN_HPP
+
+#include <boost/thread/detail/config.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <cstring>
+
+#if defined BOOST_THREAD_PLATFORM_PTHREAD
+#include <pthread.h>
+#elif defined BOOST_THREAD_PLATFORM_WIN32
+#include <boost/thread/win32/thread_primitives.hpp>
+#endif
+
+#include <boost/config/abi_prefix.hpp>
+
+namespace boost
+{
+  namespace detail
+  {
+    /// Returns: a non null integer identifying the calling thread among the running threads.
+    inline boost::uintmax_t this_thread_token()
+    {
+#if defined BOOST_THREAD_PLATFORM_PTHREAD
+      BOOST_STATIC_ASSERT(sizeof(pthread_t) <= sizeof(boost::uintmax_t));
+      pthread_t const self = pthread_self();
+      boost::uintmax_t token = 0;
+      std::memcpy(&token, &self, sizeof(self));
+      return token;
+#else
+      return static_cast<boost::uintmax_t>(win32::GetCurrentThreadId()) + 1;
+#endif
+    }
+  }
+}
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif
@@ -381,6 +381,23 @@ namespace boost
         {
           start_thread(attrs);
         }
+        // a non-const attributes would otherwise be taken as the function to run by the constructor above.
+        template <class F>
+        thread(attributes& attrs, F&& f) :
+          thread_info(make_thread_info(thread_detail::decay_copy(boost::forward<F>(f))))
+        {
+          start_thread(attrs);
+        }
+        template <class F, class Arg, class ...Args>
+        thread(attributes& attrs, F&& f, Arg&& arg, Args&&... args) :
+          thread_info(make_thread_info(
+              thread_detail::decay_copy(boost::forward<F>(f)),
+              thread_detail::decay_copy(boost::forward<Arg>(arg)),
+              thread_detail::decay_copy(boost::forward<Args>(args))...)
+          )
+        {
+          start_thread(attrs);
+        }
 #else
         template <class F,class A1>
         thread(F f,A1 a1,typename disable_if<boost::thread_detail::is_convertible<F&,thread_attributes >, dummy* >::type=0):
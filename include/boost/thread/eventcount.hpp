@@ -0,0 +1,138 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_THREAD_EVENTCOUNT_HPP
+#define BOOST_THREAD_EVENTCOUNT_HPP
+
+#include <boost/thread/detail/config.hpp>
+#include <boost/thread/detail/delete.hpp>
+#include <boost/thread/detail/futex.hpp>
+#include <boost/atomic.hpp>
+#if ! defined BOOST_THREAD_HAS_FUTEX
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/lock_guard.hpp>
+#include <boost/thread/lock_types.hpp>
+#include <boost/thread/condition_variable.hpp>
+#endif
+#include <climits>
+
+#include <boost/config/abi_prefix.hpp>
+
+namespace boost
+{
+  /**
+   * An event count, to block on a condition of a lock-free data structure without a mutex.
+   *
+   * A consumer that finds nothing to do takes a key with @c prepare_wait(), checks its condition again, and then either
+   * calls @c cancel_wait() if the condition has become true, or @c commit_wait(key), which blocks until a notification
+   * posterior to @c prepare_wait(). A producer changes the data structure and then calls @c notify_one() or
+   * @c notify_all(), which are a fence and a load when nobody waits.
+   *
+   *   while (!queue.try_pull(item))
+   *   {
+   *     eventcount::key_type key = ec.prepare_wait();
+   *     if (queue.try_pull(item)) { ec.cancel_wait(); break; }
+   *     ec.commit_wait(key);
+   *   }
+   *
+   * The waiters block on the epoch of the notifications, through a futex on Linux, through a condition variable
+   * otherwise. The waits are not interruption points.
+   */
+  class eventcount
+  {
+  public:
+    typedef int key_type;
+
+  private:
+    /// incremented by the notifications that find waiters.
+    atomic<int> epoch_;
+    /// the number of threads between prepare_wait() and the end of the wait.
+    atomic<int> waiters_;
+#if ! defined BOOST_THREAD_HAS_FUTEX
+    mutex mutex_;
+    condition_variable cond_;
+#endif
+
+    void notify(int n)
+    {
+      // orders the change of the condition by the notifier before its read of the waiters.
+      atomic_thread_fence(memory_order_seq_cst);
+      if (waiters_.load(memory_order_relaxed) == 0) return;
+#if defined BOOST_THREAD_HAS_FUTEX
+      epoch_.fetch_add(1, memory_order_seq_cst);
+      detail::futex_wake(epoch_, n);
+#else
+      {
+        lock_guard<mutex> lk(mutex_);
+        epoch_.fetch_add(1, memory_order_seq_cst);
+      }
+      if (n == 1)
+        cond_.notify_one();
+      else
+        cond_.notify_all();
+#endif
+    }
+
+  public:
+    BOOST_THREAD_NO_COPYABLE(eventcount)
+
+    eventcount() :
+      epoch_(0), waiters_(0)
+    {
+    }
+
+    /// Effects: registers the calling thread as a waiter. The caller must check its condition again before waiting.
+    /// Returns: the key to give to @c commit_wait().
+    key_type prepare_wait()
+    {
+      waiters_.fetch_add(1, memory_order_seq_cst);
+      // orders the registration before the read of the condition by the caller.
+      atomic_thread_fence(memory_order_seq_cst);
+      return epoch_.load(memory_order_acquire);
+    }
+
+    /// Effects: unregisters the calling thread, whose condition has become true after @c prepare_wait().
+    void cancel_wait()
+    {
+      waiters_.fetch_sub(1, memory_order_relaxed);
+    }
+
+    /// Effects: blocks until a notification posterior to the @c prepare_wait() which returned @c key, and unregisters
+    /// the calling thread.
+    void commit_wait(key_type key)
+    {
+#if defined BOOST_THREAD_HAS_FUTEX
+      while (epoch_.load(memory_order_acquire) == key)
+      {
+        detail::futex_wait(epoch_, key);
+      }
+#else
+      {
+        unique_lock<mutex> lk(mutex_);
+        while (epoch_.load(memory_order_acquire) == key)
+          cond_.wait(lk);
+      }
+#endif
+      waiters_.fetch_sub(1, memory_order_relaxed);
+    }
+
+    /// Effects: wakes one of the threads blocked in @c commit_wait(). The other waiters that have not blocked yet return
+    /// from @c commit_wait() as well.
+    void notify_one()
+    {
+      notify(1);
+    }
+
+    /// Effects: wakes all the threads waiting.
+    void notify_all()
+    {
+      notify(INT_MAX);
+    }
+  };
+}
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif
@@ -15,8 +15,18 @@
 #include <boost/thread/detail/move.hpp>
 #include <boost/thread/scoped_thread.hpp>
 #include <boost/thread/sync_queue.hpp>
+#include <boost/thread/topology.hpp>
 #include <boost/thread/executors/work.hpp>
+#include <boost/thread/executors/current_executor.hpp>
+#include <boost/thread/executors/worker_attributes.hpp>
 #include <boost/thread/csbl/vector.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/lock_guard.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <boost/type_traits/decay.hpp>
 
 #include <boost/config/abi_prefix.hpp>
 
@@ -35,11 +45,134 @@ namespace executors
     typedef scoped_thread<> thread_t;
     typedef csbl::vector<thread_t> thread_vector;
 
+    /// The number of closures a worker can run in a row from its next slot before looking at the queue.
+    static const unsigned next_slot_budget = 32;
+
+    /// The LIFO slot of a worker thread: the last closure submitted from the worker, which it runs next so that
+    /// the data shared with the submitter is still in its caches. The other workers steal it when they are idle.
+    struct worker_slot
+    {
+      mutex mtx;
+      work task;
+      atomic<bool> full;
+      /// only used by the owner worker.
+      unsigned budget;
+      /// the number of closures the owner worker is running, nested when one of them waits for a future.
+      unsigned depth;
+
+      worker_slot() : full(false), budget(next_slot_budget), depth(0) {}
+    };
+
+    /// Counts the closures a worker is running.
+    struct nested_run
+    {
+      worker_slot* slot;
+      explicit nested_run(worker_slot* s) : slot(s)
+      {
+        if (slot != 0) ++slot->depth;
+      }
+      ~nested_run()
+      {
+        if (slot != 0) --slot->depth;
+      }
+    };
+
     /// the thread safe work queue
     sync_queue<work > work_queue;
+    /// the slots of the worker threads, that must outlive them.
+    scoped_array<worker_slot> slots;
+    unsigned slot_count;
+    atomic<unsigned> registered_workers;
     /// A move aware vector
     thread_vector threads;
 
+    /// Returns the slot of the current thread, if it is a worker of this pool.
+    worker_slot* current_slot()
+    {
+      detail::current_executor_entry* const current = detail::get_current_executor();
+      if (current == 0 || current->executor != this) return 0;
+      return static_cast<worker_slot*>(current->worker);
+    }
+
+    worker_slot* register_worker()
+    {
+      return &slots[registered_workers.fetch_add(1, memory_order_relaxed)];
+    }
+
+    static bool take_slot(worker_slot& slot, work& task)
+    {
+      if (! slot.full.load(memory_order_acquire)) return false;
+      lock_guard<mutex> lk(slot.mtx);
+      if (! slot.full.load(memory_order_relaxed)) return false;
+      task = boost::move(slot.task);
+      slot.full.store(false, memory_order_relaxed);
+      return true;
+    }
+
+    /**
+     * A closure submitted from a worker goes to its slot and the closure it displaces, if any, to the queue.
+     */
+    void submit_work(work& w)
+    {
+      worker_slot* const slot = current_slot();
+      if (slot == 0 || closed())
+      {
+        work_queue.push_back(boost::move(w));
+        return;
+      }
+      work displaced;
+      bool has_displaced = false;
+      {
+        lock_guard<mutex> lk(slot->mtx);
+        if (slot->full.load(memory_order_relaxed))
+        {
+          displaced = boost::move(slot->task);
+          has_displaced = true;
+        }
+        slot->task = boost::move(w);
+        slot->full.store(true, memory_order_release);
+      }
+      if (has_displaced)
+      {
+        work_queue.push_back(boost::move(displaced));
+      }
+    }
+
+    /**
+     * A worker runs its own slot first, within its budget, then the queue, and when the queue is empty its own slot
+     * or the slot of another worker. A worker waiting for a future from one of its closures takes its own slot
+     * regardless of the budget: it holds the last closure the waiting one has submitted, likely the one it waits for.
+     */
+    bool pull_work(worker_slot* slot, work& task)
+    {
+      if (slot != 0 && slot->depth > 0 && take_slot(*slot, task))
+      {
+        return true;
+      }
+      if (slot != 0 && slot->budget > 0 && take_slot(*slot, task))
+      {
+        --slot->budget;
+        return true;
+      }
+      if (slot != 0)
+      {
+        slot->budget = next_slot_budget;
+      }
+      if (work_queue.try_pull_front(task) == queue_op_status::success)
+      {
+        return true;
+      }
+      unsigned const first = slot != 0 ? static_cast<unsigned>(slot - slots.get()) : 0;
+      for (unsigned i = 0; i < slot_count; ++i)
+      {
+        if (take_slot(slots[(first + i) % slot_count], task))
+        {
+          return true;
+        }
+      }
+      return false;
+    }
+
   public:
     /**
      * Effects: try to execute one task.
@@ -51,8 +184,10 @@ namespace executors
       work task;
       try
       {
-        if (work_queue.try_pull_front(task) == queue_op_status::success)
+        worker_slot* const slot = current_slot();
+        if (pull_work(slot, task))
         {
+          nested_run run(slot);
           task();
           return true;
         }
@@ -85,6 +220,7 @@ namespace executors
      */
     void worker_thread()
     {
+      current_executor_guard<basic_thread_pool> guard(*this, register_worker());
       while (!closed())
       {
         schedule_one_or_yield();
@@ -97,6 +233,7 @@ namespace executors
     template <class AtThreadEntry>
     void worker_thread1(AtThreadEntry& at_thread_entry)
     {
+      current_executor_guard<basic_thread_pool> guard(*this, register_worker());
       at_thread_entry(*this);
       while (!closed())
       {
@@ -109,6 +246,7 @@ namespace executors
 #endif
     void worker_thread2(void(*at_thread_entry)(basic_thread_pool&))
     {
+      current_executor_guard<basic_thread_pool> guard(*this, register_worker());
       at_thread_entry(*this);
       while (!closed())
       {
@@ -121,6 +259,7 @@ namespace executors
     template <class AtThreadEntry>
     void worker_thread3(BOOST_THREAD_FWD_REF(AtThreadEntry) at_thread_entry)
     {
+      current_executor_guard<basic_thread_pool> guard(*this, register_worker());
       at_thread_entry(*this);
       while (!closed())
       {
@@ -137,11 +276,13 @@ namespace executors
     BOOST_THREAD_NO_COPYABLE(basic_thread_pool)
 
     /**
-     * \b Effects: creates a thread pool that runs closures on \c thread_count threads.
+     * \b Effects: creates a thread pool that runs closures on \c thread_count threads, by default as many as the
+     * process can run in parallel, see \c this_system::effective_concurrency().
      *
      * \b Throws: Whatever exception is thrown while initializing the needed resources.
      */
-    basic_thread_pool(unsigned const thread_count = thread::hardware_concurrency())
+    basic_thread_pool(unsigned const thread_count = this_system::effective_concurrency())
+    : slots(new worker_slot[thread_count]), slot_count(thread_count), registered_workers(0)
     {
       try
       {
@@ -170,7 +311,9 @@ namespace executors
      */
 #if defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
     template <class AtThreadEntry>
-    basic_thread_pool( unsigned const thread_count, AtThreadEntry& at_thread_entry)
+    basic_thread_pool( unsigned const thread_count, AtThreadEntry& at_thread_entry,
+        typename disable_if<detail::is_worker_attributes<AtThreadEntry>, int>::type* = 0)
+    : slots(new worker_slot[thread_count]), slot_count(thread_count), registered_workers(0)
     {
       try
       {
@@ -190,6 +333,7 @@ namespace executors
     }
 #endif
     basic_thread_pool( unsigned const thread_count, void(*at_thread_entry)(basic_thread_pool&))
+    : slots(new worker_slot[thread_count]), slot_count(thread_count), registered_workers(0)
     {
       try
       {
@@ -208,7 +352,9 @@ namespace executors
       }
     }
     template <class AtThreadEntry>
-    basic_thread_pool( unsigned const thread_count, BOOST_THREAD_FWD_REF(AtThreadEntry) at_thread_entry)
+    basic_thread_pool( unsigned const thread_count, BOOST_THREAD_FWD_REF(AtThreadEntry) at_thread_entry,
+        typename disable_if<detail::is_worker_attributes<typename decay<AtThreadEntry>::type>, int>::type* = 0)
+    : slots(new worker_slot[thread_count]), slot_count(thread_count), registered_workers(0)
     {
       try
       {
@@ -226,6 +372,33 @@ namespace executors
         throw;
       }
     }
+    /**
+     * \b Effects: creates a thread pool that runs closures on \c thread_count threads, whose attributes are set by
+     * \c attrs, e.g. to bind each one to its own core.
+     *
+     * \b Throws: Whatever exception is thrown while initializing the needed resources.
+     */
+    template <class Generator>
+    basic_thread_pool( unsigned const thread_count, worker_attributes<Generator> const& attrs)
+    : slots(new worker_slot[thread_count]), slot_count(thread_count), registered_workers(0)
+    {
+      try
+      {
+        threads.reserve(thread_count);
+        for (unsigned i = 0; i < thread_count; ++i)
+        {
+          thread_attributes worker_attrs;
+          attrs(i, worker_attrs);
+          thread th (worker_attrs, boost::bind(&basic_thread_pool::worker_thread, this));
+          threads.push_back(thread_t(boost::move(th)));
+        }
+      }
+      catch (...)
+      {
+        close();
+        throw;
+      }
+    }
     /**
      * \b Effects: Destroys the thread pool.
      *
@@ -260,6 +433,8 @@ namespace executors
      *
      * \b Effects: The specified \c closure will be scheduled for execution at some point in the future.
      * If invoked closure throws an exception the \c basic_thread_pool will call \c std::terminate, as is the case with threads.
+     * When called from one of the worker threads, the closure is the next one run by this worker, unless it has
+     * already run too many closures in a row this way or another idle worker steals it.
      *
      * \b Synchronization: completion of \c closure on a particular thread happens before destruction of thread's thread local variables.
      *
@@ -271,16 +446,14 @@ namespace executors
     template <typename Closure>
     void submit(Closure & closure)
     {
-      //work w ((closure));
-      //work_queue.push_back(boost::move(w));
-      work_queue.push_back(work(closure)); // todo check why this doesn't work
+      work w ((closure));
+      submit_work(w);
     }
 #endif
     void submit(void (*closure)())
     {
-      //work w ((closure));
-      //work_queue.push_back(boost::move(w));
-      work_queue.push_back(work(closure)); // todo check why this doesn't work
+      work w ((closure));
+      submit_work(w);
     }
 
 #if 0
@@ -295,7 +468,8 @@ namespace executors
     template <typename Closure>
     void submit(BOOST_THREAD_FWD_REF(Closure) closure)
     {
-      work_queue.push_back(work(boost::forward<Closure>(closure)));
+      work w ((boost::forward<Closure>(closure)));
+      submit_work(w);
     }
 #endif
     /**
@@ -0,0 +1,79 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_THREAD_EXECUTORS_CURRENT_EXECUTOR_HPP
+#define BOOST_THREAD_EXECUTORS_CURRENT_EXECUTOR_HPP
+
+#include <boost/thread/detail/config.hpp>
+#include <boost/thread/detail/delete.hpp>
+
+#include <boost/config/abi_prefix.hpp>
+
+namespace boost
+{
+  namespace detail
+  {
+    /// The executor whose pending closures the current thread runs while it waits for a future.
+    struct current_executor_entry
+    {
+      void* executor;
+      bool (*try_executing_one)(void*);
+      /// executor specific data of the worker thread, if the current thread is one of the executor workers.
+      void* worker;
+      /// whether the worker thread must keep polling the executor instead of parking while it waits.
+      bool polling;
+      current_executor_entry* previous;
+    };
+
+    BOOST_THREAD_DECL current_executor_entry* get_current_executor() BOOST_NOEXCEPT;
+    /// Throws: std::bad_alloc when the first entry of the thread is set, if the compiler has no @c thread_local.
+    BOOST_THREAD_DECL void set_current_executor(current_executor_entry* entry);
+  }
+
+  namespace executors
+  {
+    /**
+     * While an instance is alive, a thread blocked on a future (e.g. in @c get() or @c wait()) runs the closures
+     * pending in @c ex instead of blocking, and parks only when there is none.
+     * The executor worker threads install it for their executor, with their own data as @c worker. The workers of
+     * an executor whose closures are only run by polling it, as the shards of a @c shard_runtime, set @c polling:
+     * they never park while they wait, but keep polling the executor until the future is ready.
+     */
+    template <class Executor>
+    class current_executor_guard
+    {
+      detail::current_executor_entry entry_;
+
+      static bool try_executing_one(void* ex)
+      {
+        return static_cast<Executor*>(ex)->try_executing_one();
+      }
+    public:
+      BOOST_THREAD_NO_COPYABLE(current_executor_guard)
+
+      explicit current_executor_guard(Executor& ex, void* worker = 0, bool polling = false)
+      {
+        entry_.executor = &ex;
+        entry_.try_executing_one = &current_executor_guard::try_executing_one;
+        entry_.previous = detail::get_current_executor();
+        // a worker thread waiting on a future with its own executor stays one of its workers.
+        bool const same = worker == 0 && entry_.previous != 0 && entry_.previous->executor == &ex;
+        entry_.worker = same ? entry_.previous->worker : worker;
+        entry_.polling = same ? entry_.previous->polling : polling;
+        detail::set_current_executor(&entry_);
+      }
+      ~current_executor_guard()
+      {
+        // doesn't throw: the storage of the thread has been allocated by the constructor.
+        detail::set_current_executor(entry_.previous);
+      }
+    };
+  }
+  using executors::current_executor_guard;
+}
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif
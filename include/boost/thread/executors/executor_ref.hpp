@@ -0,0 +1,179 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_THREAD_EXECUTORS_EXECUTOR_REF_HPP
+#define BOOST_THREAD_EXECUTORS_EXECUTOR_REF_HPP
+
+#include <boost/thread/detail/config.hpp>
+
+#include <boost/thread/detail/move.hpp>
+#include <boost/thread/executors/work.hpp>
+#include <boost/core/enable_if.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/remove_cv.hpp>
+
+#include <boost/config/abi_prefix.hpp>
+
+namespace boost
+{
+  namespace executors
+  {
+    class executor_ref;
+  }
+
+  namespace detail
+  {
+    struct executor_ref_vtable
+    {
+      void (*close)(void*);
+      bool (*closed)(void*);
+      void (*submit)(void*, executors::work&);
+      bool (*try_executing_one)(void*);
+    };
+
+    template <class Executor>
+    struct executor_ref_functions
+    {
+      static void close(void* ex)
+      {
+        static_cast<Executor*>(ex)->close();
+      }
+      static bool closed(void* ex)
+      {
+        return static_cast<Executor*>(ex)->closed();
+      }
+      static void submit(void* ex, executors::work& closure)
+      {
+        static_cast<Executor*>(ex)->submit(boost::move(closure));
+      }
+      static bool try_executing_one(void* ex)
+      {
+        return static_cast<Executor*>(ex)->try_executing_one();
+      }
+      static executor_ref_vtable const vtable;
+    };
+    template <class Executor>
+    executor_ref_vtable const executor_ref_functions<Executor>::vtable =
+    {
+      &executor_ref_functions<Executor>::close,
+      &executor_ref_functions<Executor>::closed,
+      &executor_ref_functions<Executor>::submit,
+      &executor_ref_functions<Executor>::try_executing_one
+    };
+
+    /// How the library components that don't own the executor they use store it: by reference, except
+    /// executor_ref, which is itself a reference and is stored by value.
+    template <class Executor>
+    struct stored_executor
+    {
+      typedef Executor& type;
+    };
+    template <>
+    struct stored_executor<executors::executor_ref>
+    {
+      typedef executors::executor_ref type;
+    };
+  }
+
+  namespace executors
+  {
+
+  /**
+   * Non-owning type-erased reference to a model of Executor.
+   *
+   * It is a pointer to the executor and a pointer to a static table of functions, so it can be copied and passed by
+   * value, and, contrary to executor_adaptor, it doesn't need the executor to be allocated nor virtual functions.
+   * The referenced executor must outlive the executor_ref and all its copies.
+   */
+  class executor_ref
+  {
+    void* ex_;
+    detail::executor_ref_vtable const* vt_;
+  public:
+    /// type-erasure to store the works to do
+    typedef  executors::work work;
+
+    /**
+     * \b Effects: Constructs an executor_ref referencing @c ex.
+     */
+    template <class Executor>
+    executor_ref(Executor& ex,
+        typename disable_if<is_same<typename remove_cv<Executor>::type, executor_ref>, int>::type = 0) BOOST_NOEXCEPT
+    : ex_(&ex), vt_(&detail::executor_ref_functions<Executor>::vtable)
+    {
+    }
+
+    /**
+     * \b Effects: close the referenced executor for submissions.
+     */
+    void close() { vt_->close(ex_); }
+
+    /**
+     * \b Returns: whether the referenced executor is closed for submissions.
+     */
+    bool closed() { return vt_->closed(ex_); }
+
+    /**
+     * \b Effects: The specified closure will be scheduled for execution on the referenced executor. A @c work is
+     * forwarded as is, any other closure is converted once to @c work.
+     *
+     * \b Throws: Whatever exception the referenced executor submit() throws.
+     */
+    void submit(BOOST_THREAD_RV_REF(work) closure)
+    {
+      vt_->submit(ex_, closure);
+    }
+
+#if defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    template <typename Closure>
+    void submit(Closure & closure)
+    {
+      work w ((closure));
+      submit(boost::move(w));
+    }
+#endif
+    void submit(void (*closure)())
+    {
+      work w ((closure));
+      submit(boost::move(w));
+    }
+
+    template <typename Closure>
+    void submit(BOOST_THREAD_RV_REF(Closure) closure)
+    {
+      work w = boost::move(closure);
+      submit(boost::move(w));
+    }
+
+    /**
+     * Effects: try to execute one task of the referenced executor.
+     * Returns: whether a task has been executed.
+     */
+    bool try_executing_one() { return vt_->try_executing_one(ex_); }
+
+    /**
+     * \b Requires: This must be called from an scheduled task.
+     *
+     * \b Effects: reschedule functions until pred()
+     */
+    template <typename Pred>
+    bool reschedule_until(Pred const& pred)
+    {
+      do {
+        if ( ! try_executing_one())
+        {
+          return false;
+        }
+      } while (! pred());
+      return true;
+    }
+  };
+  }
+  using executors::executor_ref;
+}
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif
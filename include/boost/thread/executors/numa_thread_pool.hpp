@@ -0,0 +1,395 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_THREAD_EXECUTORS_NUMA_THREAD_POOL_HPP
+#define BOOST_THREAD_EXECUTORS_NUMA_THREAD_POOL_HPP
+
+#include <boost/thread/detail/config.hpp>
+#include <boost/thread/detail/delete.hpp>
+#include <boost/thread/detail/move.hpp>
+#include <boost/thread/detail/numa.hpp>
+#include <boost/thread/topology.hpp>
+#include <boost/thread/scoped_thread.hpp>
+#include <boost/thread/sync_queue.hpp>
+#include <boost/thread/executors/work.hpp>
+#include <boost/thread/executors/current_executor.hpp>
+#include <boost/thread/csbl/vector.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/bind.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include <boost/config/abi_prefix.hpp>
+
+namespace boost
+{
+namespace executors
+{
+  /**
+   * A thread pool with a queue and a set of worker threads per NUMA node, the workers of a node being bound to its
+   * CPUs and allocating their memory from it.
+   *
+   * A closure submitted with @c submit() goes to the node of the submitting thread, so that it runs close to the
+   * memory the submitting thread has allocated. The idle workers of a node steal the closures of the other nodes
+   * only after having found their own queue empty a number of times in a row, as a remote closure pays the remote
+   * memory latency.
+   *
+   * The nodes are those of @c this_system::topology() that have CPUs the creating thread is allowed to run on, and
+   * their workers are bound to these CPUs. With at most one such node, e.g. on a machine with a single node, in a
+   * process restricted to the CPUs of a node, or if the topology can not be read, the pool has a single node whose
+   * workers are not bound.
+   */
+  class numa_thread_pool
+  {
+  public:
+    /// type-erasure to store the works to do
+    typedef  executors::work work;
+  private:
+    typedef scoped_thread<> thread_t;
+    typedef csbl::vector<thread_t> thread_vector;
+
+    struct node
+    {
+      /// the id of the node for the system.
+      unsigned id;
+      /// the CPUs of the node the process is allowed to run on.
+      std::vector<unsigned> cpus;
+      sync_queue<work> queue;
+    };
+
+    scoped_array<node> nodes;
+    std::size_t node_count_;
+    /// the index of the node of each CPU, or -1.
+    std::vector<int> node_of_cpu;
+    unsigned const steal_threshold_;
+    thread_vector threads;
+
+    /// \b Returns: whether a closure has been taken from @c q, even if it has thrown.
+    static bool try_executing(sync_queue<work>& q)
+    {
+      work task;
+      if (q.try_pull_front(task) != queue_op_status::success)
+      {
+        return false;
+      }
+      try
+      {
+        task();
+      }
+      catch (...)
+      {
+      }
+      return true;
+    }
+
+    /**
+     * Effects: try to execute one closure of the nodes other than @c n, starting with the next one.
+     */
+    bool try_stealing(std::size_t n)
+    {
+      for (std::size_t i = 1; i < node_count_; ++i)
+      {
+        if (try_executing(nodes[(n + i) % node_count_].queue))
+        {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /**
+     * The main loop of the worker threads of node @c n
+     */
+    void worker_thread(std::size_t n)
+    {
+      current_executor_guard<numa_thread_pool> guard(*this, &nodes[n]);
+      unsigned idle = 0;
+      while (!closed())
+      {
+        if (try_executing(nodes[n].queue))
+        {
+          idle = 0;
+        }
+        else if (++idle >= steal_threshold_ && try_stealing(n))
+        {
+          idle = 0;
+        }
+        else
+        {
+          this_thread::yield();
+        }
+      }
+      while (try_executing(nodes[n].queue) || try_stealing(n))
+      {
+      }
+    }
+
+    void create_threads(std::size_t n, unsigned threads_per_node)
+    {
+      for (unsigned i = 0; i < threads_per_node; ++i)
+      {
+        thread_attributes attrs;
+#if defined BOOST_THREAD_PLATFORM_PTHREAD
+        // a single node has nothing to be bound to.
+        if (node_count_ > 1)
+        {
+          attrs.set_numa_node(nodes[n].id);
+#if defined BOOST_THREAD_DEFINES_THREAD_ATTRIBUTES_CPU_SET
+          // only the allowed CPUs: an affinity without any of them makes the creation of the thread fail.
+          thread_attributes::cpu_set_type cpus;
+          CPU_ZERO(&cpus);
+          for (std::size_t c = 0; c < nodes[n].cpus.size(); ++c) CPU_SET(nodes[n].cpus[c], &cpus);
+          attrs.set_affinity(cpus);
+#endif
+        }
+#endif
+        thread th (attrs, boost::bind(&numa_thread_pool::worker_thread, this, n));
+        threads.push_back(thread_t(boost::move(th)));
+      }
+    }
+
+  public:
+    /// numa_thread_pool is not copyable.
+    BOOST_THREAD_NO_COPYABLE(numa_thread_pool)
+
+    /**
+     * \b Effects: creates a thread pool with \c threads_per_node worker threads per NUMA node, or as many workers as
+     * the node has CPUs if \c threads_per_node is 0, scaled down to \c this_system::effective_concurrency(). An idle worker steals the closures of the other nodes after
+     * having found the queue of its node empty \c steal_threshold times in a row.
+     *
+     * \b Throws: Whatever exception is thrown while initializing the needed resources.
+     */
+    explicit numa_thread_pool(unsigned const threads_per_node = 0, unsigned const steal_threshold = 64)
+    : node_count_(0), steal_threshold_(steal_threshold)
+    {
+      this_system::cpu_topology const& topo = this_system::topology();
+      std::vector<unsigned> allowed_cpus;
+      bool const restricted = detail::get_allowed_cpu_list(allowed_cpus);
+      // the nodes without CPUs the process is allowed to run on only have memory for it.
+      std::vector<std::size_t> topo_nodes;
+      std::vector<std::vector<unsigned> > node_cpus;
+      std::vector<int> pool_node(topo.numa_nodes().size(), -1);
+      std::size_t cpu_count = 0;
+      for (std::size_t t = 0; t < topo.numa_nodes().size(); ++t)
+      {
+        std::vector<unsigned> cpus;
+        for (std::size_t c = 0; c < topo.numa_nodes()[t].size(); ++c)
+        {
+          unsigned const id = topo.numa_nodes()[t][c];
+          if (! restricted || std::find(allowed_cpus.begin(), allowed_cpus.end(), id) != allowed_cpus.end())
+            cpus.push_back(id);
+        }
+        if (cpus.empty()) continue;
+        pool_node[t] = static_cast<int>(topo_nodes.size());
+        topo_nodes.push_back(t);
+        cpu_count += cpus.size();
+        node_cpus.push_back(cpus);
+      }
+      if (topo_nodes.size() <= 1)
+      {
+        // a single node, not bound to its CPUs.
+        topo_nodes.clear();
+        std::fill(pool_node.begin(), pool_node.end(), -1);
+      }
+      if (cpu_count == 0) cpu_count = topo.logical_cpu_count();
+      node_count_ = topo_nodes.empty() ? 1 : topo_nodes.size();
+      nodes.reset(new node[node_count_]);
+      std::vector<unsigned> workers(node_count_, threads_per_node);
+      // a process limited by its CPU quota gets proportionally fewer workers on each node.
+      std::size_t allowed = (std::min)(cpu_count, static_cast<std::size_t>(this_system::effective_concurrency()));
+      for (std::size_t n = 0; n < node_count_; ++n)
+      {
+        nodes[n].id = topo_nodes.empty() ? 0u : topo.numa_node_ids()[topo_nodes[n]];
+        if (! topo_nodes.empty()) nodes[n].cpus = node_cpus[n];
+        if (workers[n] == 0)
+        {
+          std::size_t cpus = topo_nodes.empty() ? cpu_count : node_cpus[n].size();
+          workers[n] = cpu_count == 0 ? 0u : static_cast<unsigned>(cpus * allowed / cpu_count);
+          if (workers[n] == 0) workers[n] = 1;
+        }
+      }
+      // the CPUs are all mapped before the workers start to look up their node.
+      for (std::size_t i = 0; i < topo.cpus().size(); ++i)
+      {
+        this_system::cpu_topology::cpu const& c = topo.cpus()[i];
+        if (c.id >= node_of_cpu.size()) node_of_cpu.resize(c.id + 1, -1);
+        node_of_cpu[c.id] = topo_nodes.empty() ? 0 : pool_node[c.numa_node];
+      }
+      try
+      {
+        for (std::size_t n = 0; n < node_count_; ++n)
+        {
+          create_threads(n, workers[n]);
+        }
+      }
+      catch (...)
+      {
+        close();
+        throw;
+      }
+    }
+    /**
+     * \b Effects: Destroys the thread pool.
+     *
+     * \b Synchronization: The completion of all the closures happen before the completion of the destructor.
+     */
+    ~numa_thread_pool()
+    {
+      // signal to all the worker threads that there will be no more submissions.
+      close();
+      // joins all the threads as the threads were scoped_threads
+    }
+
+    /**
+     * \b Effects: close the \c numa_thread_pool for submissions.
+     * The worker threads will work until there is no more closures to run.
+     */
+    void close()
+    {
+      for (std::size_t n = 0; n < node_count_; ++n)
+      {
+        nodes[n].queue.close();
+      }
+    }
+
+    /**
+     * \b Returns: whether the pool is closed for submissions.
+     */
+    bool closed()
+    {
+      return nodes[node_count_ - 1].queue.closed();
+    }
+
+    /**
+     * \b Returns: the number of NUMA nodes of the pool.
+     */
+    std::size_t node_count() const BOOST_NOEXCEPT
+    {
+      return node_count_;
+    }
+
+    /**
+     * \b Returns: the system id of the node of index \c n.
+     */
+    unsigned node_id(std::size_t n) const
+    {
+      return nodes[n].id;
+    }
+
+    /**
+     * \b Returns: the index of the node of the current thread: the node of the worker if it is one of the workers
+     * of the pool, the node of the CPU it is running on otherwise, or 0 if unknown.
+     */
+    std::size_t current_node() const
+    {
+      for (detail::current_executor_entry* e = detail::get_current_executor(); e != 0; e = e->previous)
+      {
+        if (e->executor == static_cast<void const*>(this))
+        {
+          return static_cast<node const*>(e->worker) - &nodes[0];
+        }
+      }
+      int cpu = detail::get_current_cpu();
+      if (cpu >= 0 && static_cast<std::size_t>(cpu) < node_of_cpu.size() && node_of_cpu[cpu] >= 0)
+      {
+        return static_cast<std::size_t>(node_of_cpu[cpu]);
+      }
+      return 0;
+    }
+
+    /**
+     * \b Returns: the number of closures waiting in the queue of node \c n.
+     */
+    std::size_t depth(std::size_t n) const
+    {
+      return nodes[n].queue.size();
+    }
+
+    /**
+     * \b Requires: \c Closure is a model of \c Callable(void()) and a model of \c CopyConstructible/MoveConstructible.
+     *
+     * \b Effects: The specified \c closure will be run by a worker of node \c n, unless it is stolen by an idle
+     * worker of another node.
+     *
+     * \b Throws: \c sync_queue_is_closed if the pool is closed.
+     * Whatever exception that can be throw while storing the closure.
+     */
+#if defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    template <typename Closure>
+    void submit_on_node(std::size_t n, Closure & closure)
+    {
+      work w ((closure));
+      nodes[n].queue.push_back(boost::move(w));
+    }
+#endif
+    void submit_on_node(std::size_t n, void (*closure)())
+    {
+      work w ((closure));
+      nodes[n].queue.push_back(boost::move(w));
+    }
+
+    template <typename Closure>
+    void submit_on_node(std::size_t n, BOOST_THREAD_FWD_REF(Closure) closure)
+    {
+      work w ((boost::forward<Closure>(closure)));
+      nodes[n].queue.push_back(boost::move(w));
+    }
+
+    /**
+     * \b Effects: The same as \c submit_on_node(current_node(), closure).
+     */
+#if defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    template <typename Closure>
+    void submit(Closure & closure)
+    {
+      submit_on_node(current_node(), closure);
+    }
+#endif
+    void submit(void (*closure)())
+    {
+      submit_on_node(current_node(), closure);
+    }
+
+    template <typename Closure>
+    void submit(BOOST_THREAD_FWD_REF(Closure) closure)
+    {
+      submit_on_node(current_node(), boost::forward<Closure>(closure));
+    }
+
+    /**
+     * Effects: try to execute one closure, starting with the ones of the node of the current thread.
+     * Returns: whether a closure has been executed.
+     */
+    bool try_executing_one()
+    {
+      std::size_t n = current_node();
+      return try_executing(nodes[n].queue) || try_stealing(n);
+    }
+
+    /**
+     * \b Requires: This must be called from an scheduled task.
+     *
+     * \b Effects: reschedule functions until pred()
+     */
+    template <typename Pred>
+    bool reschedule_until(Pred const& pred)
+    {
+      do {
+        if ( ! try_executing_one())
+        {
+          return false;
+        }
+      } while (! pred());
+      return true;
+    }
+  };
+}
+using executors::numa_thread_pool;
+}
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif
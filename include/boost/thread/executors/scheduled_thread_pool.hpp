@@ -2,6 +2,7 @@
 #define SCHEDULED_THREAD_POOL_HPP
 
 #include <boost/thread/detail/scheduled_executor_base.hpp>
+#include <boost/thread/executors/worker_attributes.hpp>
 
 namespace boost
 {
@@ -19,6 +20,17 @@ namespace boost
       }
     }
 
+    template <class Generator>
+    scheduled_thread_pool(size_t num_threads, executors::worker_attributes<Generator> const& attrs) : super()
+    {
+      for(size_t i = 0; i < num_threads; i++)
+      {
+        thread_attributes worker_attrs;
+        attrs(static_cast<unsigned>(i), worker_attrs);
+        _workers.add_thread(new thread(worker_attrs, bind(&scheduled_thread_pool::worker_loop, this)));
+      }
+    }
+
     ~scheduled_thread_pool()
     {
       this->close();
@@ -2,6 +2,7 @@
 #define SCHEDULING_ADAPTOR_HPP
 
 #include <boost/thread/detail/scheduled_executor_base.hpp>
+#include <boost/thread/executors/executor_ref.hpp>
 
 namespace boost{
 
@@ -9,11 +10,12 @@ namespace boost{
   class scheduling_adpator : public detail::scheduled_executor_base
   {
   private:
-    Executor& _exec;
+    typename detail::stored_executor<Executor>::type _exec;
     thread _scheduler;
   public:
 
-    scheduling_adpator(Executor& ex)
+    /// Executor can be executor_ref, in which case the reference is stored by value.
+    scheduling_adpator(typename detail::stored_executor<Executor>::type ex)
       : super(),
         _exec(ex),
         _scheduler(&scheduling_adpator::scheduler_loop, this) {}
@@ -15,6 +15,7 @@
 #include <boost/thread/sync_queue.hpp>
 #include <boost/thread/executors/work.hpp>
 #include <boost/thread/executors/executor.hpp>
+#include <boost/thread/executors/executor_ref.hpp>
 #include <boost/thread/future.hpp>
 #include <boost/thread/scoped_thread.hpp>
 
@@ -34,7 +35,7 @@ namespace executors
 
     /// the thread safe work queue
     sync_queue<work > work_queue;
-    executor& ex;
+    executor_ref ex;
     thread_t thr;
 
     struct try_executing_one_task {
@@ -115,10 +116,11 @@ namespace executors
 
     /**
      * \b Effects: creates a thread pool that runs closures using one of its closure-executing methods.
+     * Any model of Executor, as well as an \c executor, converts implicitly to \c executor_ref.
      *
      * \b Throws: Whatever exception is thrown while initializing the needed resources.
      */
-    serial_executor(executor& ex)
+    serial_executor(executor_ref ex)
     : ex(ex), thr(&serial_executor::worker_thread, this)
     {
     }
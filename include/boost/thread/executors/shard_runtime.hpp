@@ -0,0 +1,608 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_THREAD_EXECUTORS_SHARD_RUNTIME_HPP
+#define BOOST_THREAD_EXECUTORS_SHARD_RUNTIME_HPP
+
+#include <boost/thread/detail/config.hpp>
+#include <boost/thread/detail/delete.hpp>
+#include <boost/thread/detail/move.hpp>
+#include <boost/thread/detail/spsc_queue.hpp>
+#include <boost/thread/scoped_thread.hpp>
+#include <boost/thread/sync_queue.hpp>
+#include <boost/thread/future.hpp>
+#include <boost/thread/topology.hpp>
+#include <boost/thread/detail/numa.hpp>
+#include <boost/thread/executors/work.hpp>
+#include <boost/thread/executors/current_executor.hpp>
+#include <boost/thread/csbl/vector.hpp>
+#include <boost/thread/csbl/deque.hpp>
+#include <boost/chrono/system_clocks.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/atomic.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <queue>
+#include <vector>
+
+#if defined BOOST_THREAD_LINUX && defined BOOST_THREAD_PLATFORM_PTHREAD
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <boost/config/abi_prefix.hpp>
+
+namespace boost
+{
+namespace detail
+{
+  /// Binds the calling thread to @c cpu, when the platform allows it.
+  inline void pin_current_thread_to_cpu(unsigned cpu)
+  {
+#if defined BOOST_THREAD_LINUX && defined BOOST_THREAD_PLATFORM_PTHREAD && defined CPU_SET
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu % CPU_SETSIZE, &set);
+    // the affinity is only a hint: the runtime works the same when it can not be set.
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+  }
+}
+
+namespace executors
+{
+  /**
+   * A thread-per-core runtime: each shard is run by its own thread, bound to its own CPU, which polls the closures
+   * sent to the shard and its local timers.
+   *
+   * The closures sent from a shard to another shard go through a single-producer single-consumer queue owned by
+   * the pair of shards, so that the shards never share a lock. They are buffered while the sending shard runs its
+   * closures and published once per poll iteration, so that the cost of the cross-core synchronization is shared by
+   * all the closures of the batch. The closures sent by the threads that are not shards go through a locked queue.
+   *
+   * The shard threads never block: they poll while they are idle, and a closure waiting on a future keeps polling
+   * its shard until the future is ready.
+   */
+  class shard_runtime
+  {
+  public:
+    /// type-erasure to store the works to do
+    typedef  executors::work work;
+    /// the clock of the local timers.
+    typedef  chrono::steady_clock clock;
+
+    /**
+     * The executor submitting the closures to a single shard, so that the future returning functions as
+     * @c async() or @c future::then() can be used with a shard.
+     */
+    class executor_type
+    {
+      friend class shard_runtime;
+      shard_runtime* runtime_;
+      std::size_t shard_;
+    public:
+      executor_type() : runtime_(0), shard_(0)
+      {
+      }
+
+      /// \b Returns: the index of the shard.
+      std::size_t shard() const BOOST_NOEXCEPT
+      {
+        return shard_;
+      }
+
+      /// \b Effects: closes the runtime of the shard.
+      void close()
+      {
+        runtime_->close();
+      }
+      /// \b Returns: whether the runtime of the shard is closed for submissions.
+      bool closed()
+      {
+        return runtime_->closed();
+      }
+
+      /// \b Effects: the same as @c submit_to(shard(), closure) on the runtime of the shard.
+#if defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+      template <typename Closure>
+      void submit(Closure & closure)
+      {
+        runtime_->submit_to(shard_, closure);
+      }
+#endif
+      void submit(void (*closure)())
+      {
+        runtime_->submit_to(shard_, closure);
+      }
+
+      template <typename Closure>
+      void submit(BOOST_THREAD_FWD_REF(Closure) closure)
+      {
+        runtime_->submit_to(shard_, boost::forward<Closure>(closure));
+      }
+
+      /// \b Effects: the same as @c try_executing_one() on the runtime of the shard.
+      bool try_executing_one()
+      {
+        return runtime_->try_executing_one();
+      }
+
+      template <typename Pred>
+      bool reschedule_until(Pred const& pred)
+      {
+        do {
+          if ( ! try_executing_one())
+          {
+            return false;
+          }
+        } while (! pred());
+        return true;
+      }
+    };
+
+  private:
+    typedef scoped_thread<> thread_t;
+    typedef csbl::vector<thread_t> thread_vector;
+    typedef detail::spsc_queue<work> channel;
+
+    /// the maximum number of closures a shard takes from one of its queues in a poll iteration.
+    static const std::size_t batch_size = 64;
+
+    struct timer
+    {
+      clock::time_point at;
+      work task;
+
+      timer(clock::time_point const& at_, work const& task_) : at(at_), task(task_)
+      {
+      }
+    };
+    struct timer_later
+    {
+      bool operator()(timer const& x, timer const& y) const
+      {
+        return y.at < x.at;
+      }
+    };
+
+    struct shard
+    {
+      executor_type executor;
+      /// the closures sent by the other shards, one queue per sending shard.
+      scoped_array<scoped_ptr<channel> > inbox;
+      /// the closures sent by the threads that are not shards.
+      sync_queue<work> external;
+      /// the closures sent by the shard to itself.
+      csbl::deque<work> local;
+      /// the closures sent by the shard during the current poll iteration, one buffer per receiving shard.
+      scoped_array<std::vector<work> > outbox;
+      std::priority_queue<timer, std::vector<timer>, timer_later> timers;
+      /// the number of closures created by the shard since it last updated the in flight count.
+      long created;
+
+      shard() : created(0)
+      {
+      }
+    };
+
+    struct timer_setter
+    {
+      shard_runtime* runtime;
+      clock::time_point at;
+      work task;
+
+      void operator()()
+      {
+        runtime->add_timer(at, task);
+      }
+    };
+
+    scoped_array<shard> shards;
+    std::size_t shard_count_;
+    /// the number of closures sent, including the pending timers, that have not yet been run.
+    atomic<long> in_flight;
+    atomic<bool> closed_;
+    thread_vector threads;
+
+    /// \b Effects: stores in @c cpus the CPUs the shards are bound to: on each physical core, the first of its
+    /// hardware threads the process is allowed to run on. It is empty when the topology can not be read.
+    static void shard_cpus(std::vector<unsigned>& cpus)
+    {
+      std::vector<unsigned> allowed;
+      bool const restricted = detail::get_allowed_cpu_list(allowed);
+      this_system::cpu_topology const& topo = this_system::topology();
+      for (std::size_t c = 0; c < topo.physical_core_count(); ++c)
+      {
+        this_system::cpu_topology::cpu_list const& core = topo.cores()[c];
+        for (std::size_t i = 0; i < core.size(); ++i)
+        {
+          if (! restricted || std::find(allowed.begin(), allowed.end(), core[i]) != allowed.end())
+          {
+            cpus.push_back(core[i]);
+            break;
+          }
+        }
+      }
+    }
+
+    static std::size_t default_shard_count()
+    {
+      unsigned n = thread::physical_concurrency();
+      unsigned allowed = this_system::effective_concurrency();
+      return n == 0 || allowed < n ? allowed : n;
+    }
+
+    /// \b Returns: the shard run by the current thread, if it is one of the shards of this runtime.
+    shard* current_shard() const
+    {
+      // a closure waiting on a future with another executor installs it on top of the shard one.
+      for (detail::current_executor_entry* e = detail::get_current_executor(); e != 0; e = e->previous)
+      {
+        if (e->executor == static_cast<void const*>(this)) return static_cast<shard*>(e->worker);
+      }
+      return 0;
+    }
+
+    static void run(work& task)
+    {
+      try
+      {
+        task();
+      }
+      catch (std::exception& )
+      {
+      }
+      catch (...)
+      {
+      }
+    }
+
+    void send(std::size_t s, work& w)
+    {
+      shard* me = current_shard();
+      if (me == 0)
+      {
+        in_flight.fetch_add(1, memory_order_acq_rel);
+        try
+        {
+          shards[s].external.push_back(boost::move(w));
+        }
+        catch (...)
+        {
+          in_flight.fetch_sub(1, memory_order_acq_rel);
+          throw;
+        }
+      }
+      else
+      {
+        if (me == &shards[s])
+        {
+          me->local.push_back(w);
+        }
+        else
+        {
+          me->outbox[s].push_back(w);
+        }
+        ++me->created;
+      }
+    }
+
+    void add_timer(clock::time_point const& at, work const& task)
+    {
+      // the timers set once the runtime is closed are discarded.
+      if (closed_.load(memory_order_acquire)) return;
+      shard* me = current_shard();
+      me->timers.push(timer(at, task));
+      ++me->created;
+    }
+
+    void set_timer(std::size_t s, clock::time_point const& at, work const& task)
+    {
+      timer_setter setter;
+      setter.runtime = this;
+      setter.at = at;
+      setter.task = task;
+      submit_to(s, setter);
+    }
+
+    /**
+     * Effects: runs the closures received by shard @c sh and its expired timers, then sends the closures they sent.
+     * Returns: whether some progress has been done.
+     */
+    bool poll(shard& sh)
+    {
+      std::size_t s = &sh - &shards[0];
+      long executed = 0;
+      work buffer[batch_size];
+      for (std::size_t src = 0; src < shard_count_; ++src)
+      {
+        if (src == s) continue;
+        std::size_t n = sh.inbox[src]->pop_some(buffer, batch_size);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+          run(buffer[i]);
+        }
+        executed += static_cast<long>(n);
+      }
+      for (std::size_t i = 0; i < batch_size && sh.external.try_pull_front(buffer[0]) == queue_op_status::success; ++i)
+      {
+        run(buffer[0]);
+        ++executed;
+      }
+      // the closures the shard sends to itself while running these ones wait for the next iteration.
+      for (std::size_t n = sh.local.size(); n != 0 && ! sh.local.empty(); --n)
+      {
+        work task = sh.local.front();
+        sh.local.pop_front();
+        run(task);
+        ++executed;
+      }
+      if (! sh.timers.empty())
+      {
+        clock::time_point now = clock::now();
+        while (! sh.timers.empty() && sh.timers.top().at <= now)
+        {
+          work task = sh.timers.top().task;
+          sh.timers.pop();
+          run(task);
+          ++executed;
+        }
+      }
+
+      // the closures sent are accounted before they are published, so that the receiving shards can not see the
+      // count drop to zero while they are still buffered.
+      long delta = sh.created - executed;
+      sh.created = 0;
+      if (delta != 0) in_flight.fetch_add(delta, memory_order_acq_rel);
+
+      bool sent = false;
+      for (std::size_t dst = 0; dst < shard_count_; ++dst)
+      {
+        std::vector<work>& out = sh.outbox[dst];
+        if (out.empty()) continue;
+        // what does not fit in the queue stays buffered until the next iteration.
+        std::size_t n = shards[dst].inbox[s]->push_some(&out[0], out.size());
+        out.erase(out.begin(), out.begin() + n);
+        sent = sent || n != 0;
+      }
+      return executed != 0 || sent;
+    }
+
+    /**
+     * The main loop of the thread of shard @c s, bound to @c cpu if it is not negative.
+     */
+    void worker_thread(std::size_t s, int cpu)
+    {
+      shard& sh = shards[s];
+      if (cpu >= 0)
+      {
+        detail::pin_current_thread_to_cpu(static_cast<unsigned>(cpu));
+      }
+      // the closures waiting on a future keep polling the shard.
+      current_executor_guard<shard_runtime> guard(*this, &sh, true);
+      for (;;)
+      {
+        if (poll(sh)) continue;
+        if (closed_.load(memory_order_acquire))
+        {
+          if (! sh.timers.empty())
+          {
+            in_flight.fetch_sub(static_cast<long>(sh.timers.size()), memory_order_acq_rel);
+            while (! sh.timers.empty()) sh.timers.pop();
+          }
+          if (in_flight.load(memory_order_acquire) == 0) return;
+        }
+        this_thread::yield();
+      }
+    }
+
+  public:
+    /// shard_runtime is not copyable.
+    BOOST_THREAD_NO_COPYABLE(shard_runtime)
+
+    /**
+     * \b Effects: creates a runtime with \c shard_count shards, each one run by its own thread bound to a
+     * physical core the process is allowed to run on.
+     * The queue between two shards can store \c capacity closures.
+     * By default there is a shard per physical core, but no more than \c this_system::effective_concurrency().
+     *
+     * \b Throws: Whatever exception is thrown while initializing the needed resources.
+     */
+    explicit shard_runtime(std::size_t const shard_count = default_shard_count(), std::size_t const capacity = 1024)
+    : shards(new shard[shard_count ? shard_count : 1]), shard_count_(shard_count ? shard_count : 1),
+      in_flight(0), closed_(false)
+    {
+      for (std::size_t i = 0; i < shard_count_; ++i)
+      {
+        shards[i].executor.runtime_ = this;
+        shards[i].executor.shard_ = i;
+        shards[i].inbox.reset(new scoped_ptr<channel>[shard_count_]);
+        shards[i].outbox.reset(new std::vector<work>[shard_count_]);
+        for (std::size_t j = 0; j < shard_count_; ++j)
+        {
+          if (j != i) shards[i].inbox[j].reset(new channel(capacity));
+        }
+      }
+      try
+      {
+        // a shard per physical core the process is allowed to run on.
+        std::vector<unsigned> cpus;
+        shard_cpus(cpus);
+        threads.reserve(shard_count_);
+        for (std::size_t i = 0; i < shard_count_; ++i)
+        {
+          int const cpu = cpus.empty() ? -1 : static_cast<int>(cpus[i % cpus.size()]);
+          thread th (&shard_runtime::worker_thread, this, i, cpu);
+          threads.push_back(thread_t(boost::move(th)));
+        }
+      }
+      catch (...)
+      {
+        close();
+        throw;
+      }
+    }
+    /**
+     * \b Effects: Destroys the runtime.
+     *
+     * \b Synchronization: The completion of all the closures happen before the completion of the destructor.
+     */
+    ~shard_runtime()
+    {
+      // signal to all the shards that there will be no more submissions.
+      close();
+      // joins all the threads as the threads were scoped_threads
+    }
+
+    /**
+     * \b Effects: close the \c shard_runtime for submissions from the threads that are not shards.
+     * The shards work until there is no more closures to run, including the ones they send to each other, and
+     * discard their pending timers.
+     */
+    void close()
+    {
+      for (std::size_t i = 0; i < shard_count_; ++i)
+      {
+        shards[i].external.close();
+      }
+      closed_.store(true, memory_order_release);
+    }
+
+    /**
+     * \b Returns: whether the runtime is closed for submissions.
+     */
+    bool closed()
+    {
+      return closed_.load(memory_order_acquire);
+    }
+
+    /**
+     * \b Returns: the number of shards.
+     */
+    std::size_t shard_count() const BOOST_NOEXCEPT
+    {
+      return shard_count_;
+    }
+
+    /**
+     * \b Returns: the index of the shard run by the current thread, or \c shard_count() if the current thread is
+     * not one of the shards.
+     */
+    std::size_t this_shard() const
+    {
+      shard* me = current_shard();
+      return me ? static_cast<std::size_t>(me - &shards[0]) : shard_count_;
+    }
+
+    /**
+     * \b Returns: the executor submitting the closures to shard \c s.
+     */
+    executor_type& get_executor(std::size_t s)
+    {
+      return shards[s].executor;
+    }
+
+    /**
+     * \b Requires: \c Closure is a model of \c Callable(void()) and a model of \c CopyConstructible/MoveConstructible.
+     *
+     * \b Effects: The specified \c closure will be run by shard \c s, after the closures previously sent to it by
+     * the same shard or thread.
+     *
+     * \b Throws: \c sync_queue_is_closed if the runtime is closed and the current thread is not one of its shards.
+     * Whatever exception that can be throw while storing the closure.
+     */
+#if defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    template <typename Closure>
+    void submit_to(std::size_t s, Closure & closure)
+    {
+      work w ((closure));
+      send(s, w);
+    }
+#endif
+    void submit_to(std::size_t s, void (*closure)())
+    {
+      work w ((closure));
+      send(s, w);
+    }
+
+    template <typename Closure>
+    void submit_to(std::size_t s, BOOST_THREAD_FWD_REF(Closure) closure)
+    {
+      work w ((boost::forward<Closure>(closure)));
+      send(s, w);
+    }
+
+    /**
+     * \b Requires: \c Closure is a model of \c Callable(void()) and a model of \c CopyConstructible/MoveConstructible.
+     *
+     * \b Effects: The specified \c closure will be run by shard \c s once \c d has elapsed. The closure is
+     * discarded if the runtime is closed before.
+     *
+     * \b Throws: The same as \c submit_to().
+     */
+    template <typename Rep, typename Period>
+    void submit_after(std::size_t s, chrono::duration<Rep, Period> const& d, void (*closure)())
+    {
+      work w ((closure));
+      set_timer(s, clock::now() + d, w);
+    }
+
+    template <typename Rep, typename Period, typename Closure>
+    void submit_after(std::size_t s, chrono::duration<Rep, Period> const& d, BOOST_THREAD_FWD_REF(Closure) closure)
+    {
+      work w ((boost::forward<Closure>(closure)));
+      set_timer(s, clock::now() + d, w);
+    }
+
+    /**
+     * \b Effects: runs \c f on shard \c s.
+     *
+     * \b Returns: a future storing the result of \c f.
+     */
+    template <typename F>
+    BOOST_THREAD_FUTURE<typename boost::result_of<typename decay<F>::type()>::type>
+    call(std::size_t s, BOOST_THREAD_FWD_REF(F) f)
+    {
+      return boost::async(get_executor(s), boost::forward<F>(f));
+    }
+
+    /**
+     * Effects: if the current thread is one of the shards, runs one poll iteration of its shard, so that a shard
+     * waiting on a future keeps running its closures.
+     * Returns: whether some progress has been done.
+     */
+    bool try_executing_one()
+    {
+      shard* me = current_shard();
+      return me ? poll(*me) : false;
+    }
+
+    /**
+     * \b Requires: This must be called from a closure run by a shard.
+     *
+     * \b Effects: reschedule functions until pred()
+     */
+    template <typename Pred>
+    bool reschedule_until(Pred const& pred)
+    {
+      do {
+        if ( ! try_executing_one())
+        {
+          return false;
+        }
+      } while (! pred());
+      return true;
+    }
+  };
+}
+using executors::shard_runtime;
+}
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif
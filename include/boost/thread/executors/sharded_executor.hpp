@@ -0,0 +1,326 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_THREAD_EXECUTORS_SHARDED_EXECUTOR_HPP
+#define BOOST_THREAD_EXECUTORS_SHARDED_EXECUTOR_HPP
+
+#include <boost/thread/detail/config.hpp>
+#include <boost/thread/detail/delete.hpp>
+#include <boost/thread/detail/move.hpp>
+#include <boost/thread/scoped_thread.hpp>
+#include <boost/thread/sync_queue.hpp>
+#include <boost/thread/topology.hpp>
+#include <boost/thread/executors/work.hpp>
+#include <boost/thread/csbl/vector.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/atomic.hpp>
+#include <cstddef>
+
+#include <boost/config/abi_prefix.hpp>
+
+namespace boost
+{
+namespace executors
+{
+  /**
+   * An executor made of a fixed number of shards, each one run by its own thread.
+   *
+   * The closures submitted with a key are run by the shard the key hashes to, in submission order, so that the
+   * state associated to a key is only accessed by a single thread. The closures submitted without a key are run by
+   * any shard, and an idle shard steals them from the other shards.
+   */
+  class sharded_executor
+  {
+  public:
+    /// type-erasure to store the works to do
+    typedef  executors::work work;
+  private:
+    typedef scoped_thread<> thread_t;
+    typedef csbl::vector<thread_t> thread_vector;
+
+    struct shard
+    {
+      /// the closures submitted with a key, which only this shard runs.
+      sync_queue<work> keyed;
+      /// the closures submitted without a key, which the other shards can steal.
+      sync_queue<work> any;
+    };
+
+    scoped_array<shard> shards;
+    std::size_t shard_count_;
+    /// the shard receiving the next unkeyed closure.
+    atomic<std::size_t> next_any;
+    thread_vector threads;
+
+    static bool try_executing(sync_queue<work>& q)
+    {
+      work task;
+      try
+      {
+        if (q.try_pull_front(task) == queue_op_status::success)
+        {
+          task();
+          return true;
+        }
+        return false;
+      }
+      catch (std::exception& )
+      {
+        return false;
+      }
+      catch (...)
+      {
+        return false;
+      }
+    }
+
+    /**
+     * Effects: try to execute one unkeyed closure, starting with the ones of shard @c first.
+     */
+    bool try_executing_one_any(std::size_t first)
+    {
+      for (std::size_t i = 0; i < shard_count_; ++i)
+      {
+        if (try_executing(shards[(first + i) % shard_count_].any))
+        {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    bool try_executing_one(std::size_t s)
+    {
+      return try_executing(shards[s].keyed) || try_executing_one_any(s);
+    }
+
+    /**
+     * The main loop of the thread of shard @c s
+     */
+    void worker_thread(std::size_t s)
+    {
+      while (!closed())
+      {
+        if ( ! try_executing_one(s))
+        {
+          this_thread::yield();
+        }
+      }
+      while (try_executing_one(s))
+      {
+      }
+    }
+
+  public:
+    /// sharded_executor is not copyable.
+    BOOST_THREAD_NO_COPYABLE(sharded_executor)
+
+    /**
+     * \b Effects: creates an executor with \c shard_count shards, each one with its own thread.
+     * By default there is a shard per CPU the process can use, see \c this_system::effective_concurrency().
+     *
+     * \b Throws: Whatever exception is thrown while initializing the needed resources.
+     */
+    explicit sharded_executor(std::size_t const shard_count = this_system::effective_concurrency())
+    : shards(new shard[shard_count ? shard_count : 1]), shard_count_(shard_count ? shard_count : 1), next_any(0)
+    {
+      try
+      {
+        threads.reserve(shard_count_);
+        for (std::size_t i = 0; i < shard_count_; ++i)
+        {
+          thread th (&sharded_executor::worker_thread, this, i);
+          threads.push_back(thread_t(boost::move(th)));
+        }
+      }
+      catch (...)
+      {
+        close();
+        throw;
+      }
+    }
+    /**
+     * \b Effects: Destroys the sharded executor.
+     *
+     * \b Synchronization: The completion of all the closures happen before the completion of the destructor.
+     */
+    ~sharded_executor()
+    {
+      // signal to all the worker threads that there will be no more submissions.
+      close();
+      // joins all the threads as the threads were scoped_threads
+    }
+
+    /**
+     * \b Effects: close the \c sharded_executor for submissions.
+     * The worker threads will work until there is no more closures to run.
+     */
+    void close()
+    {
+      for (std::size_t i = 0; i < shard_count_; ++i)
+      {
+        shards[i].keyed.close();
+        shards[i].any.close();
+      }
+    }
+
+    /**
+     * \b Returns: whether the executor is closed for submissions.
+     */
+    bool closed()
+    {
+      return shards[shard_count_ - 1].any.closed();
+    }
+
+    /**
+     * \b Returns: the number of shards.
+     */
+    std::size_t shard_count() const BOOST_NOEXCEPT
+    {
+      return shard_count_;
+    }
+
+    /**
+     * \b Returns: the shard that runs the closures submitted with \c key.
+     */
+    template <typename Key>
+    std::size_t shard_of(Key const& key) const
+    {
+      return boost::hash<Key>()(key) % shard_count_;
+    }
+
+    /**
+     * \b Returns: the number of closures submitted with a key that are waiting to be run by shard \c s. A shard
+     * whose depth keeps growing reveals a hot key.
+     */
+    std::size_t depth(std::size_t s) const
+    {
+      return shards[s].keyed.size();
+    }
+
+    /**
+     * \b Returns: the number of closures submitted without a key that are waiting in shard \c s.
+     */
+    std::size_t any_depth(std::size_t s) const
+    {
+      return shards[s].any.size();
+    }
+
+    /**
+     * \b Requires: \c Closure is a model of \c Callable(void()) and a model of \c CopyConstructible/MoveConstructible.
+     *
+     * \b Effects: The specified \c closure will be run by the shard of \c key, after the closures previously
+     * submitted with a key of the same shard.
+     *
+     * \b Throws: \c sync_queue_is_closed if the executor is closed.
+     * Whatever exception that can be throw while storing the closure.
+     */
+#if defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    template <typename Key, typename Closure>
+    void submit(Key const& key, Closure & closure)
+    {
+      work w ((closure));
+      shards[shard_of(key)].keyed.push_back(boost::move(w));
+    }
+#endif
+    template <typename Key>
+    void submit(Key const& key, void (*closure)())
+    {
+      work w ((closure));
+      shards[shard_of(key)].keyed.push_back(boost::move(w));
+    }
+
+    template <typename Key, typename Closure>
+    void submit(Key const& key, BOOST_THREAD_FWD_REF(Closure) closure)
+    {
+      work w ((boost::forward<Closure>(closure)));
+      shards[shard_of(key)].keyed.push_back(boost::move(w));
+    }
+
+    /**
+     * \b Requires: \c Closure is a model of \c Callable(void()) and a model of \c CopyConstructible/MoveConstructible.
+     *
+     * \b Effects: The specified \c closure will be run by any of the shards.
+     *
+     * \b Throws: \c sync_queue_is_closed if the executor is closed.
+     * Whatever exception that can be throw while storing the closure.
+     */
+#if defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    template <typename Closure>
+    void submit_any(Closure & closure)
+    {
+      work w ((closure));
+      shards[next_any.fetch_add(1, memory_order_relaxed) % shard_count_].any.push_back(boost::move(w));
+    }
+#endif
+    void submit_any(void (*closure)())
+    {
+      work w ((closure));
+      shards[next_any.fetch_add(1, memory_order_relaxed) % shard_count_].any.push_back(boost::move(w));
+    }
+
+    template <typename Closure>
+    void submit_any(BOOST_THREAD_FWD_REF(Closure) closure)
+    {
+      work w ((boost::forward<Closure>(closure)));
+      shards[next_any.fetch_add(1, memory_order_relaxed) % shard_count_].any.push_back(boost::move(w));
+    }
+
+    /**
+     * \b Effects: The same as \c submit_any(closure), so that \c sharded_executor is a model of Executor.
+     */
+#if defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    template <typename Closure>
+    void submit(Closure & closure)
+    {
+      submit_any(closure);
+    }
+#endif
+    void submit(void (*closure)())
+    {
+      submit_any(closure);
+    }
+
+    template <typename Closure>
+    void submit(BOOST_THREAD_FWD_REF(Closure) closure)
+    {
+      submit_any(boost::forward<Closure>(closure));
+    }
+
+    /**
+     * Effects: try to execute one closure submitted without a key. The closures submitted with a key are only run by
+     * the thread of their shard.
+     * Returns: whether a closure has been executed.
+     */
+    bool try_executing_one()
+    {
+      return try_executing_one_any(0);
+    }
+
+    /**
+     * \b Requires: This must be called from an scheduled task.
+     *
+     * \b Effects: reschedule functions until pred()
+     */
+    template <typename Pred>
+    bool reschedule_until(Pred const& pred)
+    {
+      do {
+        if ( ! try_executing_one())
+        {
+          return false;
+        }
+      } while (! pred());
+      return true;
+    }
+  };
+}
+using executors::sharded_executor;
+}
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif
@@ -0,0 +1,60 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_THREAD_EXECUTORS_WORKER_ATTRIBUTES_HPP
+#define BOOST_THREAD_EXECUTORS_WORKER_ATTRIBUTES_HPP
+
+#include <boost/thread/detail/config.hpp>
+#include <boost/thread/thread_only.hpp>
+#include <boost/type_traits/integral_constant.hpp>
+
+#include <boost/config/abi_prefix.hpp>
+
+namespace boost
+{
+namespace executors
+{
+  /**
+   * Sets the attributes of each worker thread of a pool: the pool calls @c generator(i, attrs) with a default
+   * constructed @c thread_attributes before creating its worker @c i, e.g. to bind the workers to their own core
+   * or to give them a name.
+   */
+  template <class Generator>
+  class worker_attributes
+  {
+    Generator generator_;
+  public:
+    explicit worker_attributes(Generator const& generator) : generator_(generator)
+    {
+    }
+
+    void operator()(unsigned worker, thread_attributes& attrs) const
+    {
+      generator_(worker, attrs);
+    }
+  };
+
+  /// \b Returns: a @c worker_attributes calling @c generator.
+  template <class Generator>
+  worker_attributes<Generator> make_worker_attributes(Generator const& generator)
+  {
+    return worker_attributes<Generator>(generator);
+  }
+}
+using executors::worker_attributes;
+using executors::make_worker_attributes;
+
+namespace detail
+{
+  template <class T>
+  struct is_worker_attributes : false_type {};
+  template <class Generator>
+  struct is_worker_attributes<executors::worker_attributes<Generator> > : true_type {};
+}
+}
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif
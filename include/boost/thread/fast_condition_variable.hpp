@@ -0,0 +1,213 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_THREAD_FAST_CONDITION_VARIABLE_HPP
+#define BOOST_THREAD_FAST_CONDITION_VARIABLE_HPP
+
+#include <boost/thread/detail/config.hpp>
+#include <boost/thread/fast_mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+#if defined BOOST_THREAD_PROVIDES_FAST_MUTEX
+#include <boost/thread/detail/delete.hpp>
+#include <boost/thread/detail/move.hpp>
+#include <boost/thread/lock_types.hpp>
+#include <boost/thread/cv_status.hpp>
+#include <boost/thread/exceptions.hpp>
+#include <boost/thread/pthread/timespec.hpp>
+#include <boost/thread/thread_time.hpp>
+#if defined BOOST_THREAD_PROVIDES_INTERRUPTIONS
+#include <boost/thread/detail/thread.hpp>
+#include <boost/thread/pthread/thread_data.hpp>
+#endif
+#ifdef BOOST_THREAD_USES_CHRONO
+#include <boost/chrono/system_clocks.hpp>
+#include <boost/chrono/ceil.hpp>
+#endif
+#include <boost/throw_exception.hpp>
+#include <climits>
+#endif
+
+#include <boost/config/abi_prefix.hpp>
+
+namespace boost
+{
+#if defined BOOST_THREAD_PROVIDES_FAST_MUTEX
+  /**
+   * A condition variable for @c unique_lock<fast_mutex>, implemented on a Linux futex holding a sequence number.
+   *
+   * A waiter reads the sequence while holding the mutex and blocks until it changes. The notifications increment the
+   * sequence, and only make a system call when there are waiters. @c notify_all() wakes a single waiter and moves the
+   * other ones to the futex of the mutex, so that they are woken one by one as the mutex is unlocked instead of all
+   * contending for it at once.
+   *
+   * There is no internal mutex: the interruption of a waiting thread goes through the wait slot of the thread.
+   */
+  class fast_condition_variable
+  {
+  private:
+    detail::futex_sequence seq_;
+    /// the mutex of the waiters, to which @c notify_all() moves them.
+    atomic<detail::futex_mutex*> mutex_;
+
+#if defined BOOST_THREAD_PROVIDES_INTERRUPTIONS
+    // called by thread::interrupt() while the interrupted thread waits, wakes all the waiters.
+    static void wake_for_interruption(void* cv)
+    {
+      static_cast<fast_condition_variable*>(cv)->seq_.notify_all();
+    }
+#endif
+
+    /// Returns: false if @c abs_time has been reached, see @c detail::futex_wait_until().
+    bool do_wait_until(unique_lock<fast_mutex>& m, struct timespec const* abs_time, bool realtime)
+    {
+#if defined BOOST_THREAD_THROW_IF_PRECONDITION_NOT_SATISFIED
+      if (!m.owns_lock())
+      {
+        boost::throw_exception(condition_error(EPERM, "boost::fast_condition_variable::do_wait_until() failed precondition mutex not owned"));
+      }
+#endif
+      detail::futex_mutex& mtx = m.mutex()->m;
+      mutex_.store(&mtx, memory_order_relaxed);
+      int res;
+      {
+        detail::futex_sequence::waiter waiter(seq_);
+#if defined BOOST_THREAD_PROVIDES_INTERRUPTIONS
+        // registered after the read of the sequence: an interruption either is seen here or changes the sequence.
+        detail::wait_slot_interruption_checker check_for_interruption(this, &fast_condition_variable::wake_for_interruption);
+#endif
+        mtx.unlock();
+        res = abs_time ? seq_.wait_until(waiter, *abs_time, realtime) : seq_.wait(waiter);
+        // other waiters can have been moved to the mutex.
+        mtx.lock_contended();
+      }
+#if defined BOOST_THREAD_PROVIDES_INTERRUPTIONS
+      this_thread::interruption_point();
+#endif
+      return res != ETIMEDOUT;
+    }
+
+  public:
+    BOOST_THREAD_NO_COPYABLE(fast_condition_variable)
+
+    fast_condition_variable() :
+      mutex_(0)
+    {
+    }
+
+    void wait(unique_lock<fast_mutex>& m)
+    {
+      do_wait_until(m, 0, false);
+    }
+
+    template<typename predicate_type>
+    void wait(unique_lock<fast_mutex>& m, predicate_type pred)
+    {
+      while(!pred()) wait(m);
+    }
+
+#if defined BOOST_THREAD_USES_DATETIME
+    bool timed_wait(unique_lock<fast_mutex>& m, boost::system_time const& abs_time)
+    {
+      struct timespec const timeout = boost::detail::to_timespec(abs_time);
+      return do_wait_until(m, &timeout, true);
+    }
+    bool timed_wait(unique_lock<fast_mutex>& m, xtime const& abs_time)
+    {
+      return timed_wait(m, system_time(abs_time));
+    }
+    template<typename duration_type>
+    bool timed_wait(unique_lock<fast_mutex>& m, duration_type const& wait_duration)
+    {
+      return timed_wait(m, get_system_time()+wait_duration);
+    }
+    template<typename predicate_type>
+    bool timed_wait(unique_lock<fast_mutex>& m, boost::system_time const& abs_time, predicate_type pred)
+    {
+      while (!pred())
+      {
+        if(!timed_wait(m, abs_time))
+          return pred();
+      }
+      return true;
+    }
+    template<typename duration_type,typename predicate_type>
+    bool timed_wait(unique_lock<fast_mutex>& m, duration_type const& wait_duration, predicate_type pred)
+    {
+      return timed_wait(m, get_system_time()+wait_duration, pred);
+    }
+#endif
+
+#ifdef BOOST_THREAD_USES_CHRONO
+    template <class Duration>
+    cv_status wait_until(unique_lock<fast_mutex>& lock, const chrono::time_point<chrono::steady_clock, Duration>& t)
+    {
+      using namespace chrono;
+      // the steady_clock is CLOCK_MONOTONIC.
+      struct timespec const ts = boost::detail::to_timespec(ceil<nanoseconds>(t.time_since_epoch()));
+      do_wait_until(lock, &ts, false);
+      return steady_clock::now() < t ? cv_status::no_timeout : cv_status::timeout;
+    }
+
+    template <class Clock, class Duration>
+    cv_status wait_until(unique_lock<fast_mutex>& lock, const chrono::time_point<Clock, Duration>& t)
+    {
+      using namespace chrono;
+      steady_clock::time_point     s_now = steady_clock::now();
+      typename Clock::time_point  c_now = Clock::now();
+      wait_until(lock, s_now + ceil<nanoseconds>(t - c_now));
+      return Clock::now() < t ? cv_status::no_timeout : cv_status::timeout;
+    }
+
+    template <class Clock, class Duration, class Predicate>
+    bool wait_until(unique_lock<fast_mutex>& lock, const chrono::time_point<Clock, Duration>& t, Predicate pred)
+    {
+      while (!pred())
+      {
+        if (wait_until(lock, t) == cv_status::timeout)
+          return pred();
+      }
+      return true;
+    }
+
+    template <class Rep, class Period>
+    cv_status wait_for(unique_lock<fast_mutex>& lock, const chrono::duration<Rep, Period>& d)
+    {
+      return wait_until(lock, chrono::steady_clock::now() + d);
+    }
+
+    template <class Rep, class Period, class Predicate>
+    bool wait_for(unique_lock<fast_mutex>& lock, const chrono::duration<Rep, Period>& d, Predicate pred)
+    {
+      return wait_until(lock, chrono::steady_clock::now() + d, boost::move(pred));
+    }
+#endif
+
+    void notify_one() BOOST_NOEXCEPT
+    {
+      seq_.notify_one();
+    }
+
+    void notify_all() BOOST_NOEXCEPT
+    {
+      int const seq = seq_.advance();
+      if (!seq_.has_waiters()) return;
+      detail::futex_mutex* m = mutex_.load(memory_order_relaxed);
+      // the woken waiter locks the mutex as contended, so that its unlock wakes the next one.
+      if (m == 0 || detail::futex_cmp_requeue(seq_.word(), seq, 1, m->word(), INT_MAX) < 0)
+      {
+        detail::futex_wake(seq_.word(), INT_MAX);
+      }
+    }
+  };
+#else
+  // no futex: fast_mutex is a mutex.
+  typedef condition_variable fast_condition_variable;
+#endif
+}
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif
@@ -0,0 +1,295 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_THREAD_FAST_MUTEX_HPP
+#define BOOST_THREAD_FAST_MUTEX_HPP
+
+#include <boost/thread/detail/config.hpp>
+#include <boost/thread/detail/futex.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/lockable_traits.hpp>
+
+#if defined BOOST_THREAD_HAS_FUTEX
+#include <boost/thread/detail/delete.hpp>
+#if defined BOOST_THREAD_PROVIDES_NESTED_LOCKS
+#include <boost/thread/lock_types.hpp>
+#endif
+#include <boost/thread/pthread/timespec.hpp>
+#include <boost/thread/thread_time.hpp>
+#ifdef BOOST_THREAD_USES_CHRONO
+#include <boost/chrono/system_clocks.hpp>
+#include <boost/chrono/ceil.hpp>
+#endif
+#include <algorithm>
+#endif
+
+#include <boost/config/abi_prefix.hpp>
+
+namespace boost
+{
+#if defined BOOST_THREAD_HAS_FUTEX
+#define BOOST_THREAD_PROVIDES_FAST_MUTEX
+  namespace detail
+  {
+    /**
+     * The state of a futex based mutex: 0 when unlocked, 1 when locked without waiters, 2 when locked with waiters
+     * possibly blocked in the kernel. The unlock only makes a system call in the last state.
+     *
+     * Before blocking, a locker spins while the mutex is locked without waiters, i.e. while its owner is likely
+     * running and about to unlock it. The number of spins adapts to the number that recently succeeded.
+     */
+    class futex_mutex
+    {
+      BOOST_STATIC_CONSTANT(int, max_spins = 100);
+
+      atomic<int> state_;
+      atomic<int> spins_;
+
+      bool try_lock_spinning()
+      {
+        if (!futex_spinning_enabled()) return false;
+        int const budget = (std::min)(max_spins, 2 * spins_.load(memory_order_relaxed) + 10);
+        for (int i = 0; i < budget; ++i)
+        {
+          int c = state_.load(memory_order_relaxed);
+          if (c == 0 && state_.compare_exchange_weak(c, 1, memory_order_acquire, memory_order_relaxed))
+          {
+            int const s = spins_.load(memory_order_relaxed);
+            spins_.store(s + (i - s) / 8, memory_order_relaxed);
+            return true;
+          }
+          // the other waiters are blocked: the owner is not about to unlock.
+          if (c == 2) break;
+          cpu_relax();
+        }
+        int const s = spins_.load(memory_order_relaxed);
+        spins_.store(s + (budget - s) / 8, memory_order_relaxed);
+        return false;
+      }
+
+    public:
+      BOOST_THREAD_NO_COPYABLE(futex_mutex)
+
+      futex_mutex() : state_(0), spins_(0)
+      {
+      }
+
+      bool try_lock()
+      {
+        int c = 0;
+        return state_.compare_exchange_strong(c, 1, memory_order_acquire, memory_order_relaxed);
+      }
+
+      void lock()
+      {
+        if (try_lock() || try_lock_spinning()) return;
+        int c = state_.exchange(2, memory_order_acquire);
+        while (c != 0)
+        {
+          futex_wait(state_, 2);
+          c = state_.exchange(2, memory_order_acquire);
+        }
+      }
+
+      /// Returns: whether the mutex has been locked before @c abs_time, see @c futex_wait_until().
+      bool lock_until(struct timespec const& abs_time, bool realtime)
+      {
+        if (try_lock() || try_lock_spinning()) return true;
+        int c = state_.exchange(2, memory_order_acquire);
+        while (c != 0)
+        {
+          int const res = futex_wait_until(state_, 2, abs_time, realtime);
+          // any other error than a wake-up would be returned again by the next wait.
+          if (res != 0 && res != EINTR && res != EAGAIN)
+          {
+            return state_.exchange(2, memory_order_acquire) == 0;
+          }
+          c = state_.exchange(2, memory_order_acquire);
+        }
+        return true;
+      }
+
+      /// Effects: locks the mutex as if other threads were blocked on it, e.g. moved there by a condition variable.
+      void lock_contended()
+      {
+        while (state_.exchange(2, memory_order_acquire) != 0)
+        {
+          futex_wait(state_, 2);
+        }
+      }
+
+      /// Returns: the futex word of the mutex.
+      atomic<int>& word()
+      {
+        return state_;
+      }
+
+      void unlock()
+      {
+        if (state_.fetch_sub(1, memory_order_release) != 1)
+        {
+          state_.store(0, memory_order_release);
+          futex_wake(state_, 1);
+        }
+      }
+    };
+  }
+
+  /**
+   * A mutex implemented directly on a Linux futex, without the bookkeeping of @c pthread_mutex_t. The lock and the
+   * unlock are a single atomic operation when the mutex is not contended.
+   */
+  class fast_mutex
+  {
+  private:
+    friend class fast_condition_variable;
+    detail::futex_mutex m;
+
+  public:
+    BOOST_THREAD_NO_COPYABLE(fast_mutex)
+
+    fast_mutex()
+    {
+    }
+
+    void lock()
+    {
+      m.lock();
+    }
+
+    void unlock()
+    {
+      m.unlock();
+    }
+
+    bool try_lock()
+    {
+      return m.try_lock();
+    }
+
+#if defined BOOST_THREAD_PROVIDES_NESTED_LOCKS
+    typedef unique_lock<fast_mutex> scoped_lock;
+    typedef detail::try_lock_wrapper<fast_mutex> scoped_try_lock;
+#endif
+  };
+
+  /**
+   * A timed mutex implemented directly on a Linux futex. The timed locks wait on @c CLOCK_MONOTONIC, so that they are
+   * not affected by changes of the system clock, except @c timed_lock(system_time) which waits on @c CLOCK_REALTIME.
+   */
+  class fast_timed_mutex
+  {
+  private:
+    detail::futex_mutex m;
+
+  public:
+    BOOST_THREAD_NO_COPYABLE(fast_timed_mutex)
+
+    fast_timed_mutex()
+    {
+    }
+
+    void lock()
+    {
+      m.lock();
+    }
+
+    void unlock()
+    {
+      m.unlock();
+    }
+
+    bool try_lock()
+    {
+      return m.try_lock();
+    }
+
+#if defined BOOST_THREAD_USES_DATETIME
+    template<typename TimeDuration>
+    bool timed_lock(TimeDuration const & relative_time)
+    {
+      return timed_lock(get_system_time()+relative_time);
+    }
+    bool timed_lock(boost::xtime const & absolute_time)
+    {
+      return timed_lock(system_time(absolute_time));
+    }
+    bool timed_lock(system_time const & abs_time)
+    {
+      struct timespec const ts=boost::detail::to_timespec(abs_time);
+      return m.lock_until(ts, true);
+    }
+#endif
+#ifdef BOOST_THREAD_USES_CHRONO
+    template <class Rep, class Period>
+    bool try_lock_for(const chrono::duration<Rep, Period>& rel_time)
+    {
+      return try_lock_until(chrono::steady_clock::now() + rel_time);
+    }
+    template <class Clock, class Duration>
+    bool try_lock_until(const chrono::time_point<Clock, Duration>& t)
+    {
+      using namespace chrono;
+      steady_clock::time_point     s_now = steady_clock::now();
+      typename Clock::time_point  c_now = Clock::now();
+      return try_lock_until(s_now + ceil<nanoseconds>(t - c_now));
+    }
+    template <class Duration>
+    bool try_lock_until(const chrono::time_point<chrono::steady_clock, Duration>& t)
+    {
+      using namespace chrono;
+      typedef time_point<steady_clock, nanoseconds> nano_steady_tmpt;
+      return try_lock_until(nano_steady_tmpt(ceil<nanoseconds>(t.time_since_epoch())));
+    }
+    bool try_lock_until(const chrono::time_point<chrono::steady_clock, chrono::nanoseconds>& tp)
+    {
+      // the steady_clock is CLOCK_MONOTONIC.
+      timespec ts = boost::detail::to_timespec(tp.time_since_epoch());
+      return m.lock_until(ts, false);
+    }
+#endif
+
+#if defined BOOST_THREAD_PROVIDES_NESTED_LOCKS
+    typedef unique_lock<fast_timed_mutex> scoped_timed_lock;
+    typedef detail::try_lock_wrapper<fast_timed_mutex> scoped_try_lock;
+    typedef scoped_timed_lock scoped_lock;
+#endif
+  };
+#else
+  // no futex: the fast mutexes are the native ones.
+  typedef mutex fast_mutex;
+  typedef timed_mutex fast_timed_mutex;
+#endif
+
+  namespace sync
+  {
+#if defined BOOST_THREAD_NO_AUTO_DETECT_MUTEX_TYPES && defined BOOST_THREAD_PROVIDES_FAST_MUTEX
+    template<>
+    struct is_basic_lockable<fast_mutex>
+    {
+      BOOST_STATIC_CONSTANT(bool, value = true);
+    };
+    template<>
+    struct is_lockable<fast_mutex>
+    {
+      BOOST_STATIC_CONSTANT(bool, value = true);
+    };
+    template<>
+    struct is_basic_lockable<fast_timed_mutex>
+    {
+      BOOST_STATIC_CONSTANT(bool, value = true);
+    };
+    template<>
+    struct is_lockable<fast_timed_mutex>
+    {
+      BOOST_STATIC_CONSTANT(bool, value = true);
+    };
+#endif
+  }
+}
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif
@@ -27,23 +27,25 @@
 #include <boost/thread/lock_types.hpp>
 #include <boost/exception_ptr.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <boost/type_traits/is_fundamental.hpp>
 #include <boost/thread/detail/is_convertible.hpp>
 #include <boost/type_traits/decay.hpp>
 #include <boost/type_traits/is_void.hpp>
 #include <boost/type_traits/conditional.hpp>
+#include <boost/type_traits/aligned_storage.hpp>
+#include <boost/type_traits/alignment_of.hpp>
 #include <boost/config.hpp>
 #include <boost/throw_exception.hpp>
 #include <algorithm>
 #include <boost/function.hpp>
 #include <boost/bind.hpp>
 #include <boost/core/ref.hpp>
-#include <boost/scoped_array.hpp>
 #include <boost/enable_shared_from_this.hpp>
 #include <boost/core/enable_if.hpp>
+#include <boost/atomic.hpp>
 
-#include <list>
 #include <boost/next_prior.hpp>
 #include <vector>
 
@@ -63,6 +65,13 @@
 #include <boost/utility/result_of.hpp>
 #include <boost/thread/thread_only.hpp>
 
+#ifdef BOOST_THREAD_PROVIDES_EXECUTORS
+#include <boost/thread/cancellation.hpp>
+#include <boost/thread/executors/current_executor.hpp>
+#include <boost/thread/executors/work.hpp>
+#include <boost/thread/executors/executor_ref.hpp>
+#endif
+
 #if defined BOOST_THREAD_PROVIDES_FUTURE_WHEN_ALL_WHEN_ANY
 #include <boost/thread/csbl/tuple.hpp>
 #include <boost/thread/csbl/vector.hpp>
@@ -176,6 +185,15 @@ namespace boost
         {}
     };
 
+    class BOOST_SYMBOL_VISIBLE future_cancelled:
+        public future_error
+    {
+    public:
+        future_cancelled():
+          future_error(system::make_error_code(future_errc::cancelled))
+        {}
+    };
+
     namespace future_state
     {
         enum state { uninitialized, waiting, ready, moved, deferred };
@@ -210,19 +228,110 @@ namespace boost
             relocker& operator=(relocker const&);
         };
 
+        /////////////////////////
+        /// future_waiter_slot
+        /////////////////////////
+        // Shared by all the futures a thread is waiting for in wait_for_any(). The first shared state becoming ready
+        // publishes its index and wakes the single parked thread; the others find the slot already taken.
+        struct future_waiter_slot
+        {
+            static const std::size_t none = static_cast<std::size_t>(-1);
+
+            boost::atomic<std::size_t> first;
+            boost::mutex mtx;
+            boost::condition_variable cv;
+            bool parked;
+
+            future_waiter_slot():
+                first(none),
+                parked(false)
+            {}
+
+            void signal(std::size_t index)
+            {
+                std::size_t expected = none;
+                if (first.compare_exchange_strong(expected, index, boost::memory_order_acq_rel))
+                {
+                    boost::lock_guard<boost::mutex> lk(mtx);
+                    if (parked)
+                    {
+                        cv.notify_one();
+                    }
+                }
+            }
+
+            std::size_t wait()
+            {
+                std::size_t index = first.load(boost::memory_order_acquire);
+                if (index != none)
+                {
+                    return index;
+                }
+                boost::unique_lock<boost::mutex> lk(mtx);
+                parked = true;
+                while ((index = first.load(boost::memory_order_acquire)) == none)
+                {
+                    cv.wait(lk);
+                }
+                parked = false;
+                return index;
+            }
+
+        private:
+            future_waiter_slot(future_waiter_slot const&);
+            future_waiter_slot& operator=(future_waiter_slot const&);
+        };
+
+        // Intrusive node linking a future_waiter_slot to each shared state it waits for, so that neither
+        // registering nor signaling needs to allocate.
+        // A node with a resume function is instead unlinked when the shared state becomes ready, and the function is
+        // called once the mutex of the shared state has been released (e.g. to resume a coroutine).
+        struct future_waiter_node
+        {
+            typedef void (*resume_function)(future_waiter_node&);
+
+            future_waiter_node* prev;
+            future_waiter_node* next;
+            future_waiter_slot* slot;
+            std::size_t index;
+            resume_function resume;
+
+            future_waiter_node(future_waiter_slot* slot_, std::size_t index_):
+                prev(0), next(0), slot(slot_), index(index_), resume(0)
+            {}
+            explicit future_waiter_node(resume_function resume_):
+                prev(0), next(0), slot(0), index(0), resume(resume_)
+            {}
+        };
+
         struct shared_state_base : enable_shared_from_this<shared_state_base>
         {
-            typedef std::list<boost::condition_variable_any*> waiter_list;
+            typedef future_waiter_node* waiter_list;
             // This type should be only included conditionally if interruptions are allowed, but is included to maintain the same layout.
             typedef shared_ptr<shared_state_base> continuation_ptr_type;
 
+            // Bits of the state word. The ready bits are set once, with release semantics, while the mutex is held,
+            // so that a reader observing them with acquire semantics can access the result without locking.
+            enum state_bits
+            {
+              st_not_ready = 0,
+              st_ready_value = 1,
+              st_ready_exception = 2,
+              st_ready = st_ready_value | st_ready_exception,
+              st_has_waiters = 4,
+              st_has_continuation = 8,
+              st_cancelled = 16,
+              st_has_resumptions = 32
+            };
+
             boost::exception_ptr exception;
-            bool done;
+            boost::atomic<unsigned> state_;
             bool is_deferred_;
             launch policy_;
             bool is_constructed;
             mutable boost::mutex mutex;
-            boost::condition_variable waiters;
+            // Created on demand by the first thread that needs to block on this shared state.
+            boost::scoped_ptr<boost::condition_variable> waiters;
             waiter_list external_waiters;
             boost::function<void()> callback;
             // This declaration should be only included conditionally if interruptions are allowed, but is included to maintain the same layout.
@@ -236,16 +345,41 @@ namespace boost
             }
 
             shared_state_base():
-                done(false),
+                state_(st_not_ready),
                 is_deferred_(false),
                 policy_(launch::none),
                 is_constructed(false),
+                external_waiters(0),
                 thread_was_interrupted(false),
                 continuation_ptr()
             {}
             virtual ~shared_state_base()
             {}
 
+            bool is_done() const BOOST_NOEXCEPT
+            {
+              return (state_.load(boost::memory_order_acquire) & st_ready) != 0;
+            }
+            bool is_done_with_value() const BOOST_NOEXCEPT
+            {
+              return (state_.load(boost::memory_order_acquire) & st_ready_value) != 0;
+            }
+            bool is_cancelled() const BOOST_NOEXCEPT
+            {
+              return (state_.load(boost::memory_order_acquire) & st_cancelled) != 0;
+            }
+
+            // Must be called with the mutex locked.
+            boost::condition_variable& waiters_cv()
+            {
+              if (! waiters)
+              {
+                waiters.reset(new boost::condition_variable());
+                state_.fetch_or(st_has_waiters, boost::memory_order_relaxed);
+              }
+              return *waiters;
+            }
+
             void set_deferred()
             {
               is_deferred_ = true;
@@ -263,17 +397,107 @@ namespace boost
               policy_ = launch::executor;
             }
 #endif
-            waiter_list::iterator register_external_waiter(boost::condition_variable_any& cv)
+            void register_external_waiter(future_waiter_node& node)
+            {
+                boost::unique_lock<boost::mutex> lock(mutex);
+                do_callback(lock);
+                node.prev = 0;
+                node.next = external_waiters;
+                if (external_waiters)
+                {
+                    external_waiters->prev = &node;
+                }
+                external_waiters = &node;
+                if (is_done())
+                {
+                    node.slot->signal(node.index);
+                }
+            }
+
+            // Links a node whose resume function will be called once this state is ready, executing the state first if
+            // it is deferred. Returns false, without linking the node, if the state is already ready.
+            bool register_resumption(future_waiter_node& node)
             {
                 boost::unique_lock<boost::mutex> lock(mutex);
                 do_callback(lock);
-                return external_waiters.insert(external_waiters.end(),&cv);
+                if (is_deferred_)
+                {
+                    wait_internal(lock, false);
+                }
+                if (is_done())
+                {
+                    return false;
+                }
+                node.prev = 0;
+                node.next = external_waiters;
+                if (external_waiters)
+                {
+                    external_waiters->prev = &node;
+                }
+                external_waiters = &node;
+                state_.fetch_or(st_has_resumptions, boost::memory_order_relaxed);
+                return true;
+            }
+
+            // Unlinks and returns the nodes linked by register_resumption(), if this state is ready.
+            future_waiter_node* take_resumptions()
+            {
+                unsigned const st = state_.load(boost::memory_order_acquire);
+                if ((st & st_has_resumptions) == 0 || (st & st_ready) == 0)
+                {
+                    return 0;
+                }
+                boost::lock_guard<boost::mutex> lock(mutex);
+                state_.fetch_and(~unsigned(st_has_resumptions), boost::memory_order_relaxed);
+                future_waiter_node* resumptions = 0;
+                for(future_waiter_node* node=external_waiters; node!=0; )
+                {
+                    future_waiter_node* const next = node->next;
+                    if (node->resume)
+                    {
+                        unlink_external_waiter(*node);
+                        node->next = resumptions;
+                        resumptions = node;
+                    }
+                    node = next;
+                }
+                return resumptions;
+            }
+
+            // Doesn't access the shared state the nodes were linked to, which a resumed node can destroy.
+            static void run_resumptions(future_waiter_node* resumptions)
+            {
+                while (resumptions)
+                {
+                    future_waiter_node& node = *resumptions;
+                    resumptions = node.next;
+                    node.next = 0;
+                    node.resume(node);
+                }
             }
 
-            void remove_external_waiter(waiter_list::iterator it)
+            void remove_external_waiter(future_waiter_node& node)
             {
                 boost::lock_guard<boost::mutex> lock(mutex);
-                external_waiters.erase(it);
+                unlink_external_waiter(node);
+            }
+
+            // Must be called with the mutex locked.
+            void unlink_external_waiter(future_waiter_node& node)
+            {
+                if (node.prev)
+                {
+                    node.prev->next = node.next;
+                }
+                else
+                {
+                    external_waiters = node.next;
+                }
+                if (node.next)
+                {
+                    node.next->prev = node.prev;
+                }
+                node.prev = node.next = 0;
             }
 
 #if defined BOOST_THREAD_PROVIDES_FUTURE_CONTINUATION
@@ -282,6 +506,7 @@ namespace boost
                 if (continuation_ptr) {
                   continuation_ptr_type this_continuation_ptr = continuation_ptr;
                   continuation_ptr.reset();
+                  state_.fetch_and(~unsigned(st_has_continuation), boost::memory_order_relaxed);
                   this_continuation_ptr->launch_continuation(lock);
                   //if (! lock.owns_lock())
                   //  lock.lock();
@@ -296,19 +521,34 @@ namespace boost
             void set_continuation_ptr(continuation_ptr_type continuation, boost::unique_lock<boost::mutex>& lock)
             {
               continuation_ptr= continuation;
-              if (done) {
+              state_.fetch_or(st_has_continuation, boost::memory_order_relaxed);
+              if (is_done()) {
                 do_continuation(lock);
               }
             }
 #endif
+            // Once the ready bits are published, a reader that doesn't lock the mutex can release its reference to
+            // this shared state. The caller must therefore own a reference, or keep this state alive by other means
+            // as the async states joining their thread do, until the mutex has been unlocked.
             void mark_finished_internal(boost::unique_lock<boost::mutex>& lock)
             {
-                done=true;
-                waiters.notify_all();
-                for(waiter_list::const_iterator it=external_waiters.begin(),
-                        end=external_waiters.end();it!=end;++it)
+                unsigned const ready = (exception
+#if defined BOOST_THREAD_PROVIDES_INTERRUPTIONS
+                    || thread_was_interrupted
+#endif
+                    ) ? st_ready_exception : st_ready_value;
+                unsigned const previous = state_.fetch_or(ready, boost::memory_order_release);
+                if (previous & st_has_waiters)
+                {
+                    waiters->notify_all();
+                }
+                for(future_waiter_node* node=external_waiters; node!=0; node=node->next)
                 {
-                    (*it)->notify_all();
+                    // the nodes linked by register_resumption() are left to resume_waiters().
+                    if (! node->resume)
+                    {
+                        node->slot->signal(node->index);
+                    }
                 }
                 do_continuation(lock);
             }
@@ -320,7 +560,7 @@ namespace boost
 
             void do_callback(boost::unique_lock<boost::mutex>& lock)
             {
-                if(callback && !done)
+                if(callback && !is_done())
                 {
                     boost::function<void()> local_callback=callback;
                     relocker relock(lock);
@@ -328,10 +568,47 @@ namespace boost
                 }
             }
 
-            void wait_internal(boost::unique_lock<boost::mutex> &lk, bool rethrow=true)
+#ifdef BOOST_THREAD_PROVIDES_EXECUTORS
+            // Runs the closures pending in the executor installed on this thread, if any, until this shared state is
+            // ready or there is no more work to do, in which case the caller parks. The worker of a polling executor,
+            // e.g. a shard, never parks: the closure making this state ready can be one it has still to poll.
+            // The closures run nested in the caller of get() or wait(): one needing a lock the caller holds deadlocks.
+            void help_while_waiting(boost::unique_lock<boost::mutex> &lk)
+            {
+              current_executor_entry* const current = get_current_executor();
+              if (current == 0) return;
+              current_executor_entry* polling = current;
+              while (polling != 0 && ! polling->polling)
+              {
+                polling = polling->previous;
+              }
+              while(!is_done())
+              {
+                bool executed;
+                {
+                  relocker relock(lk);
+                  executed = current->try_executing_one(current->executor);
+                  if (polling != 0 && polling != current)
+                  {
+                    // the executor installed by get(ex) or wait(ex) on top of the one of the worker.
+                    executed = polling->try_executing_one(polling->executor) || executed;
+                  }
+                  if (!executed && polling != 0)
+                  {
+                    this_thread::yield();
+                  }
+                }
+                if (!executed && polling == 0) return;
+              }
+            }
+#endif
+
+            // Only the public get() and wait() help the executor installed on this thread: the internal waits can be
+            // done with locks held, by the library or by its caller, that the closures run meanwhile could need.
+            void wait_internal(boost::unique_lock<boost::mutex> &lk, bool rethrow=true, bool help=false)
             {
               do_callback(lk);
-              //if (!done) // fixme why this doesn't work?
+              //if (!is_done()) // fixme why this doesn't work?
               {
                 if (is_deferred_)
                 {
@@ -341,9 +618,21 @@ namespace boost
                 }
                 else
                 {
-                  while(!done)
+#ifdef BOOST_THREAD_PROVIDES_EXECUTORS
+                  if (help)
                   {
-                      waiters.wait(lk);
+                    help_while_waiting(lk);
+                  }
+#else
+                  (void)help;
+#endif
+                  if(!is_done())
+                  {
+                      boost::condition_variable& cv = waiters_cv();
+                      while(!is_done())
+                      {
+                          cv.wait(lk);
+                      }
                   }
 #if defined BOOST_THREAD_PROVIDES_INTERRUPTIONS
                   if(rethrow && thread_was_interrupted)
@@ -359,24 +648,47 @@ namespace boost
               }
             }
 
+            // Rethrows the stored exception, if any, of a ready shared state. Doesn't need the mutex.
+            void rethrow_if_exceptional_ready() const
+            {
+#if defined BOOST_THREAD_PROVIDES_INTERRUPTIONS
+                if(thread_was_interrupted)
+                {
+                    throw boost::thread_interrupted();
+                }
+#endif
+                if(exception)
+                {
+                    boost::rethrow_exception(exception);
+                }
+            }
+
             virtual void wait(bool rethrow=true)
             {
+                unsigned const st = state_.load(boost::memory_order_acquire);
+                if (st & st_ready)
+                {
+                  if (rethrow && (st & st_ready_exception)) rethrow_if_exceptional_ready();
+                  return;
+                }
                 boost::unique_lock<boost::mutex> lock(mutex);
-                wait_internal(lock, rethrow);
+                wait_internal(lock, rethrow, true);
             }
 
 #if defined BOOST_THREAD_USES_DATETIME
             bool timed_wait_until(boost::system_time const& target_time)
             {
+                if (is_done())
+                    return true;
                 boost::unique_lock<boost::mutex> lock(mutex);
                 if (is_deferred_)
                     return false;
 
                 do_callback(lock);
-                while(!done)
+                while(!is_done())
                 {
-                    bool const success=waiters.timed_wait(lock,target_time);
-                    if(!success && !done)
+                    bool const success=waiters_cv().timed_wait(lock,target_time);
+                    if(!success && !is_done())
                     {
                         return false;
                     }
@@ -390,14 +702,16 @@ namespace boost
             future_status
             wait_until(const chrono::time_point<Clock, Duration>& abs_time)
             {
+              if (is_done())
+                  return future_status::ready;
               boost::unique_lock<boost::mutex> lock(mutex);
               if (is_deferred_)
                   return future_status::deferred;
               do_callback(lock);
-              while(!done)
+              while(!is_done())
               {
-                  cv_status const st=waiters.wait_until(lock,abs_time);
-                  if(st==cv_status::timeout && !done)
+                  cv_status const st=waiters_cv().wait_until(lock,abs_time);
+                  if(st==cv_status::timeout && !is_done())
                   {
                     return future_status::timeout;
                   }
@@ -417,6 +731,16 @@ namespace boost
                 mark_exceptional_finish_internal(boost::current_exception(), lock);
             }
 
+            // Completes the shared state with a future_cancelled exception without having invoked the associated task.
+            void mark_cancelled_finish()
+            {
+                boost::unique_lock<boost::mutex> lock(mutex);
+                if (is_done()) return;
+                exception=boost::copy_exception(future_cancelled());
+                state_.fetch_or(st_cancelled, boost::memory_order_relaxed);
+                mark_finished_internal(lock);
+            }
+
 #if defined BOOST_THREAD_PROVIDES_INTERRUPTIONS
             void mark_interrupted_finish()
             {
@@ -452,40 +776,22 @@ namespace boost
 
             bool has_value() const
             {
-                boost::lock_guard<boost::mutex> lock(mutex);
-                return done && !(exception
-#if defined BOOST_THREAD_PROVIDES_INTERRUPTIONS
-                    || thread_was_interrupted
-#endif
-                );
+                return is_done_with_value();
             }
 
             bool has_value(unique_lock<boost::mutex>& )  const
             {
-                return done && !(exception
-#if defined BOOST_THREAD_PROVIDES_INTERRUPTIONS
-                    || thread_was_interrupted
-#endif
-                );
+                return is_done_with_value();
             }
 
             bool has_exception()  const
             {
-                boost::lock_guard<boost::mutex> lock(mutex);
-                return done && (exception
-#if defined BOOST_THREAD_PROVIDES_INTERRUPTIONS
-                    || thread_was_interrupted
-#endif
-                    );
+                return (state_.load(boost::memory_order_acquire) & st_ready_exception) != 0;
             }
 
             bool has_exception(unique_lock<boost::mutex>&) const
             {
-                return done && (exception
-#if defined BOOST_THREAD_PROVIDES_INTERRUPTIONS
-                    || thread_was_interrupted
-#endif
-                    );
+                return has_exception();
             }
 
             bool is_deferred(boost::lock_guard<boost::mutex>&)  const {
@@ -499,8 +805,7 @@ namespace boost
 
             future_state::state get_state() const
             {
-                boost::lock_guard<boost::mutex> guard(mutex);
-                if(!done)
+                if(!is_done())
                 {
                     return future_state::waiting;
                 }
@@ -536,15 +841,103 @@ namespace boost
 
             virtual void execute(boost::unique_lock<boost::mutex>&) {}
 
+            // Returns whether this state is deferred and has not been executed yet. In this case parent is set to the
+            // deferred state that must be executed before this one, if any.
+            virtual bool pending_deferred(shared_ptr<shared_state_base>&)
+            {
+                boost::lock_guard<boost::mutex> lk(mutex);
+                return is_deferred_;
+            }
+
         private:
             shared_state_base(shared_state_base const&);
             shared_state_base& operator=(shared_state_base const&);
         };
 
+        // Resumes the coroutines that were awaiting st when it was made ready. It is called without the mutex of st,
+        // once the member function making st ready has returned, by a caller owning a reference to st: a resumed
+        // coroutine can release all the other references, and st is then destroyed outside of its own functions.
+        inline void resume_waiters(shared_state_base& st)
+        {
+            shared_state_base::run_resumptions(st.take_resumptions());
+        }
+
+        // Executes the chain of deferred states st depends on, innermost first, and then st itself, iteratively
+        // instead of through one nested wait per stage. This is not a fusion of the stages: each one keeps its own
+        // shared state, as each continuation receives the future of its parent. The chain is walked once; the first
+        // 16 states are kept on the stack, so that only longer chains allocate.
+        inline void execute_deferred_chain(shared_ptr<shared_state_base> const& st)
+        {
+            static const std::size_t deferred_chain_inline = 16;
+            // the pending states, from st to the innermost one.
+            shared_ptr<shared_state_base> inline_chain[deferred_chain_inline];
+            std::vector<shared_ptr<shared_state_base> > chain;
+            std::size_t n = 0;
+            shared_ptr<shared_state_base> p = st;
+            while (p)
+            {
+                shared_ptr<shared_state_base> parent;
+                if (! p->pending_deferred(parent)) break;
+                if (n < deferred_chain_inline) inline_chain[n].swap(p);
+                else chain.push_back(p);
+                ++n;
+                p.swap(parent);
+            }
+            while (n > 0)
+            {
+                --n;
+                shared_ptr<shared_state_base>& q = n < deferred_chain_inline ? inline_chain[n] : chain.back();
+                boost::unique_lock<boost::mutex> lk(q->mutex);
+                q->wait_internal(lk, false);
+                lk.unlock();
+                if (n < deferred_chain_inline) q.reset();
+                else chain.pop_back();
+            }
+        }
+
+        // In place storage for the value of a shared state, so that the value lives in the same allocation as the state.
+        template<typename T>
+        class future_value_storage
+        {
+            typename aligned_storage<sizeof(T), alignment_of<T>::value>::type data_;
+            bool constructed_;
+        public:
+            future_value_storage():
+                constructed_(false)
+            {}
+            ~future_value_storage()
+            {
+                reset();
+            }
+            void* address()
+            {
+                return &data_;
+            }
+            void set_constructed()
+            {
+                constructed_=true;
+            }
+            void reset()
+            {
+                if(constructed_)
+                {
+                    constructed_=false;
+                    static_cast<T*>(address())->~T();
+                }
+            }
+            T& operator*()
+            {
+                return *static_cast<T*>(address());
+            }
+        private:
+            future_value_storage(future_value_storage const&);
+            future_value_storage& operator=(future_value_storage const&);
+        };
+
         template<typename T>
         struct future_traits
         {
-          typedef boost::scoped_ptr<T> storage_type;
+          typedef future_value_storage<T> storage_type;
           struct dummy;
 #ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
           typedef T const& source_reference_type;
@@ -569,16 +962,20 @@ namespace boost
 
             static void init(storage_type& storage,source_reference_type t)
             {
-                storage.reset(new T(t));
+                storage.reset();
+                ::new(storage.address()) T(t);
+                storage.set_constructed();
             }
 
             static void init(storage_type& storage,rvalue_source_type t)
             {
+              storage.reset();
 #if ! defined  BOOST_NO_CXX11_RVALUE_REFERENCES
-              storage.reset(new T(boost::forward<T>(t)));
+              ::new(storage.address()) T(boost::forward<T>(t));
 #else
-              storage.reset(new T(static_cast<rvalue_source_type>(t)));
+              ::new(storage.address()) T(static_cast<rvalue_source_type>(t));
 #endif
+              storage.set_constructed();
             }
 
             static void cleanup(storage_type& storage)
@@ -641,7 +1038,7 @@ namespace boost
             storage_type result;
 
             shared_state():
-                result(0)
+                result()
             {}
 
             ~shared_state()
@@ -682,15 +1079,25 @@ namespace boost
 
             virtual move_dest_type get()
             {
+                if(this->is_done())
+                {
+                    this->rethrow_if_exceptional_ready();
+                    return boost::move(*result);
+                }
                 boost::unique_lock<boost::mutex> lock(mutex);
-                wait_internal(lock);
+                wait_internal(lock, true, true);
                 return boost::move(*result);
             }
 
             virtual shared_future_get_result_type get_sh()
             {
+                if(this->is_done())
+                {
+                    this->rethrow_if_exceptional_ready();
+                    return *result;
+                }
                 boost::unique_lock<boost::mutex> lock(mutex);
-                wait_internal(lock);
+                wait_internal(lock, true, true);
                 return *result;
             }
 
@@ -702,8 +1109,7 @@ namespace boost
               {
                   throw_exception(promise_already_satisfied());
               }
-              //future_traits<T>::init(result,result_);
-              result.reset(new T(result_));
+              future_traits<T>::init(result,result_);
 
               this->is_constructed = true;
               detail::make_ready_at_thread_exit(shared_from_this());
@@ -714,8 +1120,11 @@ namespace boost
               unique_lock<boost::mutex> lk(this->mutex);
               if (this->has_value(lk))
                   throw_exception(promise_already_satisfied());
-              result.reset(new T(boost::move(result_)));
-              //future_traits<T>::init(result,static_cast<rvalue_source_type>(result_));
+#if ! defined  BOOST_NO_CXX11_RVALUE_REFERENCES
+              future_traits<T>::init(result,boost::forward<T>(result_));
+#else
+              future_traits<T>::init(result,static_cast<rvalue_source_type>(result_));
+#endif
               this->is_constructed = true;
               detail::make_ready_at_thread_exit(shared_from_this());
             }
@@ -760,15 +1169,25 @@ namespace boost
 
             virtual T& get()
             {
+                if(this->is_done())
+                {
+                    this->rethrow_if_exceptional_ready();
+                    return *result;
+                }
                 boost::unique_lock<boost::mutex> lock(mutex);
-                wait_internal(lock);
+                wait_internal(lock, true, true);
                 return *result;
             }
 
             virtual T& get_sh()
             {
+                if(this->is_done())
+                {
+                    this->rethrow_if_exceptional_ready();
+                    return *result;
+                }
                 boost::unique_lock<boost::mutex> lock(mutex);
-                wait_internal(lock);
+                wait_internal(lock, true, true);
                 return *result;
             }
 
@@ -810,14 +1229,24 @@ namespace boost
 
             virtual void get()
             {
+                if(this->is_done())
+                {
+                    this->rethrow_if_exceptional_ready();
+                    return;
+                }
                 boost::unique_lock<boost::mutex> lock(mutex);
-                this->wait_internal(lock);
+                this->wait_internal(lock, true, true);
             }
 
             virtual void get_sh()
             {
+                if(this->is_done())
+                {
+                    this->rethrow_if_exceptional_ready();
+                    return;
+                }
                 boost::unique_lock<boost::mutex> lock(mutex);
-                this->wait_internal(lock);
+                this->wait_internal(lock, true, true);
             }
 
             void set_value_at_thread_exit()
@@ -835,6 +1264,17 @@ namespace boost
             shared_state& operator=(shared_state const&);
         };
 
+        // The async thread of a state can't resume the coroutines awaiting it: a resumed coroutine can release the last
+        // reference to the state, whose destructor joins that thread. They are resumed by a new thread instead.
+        inline void resume_waiters_on_new_thread(shared_state_base& st)
+        {
+            future_waiter_node* const resumptions = st.take_resumptions();
+            if (resumptions)
+            {
+                boost::thread(&shared_state_base::run_resumptions, resumptions).detach();
+            }
+        }
+
         /////////////////////////
         /// future_async_shared_state_base
         /////////////////////////
@@ -846,7 +1286,16 @@ namespace boost
           boost::thread thr_;
           void join()
           {
-              if (thr_.joinable()) thr_.join();
+              boost::thread th;
+              {
+                  // thr_ is assigned by launch_continuation() while waiters can already be joining it.
+                  boost::lock_guard<boost::mutex> lk(this->mutex);
+                  th = boost::move(thr_);
+              }
+              if (th.joinable())
+              {
+                  th.join();
+              }
           }
         public:
           future_async_shared_state_base()
@@ -901,6 +1350,7 @@ namespace boost
             {
               that->mark_exceptional_finish();
             }
+            resume_waiters_on_new_thread(*that);
           }
         };
 
@@ -932,6 +1382,7 @@ namespace boost
             {
               that->mark_exceptional_finish();
             }
+            resume_waiters_on_new_thread(*that);
           }
         };
 
@@ -962,6 +1413,7 @@ namespace boost
             {
               that->mark_exceptional_finish();
             }
+            resume_waiters_on_new_thread(*that);
           }
         };
 
@@ -1063,62 +1515,30 @@ namespace boost
 //        };
         class future_waiter
         {
-            struct registered_waiter;
             typedef std::vector<int>::size_type count_type;
 
             struct registered_waiter
             {
                 boost::shared_ptr<detail::shared_state_base> future_;
-                detail::shared_state_base::waiter_list::iterator wait_iterator;
-                count_type index;
+                future_waiter_node node;
 
                 registered_waiter(boost::shared_ptr<detail::shared_state_base> const& a_future,
-                                  detail::shared_state_base::waiter_list::iterator wait_iterator_,
+                                  future_waiter_slot* slot,
                                   count_type index_):
-                    future_(a_future),wait_iterator(wait_iterator_),index(index_)
+                    future_(a_future),node(slot, index_)
                 {}
             };
 
-            struct all_futures_lock
-            {
-#ifdef _MANAGED
-                   typedef std::ptrdiff_t count_type_portable;
-#else
-                   typedef count_type count_type_portable;
-#endif
-                   count_type_portable count;
-                   boost::scoped_array<boost::unique_lock<boost::mutex> > locks;
-
-                all_futures_lock(std::vector<registered_waiter>& futures):
-                    count(futures.size()),locks(new boost::unique_lock<boost::mutex>[count])
-                {
-                    for(count_type_portable i=0;i<count;++i)
-                    {
-                        locks[i]=BOOST_THREAD_MAKE_RV_REF(boost::unique_lock<boost::mutex>(futures[i].future_->mutex));
-                    }
-                }
-
-                void lock()
-                {
-                    boost::lock(locks.get(),locks.get()+count);
-                }
-
-                void unlock()
-                {
-                    for(count_type_portable i=0;i<count;++i)
-                    {
-                        locks[i].unlock();
-                    }
-                }
-            };
-
-            boost::condition_variable_any cv;
+            future_waiter_slot slot;
             std::vector<registered_waiter> futures;
             count_type future_count;
+            // Number of futures already linked to the slot.
+            count_type registered;
 
         public:
             future_waiter():
-                future_count(0)
+                future_count(0),
+                registered(0)
             {}
 
             template<typename F>
@@ -1126,13 +1546,7 @@ namespace boost
             {
                 if(f.future_)
                 {
-                  registered_waiter waiter(f.future_,f.future_->register_external_waiter(cv),future_count);
-                  try {
-                      futures.push_back(waiter);
-                  } catch(...) {
-                    f.future_->remove_external_waiter(waiter.wait_iterator);
-                    throw;
-                  }
+                  futures.push_back(registered_waiter(f.future_,&slot,future_count));
                 }
                 ++future_count;
             }
@@ -1147,25 +1561,24 @@ namespace boost
 
             count_type wait()
             {
-                all_futures_lock lk(futures);
-                for(;;)
+                // The nodes are linked only once all the futures have been added, as their addresses must be stable.
+                for(; registered<futures.size(); ++registered)
                 {
-                    for(count_type i=0;i<futures.size();++i)
+                    futures[registered].future_->register_external_waiter(futures[registered].node);
+                    if (slot.first.load(boost::memory_order_relaxed) != future_waiter_slot::none)
                     {
-                        if(futures[i].future_->done)
-                        {
-                            return futures[i].index;
-                        }
+                        ++registered;
+                        break;
                     }
-                    cv.wait(lk);
                 }
+                return slot.wait();
             }
 
             ~future_waiter()
             {
-                for(count_type i=0;i<futures.size();++i)
+                for(count_type i=0;i<registered;++i)
                 {
-                    futures[i].future_->remove_external_waiter(futures[i].wait_iterator);
+                    futures[i].future_->remove_external_waiter(futures[i].node);
                 }
             }
 
@@ -1441,6 +1854,16 @@ namespace boost
             future_->wait(false);
         }
 
+#ifdef BOOST_THREAD_PROVIDES_EXECUTORS
+        // Runs the closures pending in ex while waiting. EXTENSION
+        template <typename Executor>
+        void wait(Executor& ex) const
+        {
+            current_executor_guard<Executor> guard(ex);
+            wait();
+        }
+#endif
+
 #if defined BOOST_THREAD_USES_DATETIME
         template<typename Duration>
         bool timed_wait(Duration const& rel_time) const
@@ -1635,6 +2058,16 @@ namespace boost
             return fut_->get();
         }
 
+#ifdef BOOST_THREAD_PROVIDES_EXECUTORS
+        // Runs the closures pending in ex while waiting. EXTENSION
+        template <typename Executor>
+        move_dest_type get(Executor& ex)
+        {
+            current_executor_guard<Executor> guard(ex);
+            return get();
+        }
+#endif
+
         template <typename R2>
         typename boost::disable_if< is_void<R2>, move_dest_type>::type
         get_or(BOOST_THREAD_RV_REF(R2) v)
@@ -1695,6 +2128,22 @@ namespace boost
         template<typename F>
         inline BOOST_THREAD_FUTURE<typename boost::result_of<F(BOOST_THREAD_FUTURE)>::type>
         then(launch policy, BOOST_THREAD_FWD_REF(F) func);  // EXTENSION
+#if defined BOOST_THREAD_PROVIDES_FUTURE_CTOR_ALLOCATORS
+        template<typename Allocator, typename F>
+        inline BOOST_THREAD_FUTURE<typename boost::result_of<F(BOOST_THREAD_FUTURE)>::type>
+        then(boost::allocator_arg_t, Allocator const& a, BOOST_THREAD_FWD_REF(F) func);  // EXTENSION
+        template<typename Allocator, typename F>
+        inline BOOST_THREAD_FUTURE<typename boost::result_of<F(BOOST_THREAD_FUTURE)>::type>
+        then(boost::allocator_arg_t, Allocator const& a, launch policy, BOOST_THREAD_FWD_REF(F) func);  // EXTENSION
+#endif
+#ifdef BOOST_THREAD_PROVIDES_EXECUTORS
+        template<typename Ex, typename F>
+        inline BOOST_THREAD_FUTURE<typename boost::result_of<F(BOOST_THREAD_FUTURE)>::type>
+        then(Ex& ex, BOOST_THREAD_FWD_REF(F) func);  // EXTENSION
+        template<typename Ex, typename F>
+        inline BOOST_THREAD_FUTURE<typename boost::result_of<F(BOOST_THREAD_FUTURE)>::type>
+        then(Ex& ex, cancellation_token const& token, BOOST_THREAD_FWD_REF(F) func);  // EXTENSION
+#endif
 
         template <typename R2>
         inline typename boost::disable_if< is_void<R2>, BOOST_THREAD_FUTURE<R> >::type
@@ -1993,6 +2442,16 @@ namespace boost
             return this->future_->get_sh();
         }
 
+#ifdef BOOST_THREAD_PROVIDES_EXECUTORS
+        // Runs the closures pending in ex while waiting. EXTENSION
+        template <typename Executor>
+        typename detail::shared_state<R>::shared_future_get_result_type get(Executor& ex)
+        {
+            current_executor_guard<Executor> guard(ex);
+            return get();
+        }
+#endif
+
         template <typename R2>
         typename boost::disable_if< is_void<R2>, typename detail::shared_state<R>::shared_future_get_result_type>::type
         get_or(BOOST_THREAD_RV_REF(R2) v) // EXTENSION
@@ -2026,6 +2485,22 @@ namespace boost
         template<typename F>
         inline BOOST_THREAD_FUTURE<typename boost::result_of<F(shared_future)>::type>
         then(launch policy, BOOST_THREAD_FWD_REF(F) func); // EXTENSION
+#if defined BOOST_THREAD_PROVIDES_FUTURE_CTOR_ALLOCATORS
+        template<typename Allocator, typename F>
+        inline BOOST_THREAD_FUTURE<typename boost::result_of<F(shared_future)>::type>
+        then(boost::allocator_arg_t, Allocator const& a, BOOST_THREAD_FWD_REF(F) func);  // EXTENSION
+        template<typename Allocator, typename F>
+        inline BOOST_THREAD_FUTURE<typename boost::result_of<F(shared_future)>::type>
+        then(boost::allocator_arg_t, Allocator const& a, launch policy, BOOST_THREAD_FWD_REF(F) func);  // EXTENSION
+#endif
+#ifdef BOOST_THREAD_PROVIDES_EXECUTORS
+        template<typename Ex, typename F>
+        inline BOOST_THREAD_FUTURE<typename boost::result_of<F(shared_future)>::type>
+        then(Ex& ex, BOOST_THREAD_FWD_REF(F) func);  // EXTENSION
+        template<typename Ex, typename F>
+        inline BOOST_THREAD_FUTURE<typename boost::result_of<F(shared_future)>::type>
+        then(Ex& ex, cancellation_token const& token, BOOST_THREAD_FWD_REF(F) func);  // EXTENSION
+#endif
 #endif
 //#if defined BOOST_THREAD_PROVIDES_FUTURE_UNWRAP
 //        inline
@@ -2065,7 +2540,7 @@ namespace boost
           if(!atomic_load(&future_))
             {
                 future_ptr blank;
-                atomic_compare_exchange(&future_,&blank,future_ptr(new detail::shared_state<R>));
+                atomic_compare_exchange(&future_,&blank,boost::make_shared<detail::shared_state<R> >());
             }
 #include <boost/detail/atomic_redef_macros.hpp>
 #endif
@@ -2077,11 +2552,7 @@ namespace boost
         template <class Allocator>
         promise(boost::allocator_arg_t, Allocator a)
         {
-          typedef typename Allocator::template rebind<detail::shared_state<R> >::other A2;
-          A2 a2(a);
-          typedef thread_detail::allocator_destructor<A2> D;
-
-          future_ = future_ptr(::new(a2.allocate(1)) detail::shared_state<R>(), D(a2, 1) );
+          future_ = boost::allocate_shared<detail::shared_state<R> >(a);
           future_obtained = false;
         }
 #endif
@@ -2089,7 +2560,7 @@ namespace boost
 #if defined BOOST_THREAD_PROVIDES_PROMISE_LAZY
             future_(),
 #else
-            future_(new detail::shared_state<R>()),
+            future_(boost::make_shared<detail::shared_state<R> >()),
 #endif
             future_obtained(false)
         {}
@@ -2100,9 +2571,11 @@ namespace boost
             {
                 boost::unique_lock<boost::mutex> lock(future_->mutex);
 
-                if(!future_->done && !future_->is_constructed)
+                if(!future_->is_done() && !future_->is_constructed)
                 {
                     future_->mark_exceptional_finish_internal(boost::copy_exception(broken_promise()), lock);
+                    lock.unlock();
+                    detail::resume_waiters(*future_);
                 }
             }
         }
@@ -2149,11 +2622,13 @@ namespace boost
         {
             lazy_init();
             boost::unique_lock<boost::mutex> lock(future_->mutex);
-            if(future_->done)
+            if(future_->is_done())
             {
                 boost::throw_exception(promise_already_satisfied());
             }
             future_->mark_finished_with_result_internal(r, lock);
+            lock.unlock();
+            detail::resume_waiters(*future_);
         }
 
 //         void set_value(R && r);
@@ -2161,7 +2636,7 @@ namespace boost
         {
             lazy_init();
             boost::unique_lock<boost::mutex> lock(future_->mutex);
-            if(future_->done)
+            if(future_->is_done())
             {
                 boost::throw_exception(promise_already_satisfied());
             }
@@ -2170,17 +2645,21 @@ namespace boost
 #else
             future_->mark_finished_with_result_internal(static_cast<typename detail::future_traits<R>::rvalue_source_type>(r), lock);
 #endif
+            lock.unlock();
+            detail::resume_waiters(*future_);
         }
 
         void set_exception(boost::exception_ptr p)
         {
             lazy_init();
             boost::unique_lock<boost::mutex> lock(future_->mutex);
-            if(future_->done)
+            if(future_->is_done())
             {
                 boost::throw_exception(promise_already_satisfied());
             }
             future_->mark_exceptional_finish_internal(p, lock);
+            lock.unlock();
+            detail::resume_waiters(*future_);
         }
         template <typename E>
         void set_exception(E ex)
@@ -2243,7 +2722,7 @@ namespace boost
             if(!atomic_load(&future_))
             {
                 future_ptr blank;
-                atomic_compare_exchange(&future_,&blank,future_ptr(new detail::shared_state<R&>));
+                atomic_compare_exchange(&future_,&blank,boost::make_shared<detail::shared_state<R&> >());
             }
 #include <boost/detail/atomic_redef_macros.hpp>
 #endif
@@ -2255,11 +2734,7 @@ namespace boost
         template <class Allocator>
         promise(boost::allocator_arg_t, Allocator a)
         {
-          typedef typename Allocator::template rebind<detail::shared_state<R&> >::other A2;
-          A2 a2(a);
-          typedef thread_detail::allocator_destructor<A2> D;
-
-          future_ = future_ptr(::new(a2.allocate(1)) detail::shared_state<R&>(), D(a2, 1) );
+          future_ = boost::allocate_shared<detail::shared_state<R&> >(a);
           future_obtained = false;
         }
 #endif
@@ -2267,7 +2742,7 @@ namespace boost
 #if defined BOOST_THREAD_PROVIDES_PROMISE_LAZY
             future_(),
 #else
-            future_(new detail::shared_state<R&>()),
+            future_(boost::make_shared<detail::shared_state<R&> >()),
 #endif
             future_obtained(false)
         {}
@@ -2278,9 +2753,11 @@ namespace boost
             {
                 boost::unique_lock<boost::mutex> lock(future_->mutex);
 
-                if(!future_->done && !future_->is_constructed)
+                if(!future_->is_done() && !future_->is_constructed)
                 {
                     future_->mark_exceptional_finish_internal(boost::copy_exception(broken_promise()), lock);
+                    lock.unlock();
+                    detail::resume_waiters(*future_);
                 }
             }
         }
@@ -2327,22 +2804,26 @@ namespace boost
         {
             lazy_init();
             boost::unique_lock<boost::mutex> lock(future_->mutex);
-            if(future_->done)
+            if(future_->is_done())
             {
                 boost::throw_exception(promise_already_satisfied());
             }
             future_->mark_finished_with_result_internal(r, lock);
+            lock.unlock();
+            detail::resume_waiters(*future_);
         }
 
         void set_exception(boost::exception_ptr p)
         {
             lazy_init();
             boost::unique_lock<boost::mutex> lock(future_->mutex);
-            if(future_->done)
+            if(future_->is_done())
             {
                 boost::throw_exception(promise_already_satisfied());
             }
             future_->mark_exceptional_finish_internal(p, lock);
+            lock.unlock();
+            detail::resume_waiters(*future_);
         }
         template <typename E>
         void set_exception(E ex)
@@ -2396,7 +2877,7 @@ namespace boost
             if(!atomic_load(&future_))
             {
                 future_ptr blank;
-                atomic_compare_exchange(&future_,&blank,future_ptr(new detail::shared_state<void>));
+                atomic_compare_exchange(&future_,&blank,boost::make_shared<detail::shared_state<void> >());
             }
 #endif
         }
@@ -2407,11 +2888,7 @@ namespace boost
         template <class Allocator>
         promise(boost::allocator_arg_t, Allocator a)
         {
-          typedef typename Allocator::template rebind<detail::shared_state<void> >::other A2;
-          A2 a2(a);
-          typedef thread_detail::allocator_destructor<A2> D;
-
-          future_ = future_ptr(::new(a2.allocate(1)) detail::shared_state<void>(), D(a2, 1) );
+          future_ = boost::allocate_shared<detail::shared_state<void> >(a);
           future_obtained = false;
         }
 #endif
@@ -2419,7 +2896,7 @@ namespace boost
 #if defined BOOST_THREAD_PROVIDES_PROMISE_LAZY
             future_(),
 #else
-            future_(new detail::shared_state<void>),
+            future_(boost::make_shared<detail::shared_state<void> >()),
 #endif
             future_obtained(false)
         {}
@@ -2430,9 +2907,11 @@ namespace boost
             {
                 boost::unique_lock<boost::mutex> lock(future_->mutex);
 
-                if(!future_->done && !future_->is_constructed)
+                if(!future_->is_done() && !future_->is_constructed)
                 {
                     future_->mark_exceptional_finish_internal(boost::copy_exception(broken_promise()), lock);
+                    lock.unlock();
+                    detail::resume_waiters(*future_);
                 }
             }
         }
@@ -2483,22 +2962,26 @@ namespace boost
         {
             lazy_init();
             boost::unique_lock<boost::mutex> lock(future_->mutex);
-            if(future_->done)
+            if(future_->is_done())
             {
                 boost::throw_exception(promise_already_satisfied());
             }
             future_->mark_finished_with_result_internal(lock);
+            lock.unlock();
+            detail::resume_waiters(*future_);
         }
 
         void set_exception(boost::exception_ptr p)
         {
             lazy_init();
             boost::unique_lock<boost::mutex> lock(future_->mutex);
-            if(future_->done)
+            if(future_->is_done())
             {
                 boost::throw_exception(promise_already_satisfied());
             }
             future_->mark_exceptional_finish_internal(p,lock);
+            lock.unlock();
+            detail::resume_waiters(*future_);
         }
         template <typename E>
         void set_exception(E ex)
@@ -2669,10 +3152,10 @@ namespace boost
           task_shared_state(task_shared_state&);
         public:
             F f;
-            task_shared_state(F const& f_):
+            explicit task_shared_state(F const& f_):
                 f(f_)
             {}
-            task_shared_state(BOOST_THREAD_RV_REF(F) f_):
+            explicit task_shared_state(BOOST_THREAD_RV_REF(F) f_):
               f(boost::move(f_))
             {}
 
@@ -2756,10 +3239,10 @@ namespace boost
           task_shared_state(task_shared_state&);
         public:
             F f;
-            task_shared_state(F const& f_):
+            explicit task_shared_state(F const& f_):
                 f(f_)
             {}
-            task_shared_state(BOOST_THREAD_RV_REF(F) f_):
+            explicit task_shared_state(BOOST_THREAD_RV_REF(F) f_):
                 f(boost::move(f_))
             {}
 
@@ -2842,12 +3325,12 @@ namespace boost
             public:
 #if defined BOOST_THREAD_PROVIDES_SIGNATURE_PACKAGED_TASK && defined(BOOST_THREAD_PROVIDES_VARIADIC_THREAD)
                 R (*f)(BOOST_THREAD_RV_REF(ArgTypes) ... );
-                task_shared_state(R (*f_)(BOOST_THREAD_RV_REF(ArgTypes) ... )):
+                explicit task_shared_state(R (*f_)(BOOST_THREAD_RV_REF(ArgTypes) ... )):
                     f(f_)
                 {}
 #else
                 R (*f)();
-                task_shared_state(R (*f_)()):
+                explicit task_shared_state(R (*f_)()):
                     f(f_)
                 {}
 #endif
@@ -2930,12 +3413,12 @@ namespace boost
             public:
 #if defined BOOST_THREAD_PROVIDES_SIGNATURE_PACKAGED_TASK && defined(BOOST_THREAD_PROVIDES_VARIADIC_THREAD)
                 R& (*f)(BOOST_THREAD_RV_REF(ArgTypes) ... );
-                task_shared_state(R& (*f_)(BOOST_THREAD_RV_REF(ArgTypes) ... )):
+                explicit task_shared_state(R& (*f_)(BOOST_THREAD_RV_REF(ArgTypes) ... )):
                     f(f_)
                 {}
 #else
                 R& (*f)();
-                task_shared_state(R& (*f_)()):
+                explicit task_shared_state(R& (*f_)()):
                     f(f_)
                 {}
 #endif
@@ -3016,10 +3499,10 @@ namespace boost
           task_shared_state(task_shared_state&);
         public:
             F f;
-            task_shared_state(F const& f_):
+            explicit task_shared_state(F const& f_):
                 f(f_)
             {}
-            task_shared_state(BOOST_THREAD_RV_REF(F) f_):
+            explicit task_shared_state(BOOST_THREAD_RV_REF(F) f_):
                 f(boost::move(f_))
             {}
 
@@ -3098,7 +3581,7 @@ namespace boost
           task_shared_state(task_shared_state&);
         public:
             void (*f)();
-            task_shared_state(void (*f_)()):
+            explicit task_shared_state(void (*f_)()):
                 f(f_)
             {}
 
@@ -3199,7 +3682,7 @@ namespace boost
         {
             typedef R(*FR)(BOOST_THREAD_FWD_REF(ArgTypes)...);
             typedef detail::task_shared_state<FR,R(ArgTypes...)> task_shared_state_type;
-            task= task_ptr(new task_shared_state_type(f, boost::forward<ArgTypes>(args)...));
+            task = boost::make_shared<task_shared_state_type>(f, boost::forward<ArgTypes>(args)...);
             future_obtained=false;
         }
   #else
@@ -3207,7 +3690,7 @@ namespace boost
         {
             typedef R(*FR)();
             typedef detail::task_shared_state<FR,R()> task_shared_state_type;
-            task= task_ptr(new task_shared_state_type(f));
+            task = boost::make_shared<task_shared_state_type>(f);
             future_obtained=false;
         }
   #endif
@@ -3216,7 +3699,7 @@ namespace boost
         {
               typedef R(*FR)();
             typedef detail::task_shared_state<FR,R> task_shared_state_type;
-            task= task_ptr(new task_shared_state_type(f));
+            task = boost::make_shared<task_shared_state_type>(f);
             future_obtained=false;
         }
 #endif
@@ -3238,7 +3721,7 @@ namespace boost
 #else
             typedef detail::task_shared_state<FR,R> task_shared_state_type;
 #endif
-            task = task_ptr(new task_shared_state_type(boost::forward<F>(f)));
+            task = boost::make_shared<task_shared_state_type>(boost::forward<F>(f));
             future_obtained = false;
 
         }
@@ -3258,7 +3741,7 @@ namespace boost
 #else
             typedef detail::task_shared_state<F,R> task_shared_state_type;
 #endif
-            task = task_ptr(new task_shared_state_type(f));
+            task = boost::make_shared<task_shared_state_type>(f);
             future_obtained=false;
         }
         template <class F>
@@ -3267,14 +3750,14 @@ namespace boost
 #if defined BOOST_THREAD_PROVIDES_SIGNATURE_PACKAGED_TASK
 #if defined(BOOST_THREAD_PROVIDES_VARIADIC_THREAD)
             typedef detail::task_shared_state<F,R(ArgTypes...)> task_shared_state_type;
-            task = task_ptr(new task_shared_state_type(boost::forward<F>(f)));
+            task = boost::make_shared<task_shared_state_type>(boost::forward<F>(f));
 #else
             typedef detail::task_shared_state<F,R()> task_shared_state_type;
-            task = task_ptr(new task_shared_state_type(boost::move(f))); // TODO forward
+            task = boost::make_shared<task_shared_state_type>(boost::move(f)); // TODO forward
 #endif
 #else
             typedef detail::task_shared_state<F,R> task_shared_state_type;
-            task = task_ptr(new task_shared_state_type(boost::forward<F>(f)));
+            task = boost::make_shared<task_shared_state_type>(boost::forward<F>(f));
 #endif
             future_obtained=false;
 
@@ -3296,11 +3779,7 @@ namespace boost
 #else
           typedef detail::task_shared_state<FR,R> task_shared_state_type;
 #endif
-          typedef typename Allocator::template rebind<task_shared_state_type>::other A2;
-          A2 a2(a);
-          typedef thread_detail::allocator_destructor<A2> D;
-
-          task = task_ptr(::new(a2.allocate(1)) task_shared_state_type(f), D(a2, 1) );
+          task = boost::allocate_shared<task_shared_state_type>(a, f);
           future_obtained = false;
         }
 #endif // BOOST_THREAD_RVALUE_REFERENCES_DONT_MATCH_FUNTION_PTR
@@ -3321,11 +3800,7 @@ namespace boost
 #else
           typedef detail::task_shared_state<FR,R> task_shared_state_type;
 #endif
-          typedef typename Allocator::template rebind<task_shared_state_type>::other A2;
-          A2 a2(a);
-          typedef thread_detail::allocator_destructor<A2> D;
-
-          task = task_ptr(::new(a2.allocate(1)) task_shared_state_type(boost::forward<F>(f)), D(a2, 1) );
+          task = boost::allocate_shared<task_shared_state_type>(a, boost::forward<F>(f));
           future_obtained = false;
         }
 #else // ! defined BOOST_NO_CXX11_RVALUE_REFERENCES
@@ -3341,11 +3816,7 @@ namespace boost
 #else
           typedef detail::task_shared_state<F,R> task_shared_state_type;
 #endif
-          typedef typename Allocator::template rebind<task_shared_state_type>::other A2;
-          A2 a2(a);
-          typedef thread_detail::allocator_destructor<A2> D;
-
-          task = task_ptr(::new(a2.allocate(1)) task_shared_state_type(f), D(a2, 1) );
+          task = boost::allocate_shared<task_shared_state_type>(a, f);
           future_obtained = false;
         }
         template <class F, class Allocator>
@@ -3360,14 +3831,10 @@ namespace boost
 #else
           typedef detail::task_shared_state<F,R> task_shared_state_type;
 #endif
-          typedef typename Allocator::template rebind<task_shared_state_type>::other A2;
-          A2 a2(a);
-          typedef thread_detail::allocator_destructor<A2> D;
-
 #if defined BOOST_THREAD_PROVIDES_SIGNATURE_PACKAGED_TASK && defined(BOOST_THREAD_PROVIDES_VARIADIC_THREAD)
-          task = task_ptr(::new(a2.allocate(1)) task_shared_state_type(boost::forward<F>(f)), D(a2, 1) );
+          task = boost::allocate_shared<task_shared_state_type>(a, boost::forward<F>(f));
 #else
-          task = task_ptr(::new(a2.allocate(1)) task_shared_state_type(boost::move(f)), D(a2, 1) );  // TODO forward
+          task = boost::allocate_shared<task_shared_state_type>(a, boost::move(f));  // TODO forward
 #endif
           future_obtained = false;
         }
@@ -3378,6 +3845,7 @@ namespace boost
         ~packaged_task() {
             if(task) {
                 task->owner_destroyed();
+                detail::resume_waiters(*task);
             }
         }
 
@@ -3433,6 +3901,7 @@ namespace boost
                 boost::throw_exception(task_moved());
             }
             task->run(boost::forward<ArgTypes>(args)...);
+            detail::resume_waiters(*task);
         }
         void make_ready_at_thread_exit(ArgTypes... args) {
           if(!task) {
@@ -3449,6 +3918,7 @@ namespace boost
                 boost::throw_exception(task_moved());
             }
             task->run();
+            detail::resume_waiters(*task);
         }
         void make_ready_at_thread_exit() {
           if(!task) {
@@ -3492,7 +3962,7 @@ namespace detail
   BOOST_THREAD_FUTURE<Rp>
   make_future_deferred_shared_state(BOOST_THREAD_FWD_REF(Fp) f) {
     shared_ptr<future_deferred_shared_state<Rp, Fp> >
-        h(new future_deferred_shared_state<Rp, Fp>(boost::forward<Fp>(f)));
+        h(boost::make_shared<future_deferred_shared_state<Rp, Fp> >(boost::forward<Fp>(f)));
     return BOOST_THREAD_FUTURE<Rp>(h);
   }
 
@@ -3503,7 +3973,7 @@ namespace detail
   BOOST_THREAD_FUTURE<Rp>
   make_future_async_shared_state(BOOST_THREAD_FWD_REF(Fp) f) {
     shared_ptr<future_async_shared_state<Rp, Fp> >
-        h(new future_async_shared_state<Rp, Fp>(boost::forward<Fp>(f)));
+        h(boost::make_shared<future_async_shared_state<Rp, Fp> >(boost::forward<Fp>(f)));
     return BOOST_THREAD_FUTURE<Rp>(h);
   }
 }
@@ -3802,36 +4272,104 @@ namespace detail {
     };
 
     /////////////////////////
-    /// future_executor_shared_state_base
+    /// shared_state_cancellable_nullary_task
     /////////////////////////
-    template<typename Rp, typename Executor>
-    struct future_executor_shared_state: shared_state<Rp>
+    // The token is checked when the executor dequeues the task, so that work cancelled while it was waiting in the
+    // executor queue completes its future with future_cancelled without invoking the function.
+    template<typename Rp, typename Fp>
+    struct shared_state_cancellable_nullary_task: shared_state_nullary_task<Rp, Fp>
     {
-      typedef shared_state<Rp> base_type;
-    protected:
+      typedef shared_state_nullary_task<Rp, Fp> base_type;
+      cancellation_token token_;
+    public:
+
+      shared_state_cancellable_nullary_task(shared_state<Rp>* st, BOOST_THREAD_FWD_REF(Fp) f, cancellation_token const& token)
+      : base_type(st, boost::forward<Fp>(f)), token_(token)
+      {};
+      void operator()() {
+        if (token_.is_cancellation_requested()) {
+          token_.notify_shed();
+          this->that->mark_cancelled_finish();
+          return;
+        }
+        this->base_type::operator()();
+      }
+    };
+
+    /////////////////////////
+    /// future_executor_shared_state
+    /////////////////////////
+    // The shared state of async(ex, f) is the task object: invoking it runs the function and stores the result in
+    // place, so there is a single allocation per call.
+    template<typename Rp, typename Task>
+    struct future_executor_shared_state: shared_state<Rp>, executors::work::impl_base
+    {
+      Task task_;
     public:
       template<typename Fp>
-      future_executor_shared_state(Executor& ex, BOOST_THREAD_FWD_REF(Fp) f) {
+      explicit future_executor_shared_state(BOOST_THREAD_FWD_REF(Fp) f)
+      : task_(this, boost::forward<Fp>(f)) {
         this->set_executor();
-        shared_state_nullary_task<Rp,Fp> t(this, boost::forward<Fp>(f));
-        ex.submit(boost::move(t));
       }
+      template<typename Fp>
+      future_executor_shared_state(BOOST_THREAD_FWD_REF(Fp) f, cancellation_token const& token)
+      : task_(this, boost::forward<Fp>(f), token) {
+        this->set_executor();
+      }
+
 
-      ~future_executor_shared_state() {
-        this->wait(false);
+      void call() {
+        task_();
+        // the executor queue owns this state until call() returns.
+        resume_waiters(*this);
       }
     };
 
+    // The executor queue owns the state until the task has been run, so that the task never completes a state that
+    // the futures have already released. No closure is allocated.
+    template <class Executor, class State>
+    void submit_executor_shared_state(Executor& ex, shared_ptr<State> const& st) {
+      shared_ptr<executors::work::impl_base> const task(st);
+      executors::work w(task);
+      try {
+        ex.submit(boost::move(w));
+      } catch(...) {
+        st->mark_exceptional_finish();
+        throw;
+      }
+    }
+
     ////////////////////////////////
     // make_future_executor_shared_state
     ////////////////////////////////
     template <class Rp, class Fp, class Executor>
     BOOST_THREAD_FUTURE<Rp>
     make_future_executor_shared_state(Executor& ex, BOOST_THREAD_FWD_REF(Fp) f) {
-      shared_ptr<future_executor_shared_state<Rp, Executor> >
-          h(new future_executor_shared_state<Rp, Executor>(ex, boost::forward<Fp>(f)));
+      typedef future_executor_shared_state<Rp, shared_state_nullary_task<Rp, typename decay<Fp>::type> > state_type;
+      shared_ptr<state_type> h(boost::make_shared<state_type>(boost::forward<Fp>(f)));
+      submit_executor_shared_state(ex, h);
+      return BOOST_THREAD_FUTURE<Rp>(h);
+    }
+
+    template <class Rp, class Fp, class Executor>
+    BOOST_THREAD_FUTURE<Rp>
+    make_future_executor_shared_state(Executor& ex, cancellation_token const& token, BOOST_THREAD_FWD_REF(Fp) f) {
+      typedef future_executor_shared_state<Rp, shared_state_cancellable_nullary_task<Rp, typename decay<Fp>::type> > state_type;
+      shared_ptr<state_type> h(boost::make_shared<state_type>(boost::forward<Fp>(f), token));
+      submit_executor_shared_state(ex, h);
+      return BOOST_THREAD_FUTURE<Rp>(h);
+    }
+
+#if defined BOOST_THREAD_PROVIDES_FUTURE_CTOR_ALLOCATORS
+    template <class Rp, class Fp, class Executor, class Allocator>
+    BOOST_THREAD_FUTURE<Rp>
+    make_future_executor_shared_state(boost::allocator_arg_t, Allocator const& a, Executor& ex, BOOST_THREAD_FWD_REF(Fp) f) {
+      typedef future_executor_shared_state<Rp, shared_state_nullary_task<Rp, typename decay<Fp>::type> > state_type;
+      shared_ptr<state_type> h(boost::allocate_shared<state_type>(a, boost::forward<Fp>(f)));
+      submit_executor_shared_state(ex, h);
       return BOOST_THREAD_FUTURE<Rp>(h);
     }
+#endif
 
 } // detail
 
@@ -3875,6 +4413,40 @@ namespace detail {
     ));
   }
 
+#if defined BOOST_THREAD_PROVIDES_FUTURE_CTOR_ALLOCATORS
+  template <class Allocator, class Executor, class F, class ...ArgTypes>
+  BOOST_THREAD_FUTURE<typename boost::result_of<typename decay<F>::type(
+      typename decay<ArgTypes>::type...
+  )>::type>
+  async(boost::allocator_arg_t, Allocator const& a, Executor& ex, BOOST_THREAD_FWD_REF(F) f, BOOST_THREAD_FWD_REF(ArgTypes)... args) {
+    typedef detail::invoker<typename decay<F>::type, typename decay<ArgTypes>::type...> BF;
+    typedef typename BF::result_type Rp;
+
+    return BOOST_THREAD_MAKE_RV_REF(boost::detail::make_future_executor_shared_state<Rp>(boost::allocator_arg, a, ex,
+        BF(
+            thread_detail::decay_copy(boost::forward<F>(f))
+            , thread_detail::decay_copy(boost::forward<ArgTypes>(args))...
+        )
+    ));
+  }
+#endif // BOOST_THREAD_PROVIDES_FUTURE_CTOR_ALLOCATORS
+
+  template <class Executor, class F, class ...ArgTypes>
+  BOOST_THREAD_FUTURE<typename boost::result_of<typename decay<F>::type(
+      typename decay<ArgTypes>::type...
+  )>::type>
+  async(Executor& ex, cancellation_token const& token, BOOST_THREAD_FWD_REF(F) f, BOOST_THREAD_FWD_REF(ArgTypes)... args) {
+    typedef detail::invoker<typename decay<F>::type, typename decay<ArgTypes>::type...> BF;
+    typedef typename BF::result_type Rp;
+
+    return BOOST_THREAD_MAKE_RV_REF(boost::detail::make_future_executor_shared_state<Rp>(ex, token,
+        BF(
+            thread_detail::decay_copy(boost::forward<F>(f))
+            , thread_detail::decay_copy(boost::forward<ArgTypes>(args))...
+        )
+    ));
+  }
+
 //  template <class R, class Executor, class F, class ...ArgTypes>
 //  BOOST_THREAD_FUTURE<typename boost::result_of<typename decay<F>::type(
 //      typename decay<ArgTypes>::type...
@@ -4040,6 +4612,16 @@ namespace detail {
     return BOOST_THREAD_MAKE_RV_REF(p.get_future());
   }
 
+#if defined BOOST_THREAD_PROVIDES_FUTURE_CTOR_ALLOCATORS
+  template <typename T, typename Allocator>
+  BOOST_THREAD_FUTURE<typename decay<T>::type> make_ready_future(boost::allocator_arg_t, Allocator const& a, BOOST_THREAD_FWD_REF(T) value) {
+    typedef typename decay<T>::type future_value_type;
+    promise<future_value_type> p(boost::allocator_arg, a);
+    p.set_value(boost::forward<future_value_type>(value));
+    return BOOST_THREAD_MAKE_RV_REF(p.get_future());
+  }
+#endif
+
   template <typename T, typename T1>
   BOOST_THREAD_FUTURE<T> make_ready_no_decay_future(T1 value) {
     typedef T future_value_type;
@@ -4177,7 +4759,9 @@ namespace detail
 
     void launch_continuation(boost::unique_lock<boost::mutex>& ) {
       //lock.unlock();
-      this->thr_ = thread(&future_async_continuation_shared_state::run, this);
+      thread th(&future_async_continuation_shared_state::run, this);
+      boost::lock_guard<boost::mutex> lk(this->mutex);
+      this->thr_ = boost::move(th);
     }
 
     static void run(future_async_continuation_shared_state* that) {
@@ -4190,6 +4774,7 @@ namespace detail
       } catch(...) {
         that->mark_exceptional_finish();
       }
+      resume_waiters_on_new_thread(*that);
     }
 
     ~future_async_continuation_shared_state() {
@@ -4211,7 +4796,9 @@ namespace detail
 
     void launch_continuation(boost::unique_lock<boost::mutex>& ) {
       //lk.unlock();
-      this->thr_ = thread(&future_async_continuation_shared_state::run, this);
+      thread th(&future_async_continuation_shared_state::run, this);
+      boost::lock_guard<boost::mutex> lk(this->mutex);
+      this->thr_ = boost::move(th);
     }
 
     static void run(future_async_continuation_shared_state* that) {
@@ -4225,6 +4812,7 @@ namespace detail
       } catch(...) {
         that->mark_exceptional_finish();
       }
+      resume_waiters_on_new_thread(*that);
     }
 
     ~future_async_continuation_shared_state() {
@@ -4232,6 +4820,130 @@ namespace detail
     }
   };
 
+#ifdef BOOST_THREAD_PROVIDES_EXECUTORS
+  /////////////////////////
+  /// future_executor_continuation_shared_state
+  /////////////////////////
+
+  // Returns true when the continuation must not be invoked, either because cancellation has been requested on
+  // its token or because the parent has been cancelled, so that the cancellation cascades through the chain.
+  inline bool continuation_cancelled(cancellation_token const& token, shared_state_base const& parent) {
+    if (! token.cancellation_possible()) return false;
+    if (! token.is_cancellation_requested() && ! parent.is_cancelled()) return false;
+    token.notify_shed();
+    return true;
+  }
+
+  template<typename Ex, typename F, typename Rp, typename Fp>
+  struct future_executor_continuation_shared_state: shared_state<Rp>, executors::work::impl_base
+  {
+    typename stored_executor<Ex>::type ex;
+    F parent;
+    Fp continuation;
+    cancellation_token token;
+
+  public:
+    future_executor_continuation_shared_state(Ex& e, BOOST_THREAD_RV_REF(F) f, BOOST_THREAD_FWD_REF(Fp) c, cancellation_token const& tk)
+    : ex(e),
+      parent(boost::move(f)),
+      continuation(boost::move(c)),
+      token(tk) {
+      this->set_executor();
+    }
+
+    void launch_continuation(boost::unique_lock<boost::mutex>& lck) {
+      // the executor queue shares the ownership of the state, that is its own closure.
+      shared_ptr<executors::work::impl_base> const task(
+          static_pointer_cast<future_executor_continuation_shared_state>(this->shared_from_this()));
+      // the executor could run the continuation in place, which needs to lock the parent.
+      executors::work w(task);
+      relocker relock(lck);
+      try {
+        ex.submit(boost::move(w));
+      } catch(...) {
+        this->mark_exceptional_finish();
+        resume_waiters(*this);
+      }
+    }
+
+    void call() {
+      run();
+      resume_waiters(*this);
+    }
+
+    void run() {
+      if (continuation_cancelled(token, *parent.future_)) {
+        this->mark_cancelled_finish();
+        return;
+      }
+      try {
+        this->mark_finished_with_result(continuation(boost::move(parent)));
+#if defined BOOST_THREAD_PROVIDES_INTERRUPTIONS
+      } catch(thread_interrupted& ) {
+        this->mark_interrupted_finish();
+#endif
+      } catch(...) {
+        this->mark_exceptional_finish();
+      }
+    }
+  };
+
+  template<typename Ex, typename F, typename Fp>
+  struct future_executor_continuation_shared_state<Ex, F, void, Fp>: shared_state<void>, executors::work::impl_base
+  {
+    typename stored_executor<Ex>::type ex;
+    F parent;
+    Fp continuation;
+    cancellation_token token;
+
+  public:
+    future_executor_continuation_shared_state(Ex& e, BOOST_THREAD_RV_REF(F) f, BOOST_THREAD_FWD_REF(Fp) c, cancellation_token const& tk)
+    : ex(e),
+      parent(boost::move(f)),
+      continuation(boost::move(c)),
+      token(tk) {
+      this->set_executor();
+    }
+
+    void launch_continuation(boost::unique_lock<boost::mutex>& lck) {
+      // the executor queue shares the ownership of the state, that is its own closure.
+      shared_ptr<executors::work::impl_base> const task(
+          static_pointer_cast<future_executor_continuation_shared_state>(this->shared_from_this()));
+      // the executor could run the continuation in place, which needs to lock the parent.
+      executors::work w(task);
+      relocker relock(lck);
+      try {
+        ex.submit(boost::move(w));
+      } catch(...) {
+        this->mark_exceptional_finish();
+        resume_waiters(*this);
+      }
+    }
+
+    void call() {
+      run();
+      resume_waiters(*this);
+    }
+
+    void run() {
+      if (continuation_cancelled(token, *parent.future_)) {
+        this->mark_cancelled_finish();
+        return;
+      }
+      try {
+        continuation(boost::move(parent));
+        this->mark_finished_with_result();
+#if defined BOOST_THREAD_PROVIDES_INTERRUPTIONS
+      } catch(thread_interrupted& ) {
+        this->mark_interrupted_finish();
+#endif
+      } catch(...) {
+        this->mark_exceptional_finish();
+      }
+    }
+  };
+#endif
+
   //////////////////////////
   /// future_deferred_continuation_shared_state
   //////////////////////////
@@ -4252,11 +4964,19 @@ namespace detail
       //execute(lk);
     }
 
+    virtual bool pending_deferred(shared_ptr<shared_state_base>& p) {
+      boost::lock_guard<boost::mutex> lk(this->mutex);
+      if (! this->is_deferred_) return false;
+      p = parent.future_;
+      return true;
+    }
+
     virtual void execute(boost::unique_lock<boost::mutex>& lck) {
       try {
         Fp local_fuct=boost::move(continuation);
         F ftmp = boost::move(parent);
         relocker relock(lck);
+        execute_deferred_chain(ftmp.future_);
         Rp res = local_fuct(boost::move(ftmp));
         relock.lock();
         this->mark_finished_with_result_internal(boost::move(res), lck);
@@ -4282,11 +5002,19 @@ namespace detail
     virtual void launch_continuation(boost::unique_lock<boost::mutex>& ) {
       //execute(lk);
     }
+
+    virtual bool pending_deferred(shared_ptr<shared_state_base>& p) {
+      boost::lock_guard<boost::mutex> lk(this->mutex);
+      if (! this->is_deferred_) return false;
+      p = parent.future_;
+      return true;
+    }
     virtual void execute(boost::unique_lock<boost::mutex>& lck) {
       try {
         Fp local_fuct=boost::move(continuation);
         F ftmp = boost::move(parent);
         relocker relock(lck);
+        execute_deferred_chain(ftmp.future_);
         local_fuct(boost::move(ftmp));
         relock.lock();
         this->mark_finished_with_result_internal(lck);
@@ -4305,7 +5033,7 @@ namespace detail
       boost::unique_lock<boost::mutex> &lock,
       BOOST_THREAD_RV_REF(F) f, BOOST_THREAD_FWD_REF(Fp) c) {
     shared_ptr<future_deferred_continuation_shared_state<F, Rp, Fp> >
-        h(new future_deferred_continuation_shared_state<F, Rp, Fp>(boost::move(f), boost::forward<Fp>(c)));
+        h(boost::make_shared<future_deferred_continuation_shared_state<F, Rp, Fp> >(boost::move(f), boost::forward<Fp>(c)));
     h->parent.future_->set_continuation_ptr(h, lock);
     return BOOST_THREAD_FUTURE<Rp>(h);
   }
@@ -4319,11 +5047,55 @@ namespace detail
       boost::unique_lock<boost::mutex> &lock, BOOST_THREAD_RV_REF(F) f,
       BOOST_THREAD_FWD_REF(Fp) c) {
     shared_ptr<future_async_continuation_shared_state<F,Rp, Fp> >
-        h(new future_async_continuation_shared_state<F,Rp, Fp>(boost::move(f), boost::forward<Fp>(c)));
+        h(boost::make_shared<future_async_continuation_shared_state<F,Rp, Fp> >(boost::move(f), boost::forward<Fp>(c)));
     h->parent.future_->set_continuation_ptr(h, lock);
 
     return BOOST_THREAD_FUTURE<Rp>(h);
   }
+
+#if defined BOOST_THREAD_PROVIDES_FUTURE_CTOR_ALLOCATORS
+  template<typename F, typename Rp, typename Fp, typename Allocator>
+  BOOST_THREAD_FUTURE<Rp>
+  make_future_deferred_continuation_shared_state(
+      boost::allocator_arg_t, Allocator const& a,
+      boost::unique_lock<boost::mutex> &lock,
+      BOOST_THREAD_RV_REF(F) f, BOOST_THREAD_FWD_REF(Fp) c) {
+    shared_ptr<future_deferred_continuation_shared_state<F, Rp, Fp> >
+        h(boost::allocate_shared<future_deferred_continuation_shared_state<F, Rp, Fp> >(a, boost::move(f), boost::forward<Fp>(c)));
+    h->parent.future_->set_continuation_ptr(h, lock);
+    return BOOST_THREAD_FUTURE<Rp>(h);
+  }
+
+  template<typename F, typename Rp, typename Fp, typename Allocator>
+  BOOST_THREAD_FUTURE<Rp>
+  make_future_async_continuation_shared_state(
+      boost::allocator_arg_t, Allocator const& a,
+      boost::unique_lock<boost::mutex> &lock, BOOST_THREAD_RV_REF(F) f,
+      BOOST_THREAD_FWD_REF(Fp) c) {
+    shared_ptr<future_async_continuation_shared_state<F,Rp, Fp> >
+        h(boost::allocate_shared<future_async_continuation_shared_state<F,Rp, Fp> >(a, boost::move(f), boost::forward<Fp>(c)));
+    h->parent.future_->set_continuation_ptr(h, lock);
+
+    return BOOST_THREAD_FUTURE<Rp>(h);
+  }
+#endif
+
+#ifdef BOOST_THREAD_PROVIDES_EXECUTORS
+  ////////////////////////////////
+  // make_future_executor_continuation_shared_state
+  ////////////////////////////////
+  template<typename Ex, typename F, typename Rp, typename Fp>
+  BOOST_THREAD_FUTURE<Rp>
+  make_future_executor_continuation_shared_state(Ex& ex, cancellation_token const& token,
+      boost::unique_lock<boost::mutex> &lock, BOOST_THREAD_RV_REF(F) f,
+      BOOST_THREAD_FWD_REF(Fp) c) {
+    shared_ptr<future_executor_continuation_shared_state<Ex, F, Rp, Fp> >
+        h(boost::make_shared<future_executor_continuation_shared_state<Ex, F, Rp, Fp> >(boost::ref(ex), boost::move(f), boost::forward<Fp>(c), token));
+    h->parent.future_->set_continuation_ptr(h, lock);
+
+    return BOOST_THREAD_FUTURE<Rp>(h);
+  }
+#endif
 }
 
   ////////////////////////////////
@@ -4338,7 +5110,11 @@ namespace detail
     typedef typename boost::result_of<F(BOOST_THREAD_FUTURE<R>)>::type future_type;
     BOOST_THREAD_ASSERT_PRECONDITION(this->future_!=0, future_uninitialized());
 
-    boost::unique_lock<boost::mutex> lock(this->future_->mutex);
+    // Hold the parent state until the lock is released: the continuation
+    // consumes *this and may drop the last reference to it before then()
+    // returns.
+    shared_ptr<detail::shared_state_base> const parent_state(this->future_);
+    boost::unique_lock<boost::mutex> lock(parent_state->mutex);
     if (underlying_cast<int>(policy) & int(launch::async)) {
       return BOOST_THREAD_MAKE_RV_REF((boost::detail::make_future_async_continuation_shared_state<BOOST_THREAD_FUTURE<R>, future_type, F>(
                   lock, boost::move(*this), boost::forward<F>(func)
@@ -4361,7 +5137,8 @@ namespace detail
     typedef typename boost::result_of<F(BOOST_THREAD_FUTURE<R>)>::type future_type;
     BOOST_THREAD_ASSERT_PRECONDITION(this->future_!=0, future_uninitialized());
 
-    boost::unique_lock<boost::mutex> lock(this->future_->mutex);
+    shared_ptr<detail::shared_state_base> const parent_state(this->future_);
+    boost::unique_lock<boost::mutex> lock(parent_state->mutex);
     if (underlying_cast<int>(this->launch_policy(lock)) & int(launch::async)) {
       return boost::detail::make_future_async_continuation_shared_state<BOOST_THREAD_FUTURE<R>, future_type, F>(
           lock, boost::move(*this), boost::forward<F>(func)
@@ -4378,6 +5155,84 @@ namespace detail
     }
   }
 
+#if defined BOOST_THREAD_PROVIDES_FUTURE_CTOR_ALLOCATORS
+  template <typename R>
+  template <typename Allocator, typename F>
+  inline BOOST_THREAD_FUTURE<typename boost::result_of<F(BOOST_THREAD_FUTURE<R>)>::type>
+  BOOST_THREAD_FUTURE<R>::then(boost::allocator_arg_t, Allocator const& a, launch policy, BOOST_THREAD_FWD_REF(F) func) {
+    typedef typename boost::result_of<F(BOOST_THREAD_FUTURE<R>)>::type future_type;
+    BOOST_THREAD_ASSERT_PRECONDITION(this->future_!=0, future_uninitialized());
+
+    shared_ptr<detail::shared_state_base> const parent_state(this->future_);
+    boost::unique_lock<boost::mutex> lock(parent_state->mutex);
+    if (underlying_cast<int>(policy) & int(launch::async)) {
+      return BOOST_THREAD_MAKE_RV_REF((boost::detail::make_future_async_continuation_shared_state<BOOST_THREAD_FUTURE<R>, future_type, F>(
+                  boost::allocator_arg, a, lock, boost::move(*this), boost::forward<F>(func)
+              )));
+    } else if (underlying_cast<int>(policy) & int(launch::deferred)) {
+      return BOOST_THREAD_MAKE_RV_REF((boost::detail::make_future_deferred_continuation_shared_state<BOOST_THREAD_FUTURE<R>, future_type, F>(
+                  boost::allocator_arg, a, lock, boost::move(*this), boost::forward<F>(func)
+              )));
+    } else {
+      return BOOST_THREAD_MAKE_RV_REF((boost::detail::make_future_async_continuation_shared_state<BOOST_THREAD_FUTURE<R>, future_type, F>(
+                  boost::allocator_arg, a, lock, boost::move(*this), boost::forward<F>(func)
+              )));
+    }
+  }
+
+  template <typename R>
+  template <typename Allocator, typename F>
+  inline BOOST_THREAD_FUTURE<typename boost::result_of<F(BOOST_THREAD_FUTURE<R>)>::type>
+  BOOST_THREAD_FUTURE<R>::then(boost::allocator_arg_t, Allocator const& a, BOOST_THREAD_FWD_REF(F) func)  {
+    typedef typename boost::result_of<F(BOOST_THREAD_FUTURE<R>)>::type future_type;
+    BOOST_THREAD_ASSERT_PRECONDITION(this->future_!=0, future_uninitialized());
+
+    shared_ptr<detail::shared_state_base> const parent_state(this->future_);
+    boost::unique_lock<boost::mutex> lock(parent_state->mutex);
+    if (underlying_cast<int>(this->launch_policy(lock)) & int(launch::async)) {
+      return boost::detail::make_future_async_continuation_shared_state<BOOST_THREAD_FUTURE<R>, future_type, F>(
+          boost::allocator_arg, a, lock, boost::move(*this), boost::forward<F>(func)
+      );
+    } else if (underlying_cast<int>(this->launch_policy(lock)) & int(launch::deferred)) {
+      this->future_->wait_internal(lock);
+      return boost::detail::make_future_deferred_continuation_shared_state<BOOST_THREAD_FUTURE<R>, future_type, F>(
+          boost::allocator_arg, a, lock, boost::move(*this), boost::forward<F>(func)
+      );
+    } else {
+      return boost::detail::make_future_async_continuation_shared_state<BOOST_THREAD_FUTURE<R>, future_type, F>(
+          boost::allocator_arg, a, lock, boost::move(*this), boost::forward<F>(func)
+      );
+    }
+  }
+#endif
+
+#ifdef BOOST_THREAD_PROVIDES_EXECUTORS
+  ////////////////////////////////
+  // template<typename Ex, typename F>
+  // auto future<R>::then(Ex& ex, cancellation_token const& token, F&& func) -> BOOST_THREAD_FUTURE<decltype(func(*this))>;
+  ////////////////////////////////
+  template <typename R>
+  template <typename Ex, typename F>
+  inline BOOST_THREAD_FUTURE<typename boost::result_of<F(BOOST_THREAD_FUTURE<R>)>::type>
+  BOOST_THREAD_FUTURE<R>::then(Ex& ex, cancellation_token const& token, BOOST_THREAD_FWD_REF(F) func) {
+    typedef typename boost::result_of<F(BOOST_THREAD_FUTURE<R>)>::type future_type;
+    BOOST_THREAD_ASSERT_PRECONDITION(this->future_!=0, future_uninitialized());
+
+    shared_ptr<detail::shared_state_base> const parent_state(this->future_);
+    boost::unique_lock<boost::mutex> lock(parent_state->mutex);
+    return BOOST_THREAD_MAKE_RV_REF((boost::detail::make_future_executor_continuation_shared_state<Ex, BOOST_THREAD_FUTURE<R>, future_type, F>(
+                ex, token, lock, boost::move(*this), boost::forward<F>(func)
+            )));
+  }
+
+  template <typename R>
+  template <typename Ex, typename F>
+  inline BOOST_THREAD_FUTURE<typename boost::result_of<F(BOOST_THREAD_FUTURE<R>)>::type>
+  BOOST_THREAD_FUTURE<R>::then(Ex& ex, BOOST_THREAD_FWD_REF(F) func) {
+    return this->then(ex, cancellation_token(), boost::forward<F>(func));
+  }
+#endif
+
 
 //#if 0 && defined(BOOST_THREAD_RVALUE_REFERENCES_DONT_MATCH_FUNTION_PTR)
 //  template <typename R>
@@ -4440,7 +5295,8 @@ namespace detail
     typedef typename boost::result_of<F(shared_future<R>)>::type future_type;
     BOOST_THREAD_ASSERT_PRECONDITION(this->future_!=0, future_uninitialized());
 
-    boost::unique_lock<boost::mutex> lock(this->future_->mutex);
+    shared_ptr<detail::shared_state_base> const parent_state(this->future_);
+    boost::unique_lock<boost::mutex> lock(parent_state->mutex);
     if (underlying_cast<int>(policy) & int(launch::async)) {
       return BOOST_THREAD_MAKE_RV_REF((boost::detail::make_future_async_continuation_shared_state<shared_future<R>, future_type, F>(
                   lock, boost::move(*this), boost::forward<F>(func)
@@ -4464,7 +5320,8 @@ namespace detail
 
     BOOST_THREAD_ASSERT_PRECONDITION(this->future_!=0, future_uninitialized());
 
-    boost::unique_lock<boost::mutex> lock(this->future_->mutex);
+    shared_ptr<detail::shared_state_base> const parent_state(this->future_);
+    boost::unique_lock<boost::mutex> lock(parent_state->mutex);
     if (underlying_cast<int>(this->launch_policy(lock)) & int(launch::async)) {
       return boost::detail::make_future_async_continuation_shared_state<shared_future<R>, future_type, F>(
           lock, boost::move(*this), boost::forward<F>(func));
@@ -4478,6 +5335,85 @@ namespace detail
     }
   }
 
+#if defined BOOST_THREAD_PROVIDES_FUTURE_CTOR_ALLOCATORS
+  template <typename R>
+  template <typename Allocator, typename F>
+  inline BOOST_THREAD_FUTURE<typename boost::result_of<F(shared_future<R>)>::type>
+  shared_future<R>::then(boost::allocator_arg_t, Allocator const& a, launch policy, BOOST_THREAD_FWD_REF(F) func) {
+    typedef typename boost::result_of<F(shared_future<R>)>::type future_type;
+    BOOST_THREAD_ASSERT_PRECONDITION(this->future_!=0, future_uninitialized());
+
+    shared_ptr<detail::shared_state_base> const parent_state(this->future_);
+    boost::unique_lock<boost::mutex> lock(parent_state->mutex);
+    if (underlying_cast<int>(policy) & int(launch::async)) {
+      return BOOST_THREAD_MAKE_RV_REF((boost::detail::make_future_async_continuation_shared_state<shared_future<R>, future_type, F>(
+                  boost::allocator_arg, a, lock, boost::move(*this), boost::forward<F>(func)
+              )));
+    } else if (underlying_cast<int>(policy) & int(launch::deferred)) {
+      return BOOST_THREAD_MAKE_RV_REF((boost::detail::make_future_deferred_continuation_shared_state<shared_future<R>, future_type, F>(
+                  boost::allocator_arg, a, lock, boost::move(*this), boost::forward<F>(func)
+              )));
+    } else {
+      return BOOST_THREAD_MAKE_RV_REF((boost::detail::make_future_async_continuation_shared_state<shared_future<R>, future_type, F>(
+                  boost::allocator_arg, a, lock, boost::move(*this), boost::forward<F>(func)
+              )));
+    }
+  }
+
+  template <typename R>
+  template <typename Allocator, typename F>
+  inline BOOST_THREAD_FUTURE<typename boost::result_of<F(shared_future<R>)>::type>
+  shared_future<R>::then(boost::allocator_arg_t, Allocator const& a, BOOST_THREAD_FWD_REF(F) func)  {
+    typedef typename boost::result_of<F(shared_future<R>)>::type future_type;
+    BOOST_THREAD_ASSERT_PRECONDITION(this->future_!=0, future_uninitialized());
+
+    shared_ptr<detail::shared_state_base> const parent_state(this->future_);
+    boost::unique_lock<boost::mutex> lock(parent_state->mutex);
+    if (underlying_cast<int>(this->launch_policy(lock)) & int(launch::async)) {
+      return boost::detail::make_future_async_continuation_shared_state<shared_future<R>, future_type, F>(
+          boost::allocator_arg, a, lock, boost::move(*this), boost::forward<F>(func)
+      );
+    } else if (underlying_cast<int>(this->launch_policy(lock)) & int(launch::deferred)) {
+      this->future_->wait_internal(lock);
+      return boost::detail::make_future_deferred_continuation_shared_state<shared_future<R>, future_type, F>(
+          boost::allocator_arg, a, lock, boost::move(*this), boost::forward<F>(func)
+      );
+    } else {
+      return boost::detail::make_future_async_continuation_shared_state<shared_future<R>, future_type, F>(
+          boost::allocator_arg, a, lock, boost::move(*this), boost::forward<F>(func)
+      );
+    }
+  }
+#endif
+
+
+#ifdef BOOST_THREAD_PROVIDES_EXECUTORS
+  ////////////////////////////////
+  // template<typename Ex, typename F>
+  // auto shared_future<R>::then(Ex& ex, cancellation_token const& token, F&& func) -> BOOST_THREAD_FUTURE<decltype(func(*this))>;
+  ////////////////////////////////
+  template <typename R>
+  template <typename Ex, typename F>
+  inline BOOST_THREAD_FUTURE<typename boost::result_of<F(shared_future<R>)>::type>
+  shared_future<R>::then(Ex& ex, cancellation_token const& token, BOOST_THREAD_FWD_REF(F) func) {
+    typedef typename boost::result_of<F(shared_future<R>)>::type future_type;
+    BOOST_THREAD_ASSERT_PRECONDITION(this->future_!=0, future_uninitialized());
+
+    shared_ptr<detail::shared_state_base> const parent_state(this->future_);
+    boost::unique_lock<boost::mutex> lock(parent_state->mutex);
+    return BOOST_THREAD_MAKE_RV_REF((boost::detail::make_future_executor_continuation_shared_state<Ex, shared_future<R>, future_type, F>(
+                ex, token, lock, boost::move(*this), boost::forward<F>(func)
+            )));
+  }
+
+  template <typename R>
+  template <typename Ex, typename F>
+  inline BOOST_THREAD_FUTURE<typename boost::result_of<F(shared_future<R>)>::type>
+  shared_future<R>::then(Ex& ex, BOOST_THREAD_FWD_REF(F) func) {
+    return this->then(ex, cancellation_token(), boost::forward<F>(func));
+  }
+#endif
+
 namespace detail
 {
   template <typename T>
@@ -4556,7 +5492,7 @@ namespace detail
   BOOST_THREAD_FUTURE<Rp>
   make_future_unwrap_shared_state(boost::unique_lock<boost::mutex> &lock, BOOST_THREAD_RV_REF(F) f) {
     shared_ptr<future_unwrap_shared_state<F, Rp> >
-        h(new future_unwrap_shared_state<F, Rp>(boost::move(f)));
+        h(boost::make_shared<future_unwrap_shared_state<F, Rp> >(boost::move(f)));
     h->parent.future_->set_continuation_ptr(h, lock);
     return BOOST_THREAD_FUTURE<Rp>(h);
   }
@@ -4571,7 +5507,8 @@ namespace detail
   BOOST_THREAD_FUTURE<BOOST_THREAD_FUTURE<R2> >::unwrap()
   {
     BOOST_THREAD_ASSERT_PRECONDITION(this->future_!=0, future_uninitialized());
-    boost::unique_lock<boost::mutex> lock(this->future_->mutex);
+    shared_ptr<detail::shared_state_base> const parent_state(this->future_);
+    boost::unique_lock<boost::mutex> lock(parent_state->mutex);
     return boost::detail::make_future_unwrap_shared_state<BOOST_THREAD_FUTURE<BOOST_THREAD_FUTURE<R2> >, R2>(lock, boost::move(*this));
   }
 #endif
@@ -4609,6 +5546,7 @@ namespace detail
       } catch(...) {
         that->mark_exceptional_finish();
       }
+      resume_waiters_on_new_thread(*that);
     }
     void init() {
       this->thr_ = thread(&future_when_all_vector_shared_state::run, this);
@@ -4669,6 +5607,7 @@ namespace detail
       } catch(...) {
         that->mark_exceptional_finish();
       }
+      resume_waiters_on_new_thread(*that);
     }
     void init() {
       this->thr_ = thread(&future_when_any_vector_shared_state::run, this);
@@ -4774,7 +5713,7 @@ namespace detail
 
     if (first==last) return make_ready_future(container_type());
     shared_ptr<factory_type >
-        h(new factory_type>(detail::input_iterator_tag_value, first,last));
+        h(boost::make_shared<factory_type >(detail::input_iterator_tag_value, first,last));
     return BOOST_THREAD_FUTURE<container_type>(h);
   }
 
@@ -4792,7 +5731,7 @@ namespace detail
     typedef  typename detail::when_type<T0, T...>::factory_all_type factory_type;
 
     shared_ptr<factory_type>
-        h(new factory_type(detail::values_tag_value, boost::forward<T0>(f), boost::forward<T>(futures)...));
+        h(boost::make_shared<factory_type >(detail::values_tag_value, boost::forward<T0>(f), boost::forward<T>(futures)...));
     return BOOST_THREAD_FUTURE<container_type>(h);
   }
 #endif
@@ -4808,7 +5747,7 @@ namespace detail
 
     if (first==last) return make_ready_future(container_type());
     shared_ptr<factory_type >
-        h(new factory_type>(detail::input_iterator_tag_value, first,last));
+        h(boost::make_shared<factory_type >(detail::input_iterator_tag_value, first,last));
     return BOOST_THREAD_FUTURE<container_type>(h);
   }
 
@@ -4826,7 +5765,7 @@ namespace detail
     typedef  typename detail::when_type<T0, T...>::factory_any_type factory_type;
 
     shared_ptr<factory_type>
-        h(new factory_type(detail::values_tag_value, boost::forward<T0>(f), boost::forward<T>(futures)...));
+        h(boost::make_shared<factory_type >(detail::values_tag_value, boost::forward<T0>(f), boost::forward<T>(futures)...));
     return BOOST_THREAD_FUTURE<container_type>(h);
   }
 #endif
@@ -0,0 +1,238 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+// (C) Copyright 2014 Vicente J. Botet Escriba
+
+#ifndef BOOST_THREAD_FUTURE_COROUTINE_HPP
+#define BOOST_THREAD_FUTURE_COROUTINE_HPP
+
+#include <boost/thread/detail/config.hpp>
+#include <boost/thread/future.hpp>
+
+#if defined BOOST_THREAD_PROVIDES_FUTURE_COROUTINES
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+#include <boost/config/abi_prefix.hpp>
+
+namespace boost
+{
+  namespace detail
+  {
+    /////////////////////////
+    /// future_awaiter
+    /////////////////////////
+    // Suspends the awaiting coroutine until the shared state is ready, without blocking any thread. The coroutine is
+    // resumed by the thread making the shared state ready, once it has unlocked it, or by a new thread if the shared
+    // state is made ready by the thread of async(launch::async, ...).
+    template <typename Future>
+    class future_awaiter: future_waiter_node
+    {
+      Future fut_;
+      std::coroutine_handle<> handle_;
+      bool linked_;
+
+      static void resume(future_waiter_node& node)
+      {
+        future_awaiter& self = static_cast<future_awaiter&>(node);
+        self.linked_ = false;
+        self.handle_.resume();
+      }
+    public:
+      explicit future_awaiter(Future&& f) :
+        future_waiter_node(&future_awaiter::resume), fut_(std::move(f)), linked_(false)
+      {
+      }
+      ~future_awaiter()
+      {
+        // the coroutine has been destroyed while suspended.
+        if (linked_)
+        {
+          fut_.future_->remove_external_waiter(*this);
+        }
+      }
+
+      bool await_ready() const
+      {
+        return ! fut_.valid() || fut_.is_ready();
+      }
+      bool await_suspend(std::coroutine_handle<> h)
+      {
+        handle_ = h;
+        linked_ = true;
+        if (! fut_.future_->register_resumption(*this))
+        {
+          linked_ = false;
+          return false;
+        }
+        // *this can already have been resumed and destroyed.
+        return true;
+      }
+      decltype(auto) await_resume()
+      {
+        return fut_.get();
+      }
+    };
+
+    /////////////////////////
+    /// future_coroutine_promise
+    /////////////////////////
+    // promise_type of the coroutines returning BOOST_THREAD_FUTURE<R>. The coroutine starts eagerly and its result
+    // is stored directly in the shared state of the returned future.
+    template <typename R>
+    class future_coroutine_promise_base
+    {
+    protected:
+      shared_ptr<shared_state<R> > state_;
+    public:
+      future_coroutine_promise_base() :
+        state_(boost::make_shared<shared_state<R> >())
+      {
+      }
+      ~future_coroutine_promise_base()
+      {
+        // the coroutine has been destroyed before completing.
+        boost::unique_lock<boost::mutex> lock(state_->mutex);
+        if (! state_->is_done())
+        {
+          state_->mark_exceptional_finish_internal(boost::copy_exception(broken_promise()), lock);
+          lock.unlock();
+          resume_waiters(*state_);
+        }
+      }
+
+      BOOST_THREAD_FUTURE<R> get_return_object()
+      {
+        return BOOST_THREAD_FUTURE<R>(state_);
+      }
+      std::suspend_never initial_suspend() noexcept
+      {
+        return std::suspend_never();
+      }
+      std::suspend_never final_suspend() noexcept
+      {
+        return std::suspend_never();
+      }
+      void unhandled_exception()
+      {
+        state_->mark_exceptional_finish();
+        resume_waiters(*state_);
+      }
+    };
+
+    template <typename R>
+    class future_coroutine_promise: public future_coroutine_promise_base<R>
+    {
+    public:
+      template <typename U>
+      void return_value(U&& value)
+      {
+        this->state_->mark_finished_with_result(std::forward<U>(value));
+        resume_waiters(*this->state_);
+      }
+    };
+
+    template <typename R>
+    class future_coroutine_promise<R&>: public future_coroutine_promise_base<R&>
+    {
+    public:
+      void return_value(R& value)
+      {
+        this->state_->mark_finished_with_result(value);
+        resume_waiters(*this->state_);
+      }
+    };
+
+    template <>
+    class future_coroutine_promise<void>: public future_coroutine_promise_base<void>
+    {
+    public:
+      void return_void()
+      {
+        this->state_->mark_finished_with_result();
+        resume_waiters(*this->state_);
+      }
+    };
+  } // detail
+
+  ////////////////////////////////
+  // operator co_await
+  ////////////////////////////////
+  template <typename R>
+  detail::future_awaiter<BOOST_THREAD_FUTURE<R> > operator co_await(BOOST_THREAD_FUTURE<R>&& f)
+  {
+    return detail::future_awaiter<BOOST_THREAD_FUTURE<R> >(std::move(f));
+  }
+
+  template <typename R>
+  detail::future_awaiter<shared_future<R> > operator co_await(shared_future<R> const& f)
+  {
+    return detail::future_awaiter<shared_future<R> >(shared_future<R>(f));
+  }
+
+  namespace executors
+  {
+    ////////////////////////////////
+    // schedule_on
+    ////////////////////////////////
+    template <typename Executor>
+    class schedule_on_awaiter
+    {
+      Executor& ex_;
+
+      struct resumer
+      {
+        std::coroutine_handle<> handle_;
+        void operator()()
+        {
+          handle_.resume();
+        }
+      };
+    public:
+      explicit schedule_on_awaiter(Executor& ex) :
+        ex_(ex)
+      {
+      }
+      bool await_ready() const noexcept
+      {
+        return false;
+      }
+      void await_suspend(std::coroutine_handle<> h)
+      {
+        resumer r = { h };
+        ex_.submit(r);
+      }
+      void await_resume() const noexcept
+      {
+      }
+    };
+
+    /**
+     * \b Returns: an awaitable that, when awaited, resumes the coroutine on one of the threads of @c ex.
+     *
+     * \b Throws: Whatever exception @c ex.submit() throws, e.g. if the executor is closed.
+     */
+    template <typename Executor>
+    schedule_on_awaiter<Executor> schedule_on(Executor& ex)
+    {
+      return schedule_on_awaiter<Executor>(ex);
+    }
+  }
+  using executors::schedule_on;
+}
+
+namespace std
+{
+  template <typename R, typename... Args>
+  struct coroutine_traits<boost::BOOST_THREAD_FUTURE<R>, Args...>
+  {
+    typedef boost::detail::future_coroutine_promise<R> promise_type;
+  };
+}
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif // BOOST_THREAD_PROVIDES_FUTURE_COROUTINES
+#endif
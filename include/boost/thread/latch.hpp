@@ -13,6 +13,7 @@
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/lock_types.hpp>
 #include <boost/thread/condition_variable.hpp>
+#include <boost/atomic.hpp>
 #include <boost/chrono/duration.hpp>
 #include <boost/chrono/time_point.hpp>
 #include <boost/assert.hpp>
@@ -21,35 +22,20 @@
 
 namespace boost
 {
+  /**
+   * The count is an atomic: a count down that doesn't reach zero is a single atomic decrement. The mutex only protects
+   * the generation, incremented by the count down that reaches zero before it notifies the waiters.
+   */
   class latch
   {
-    /// @Requires: count_ must be greater than 0
-    /// Effect: Decrement the count. Unlocks the lock and notify anyone waiting if we reached zero.
-    /// Returns: true if count_ reached the value 0.
-    /// @ThreadSafe ensured by the @c lk parameter
-    bool count_down(unique_lock<mutex> &lk)
-    /// pre_condition (count_ > 0)
+    /// Effect: Increments the generation and notifies anyone waiting. Called by the count down that reached zero.
+    void notify_zero()
     {
-      BOOST_ASSERT(count_ > 0);
-      if (--count_ == 0)
       {
+        boost::lock_guard<boost::mutex> lk(mutex_);
         ++generation_;
-        lk.unlock();
-        cond_.notify_all();
-        return true;
       }
-      return false;
-    }
-    /// Effect: Decrement the count is > 0. Unlocks the lock notify anyone waiting if we reached zero.
-    /// Returns: true if count_ is 0.
-    /// @ThreadSafe ensured by the @c lk parameter
-    bool try_count_down(unique_lock<mutex> &lk)
-    {
-      if (count_ > 0)
-      {
-        return count_down(lk);
-      }
-      return true;
+      cond_.notify_all();
     }
   public:
     BOOST_THREAD_NO_COPYABLE( latch)
@@ -79,8 +65,7 @@ namespace boost
     /// @return true if the internal counter is already 0, false otherwise
     bool try_wait()
     {
-      boost::unique_lock<boost::mutex> lk(mutex_);
-      return (count_ == 0);
+      return count_.load(memory_order_acquire) == 0;
     }
 
     /// try to wait for a specified amount of time is elapsed.
@@ -111,15 +96,31 @@ namespace boost
     /// @Requires count must be greater than 0
     void count_down()
     {
-      boost::unique_lock<boost::mutex> lk(mutex_);
-      count_down(lk);
+      std::size_t const count = count_.fetch_sub(1, memory_order_acq_rel);
+      BOOST_ASSERT(count > 0);
+      if (count == 1)
+      {
+        notify_zero();
+      }
     }
     /// Effect: Decrement the count if it is > 0 and notify anyone waiting if we reached zero.
     /// Returns: true if count_ was 0 or reached 0.
     bool try_count_down()
     {
-      boost::unique_lock<boost::mutex> lk(mutex_);
-      return try_count_down(lk);
+      std::size_t count = count_.load(memory_order_relaxed);
+      do
+      {
+        if (count == 0)
+        {
+          return true;
+        }
+      } while (! count_.compare_exchange_weak(count, count - 1, memory_order_acq_rel, memory_order_relaxed));
+      if (count == 1)
+      {
+        notify_zero();
+        return true;
+      }
+      return false;
     }
     void signal()
     {
@@ -133,10 +134,16 @@ namespace boost
     {
       boost::unique_lock<boost::mutex> lk(mutex_);
       std::size_t generation(generation_);
-      if (count_down(lk))
+      std::size_t const count = count_.fetch_sub(1, memory_order_acq_rel);
+      BOOST_ASSERT(count > 0);
+      if (count == 1)
       {
+        ++generation_;
+        lk.unlock();
+        cond_.notify_all();
         return;
       }
+      // the count down reaching zero must lock the mutex to change the generation.
       cond_.wait(lk, detail::not_equal(generation, generation_));
     }
     void sync()
@@ -150,13 +157,13 @@ namespace boost
     {
       boost::lock_guard<boost::mutex> lk(mutex_);
       //BOOST_ASSERT(count_ == 0);
-      count_ = count;
+      count_.store(count, memory_order_release);
     }
 
   private:
     mutex mutex_;
     condition_variable cond_;
-    std::size_t count_;
+    atomic<std::size_t> count_;
     std::size_t generation_;
   };
 
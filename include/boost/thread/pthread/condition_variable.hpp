@@ -55,6 +55,34 @@ namespace boost
         };
     }
 
+#if defined BOOST_THREAD_CONDITION_VARIABLE_USES_FUTEX
+    // called by thread::interrupt() while the interrupted thread waits, wakes all the waiters.
+    inline void condition_variable::wake_for_interruption(void* cv)
+    {
+        static_cast<condition_variable*>(cv)->sequence.notify_all();
+    }
+
+    // Returns: 0 if woken, ETIMEDOUT once timeout is reached, see detail::futex_wait_until().
+    inline int condition_variable::futex_wait_until(unique_lock<mutex>& m, struct timespec const* timeout)
+    {
+        int res;
+        {
+            thread_cv_detail::lock_on_exit<unique_lock<mutex> > guard;
+            detail::futex_sequence::waiter waiter(sequence);
+            // registered after the read of the sequence: an interruption either is seen here or changes the sequence.
+            detail::wait_slot_interruption_checker check_for_interruption(this, &condition_variable::wake_for_interruption);
+            guard.activate(m);
+#if defined BOOST_THREAD_HAS_CONDATTR_SET_CLOCK_MONOTONIC
+            res = timeout ? sequence.wait_until(waiter, *timeout, false) : sequence.wait(waiter);
+#else
+            res = timeout ? sequence.wait_until(waiter, *timeout, true) : sequence.wait(waiter);
+#endif
+        }
+        this_thread::interruption_point();
+        return res;
+    }
+#endif
+
     inline void condition_variable::wait(unique_lock<mutex>& m)
     {
 #if defined BOOST_THREAD_THROW_IF_PRECONDITION_NOT_SATISFIED
@@ -63,6 +91,9 @@ namespace boost
             boost::throw_exception(condition_error(-1, "boost::condition_variable::wait() failed precondition mutex not owned"));
         }
 #endif
+#if defined BOOST_THREAD_CONDITION_VARIABLE_USES_FUTEX
+        futex_wait_until(m, 0);
+#else
         int res=0;
         {
 #if defined BOOST_THREAD_PROVIDES_INTERRUPTIONS
@@ -87,6 +118,7 @@ namespace boost
         {
             boost::throw_exception(condition_error(res, "boost::condition_variable::wait failed in pthread_cond_wait"));
         }
+#endif
     }
 
     inline bool condition_variable::do_wait_until(
@@ -99,6 +131,9 @@ namespace boost
             boost::throw_exception(condition_error(EPERM, "boost::condition_variable::do_wait_until() failed precondition mutex not owned"));
         }
 #endif
+#if defined BOOST_THREAD_CONDITION_VARIABLE_USES_FUTEX
+        return futex_wait_until(m, &timeout) != ETIMEDOUT;
+#else
         thread_cv_detail::lock_on_exit<unique_lock<mutex> > guard;
         int cond_res;
         {
@@ -124,22 +159,33 @@ namespace boost
             boost::throw_exception(condition_error(cond_res, "boost::condition_variable::do_wait_until failed in pthread_cond_timedwait"));
         }
         return true;
+#endif
     }
 
     inline void condition_variable::notify_one() BOOST_NOEXCEPT
     {
+#if defined BOOST_THREAD_CONDITION_VARIABLE_USES_FUTEX
+        sequence.notify_one();
+#else
 #if defined BOOST_THREAD_PROVIDES_INTERRUPTIONS
         boost::pthread::pthread_mutex_scoped_lock internal_lock(&internal_mutex);
 #endif
         BOOST_VERIFY(!pthread_cond_signal(&cond));
+#endif
     }
 
     inline void condition_variable::notify_all() BOOST_NOEXCEPT
     {
+#if defined BOOST_THREAD_CONDITION_VARIABLE_USES_FUTEX
+        // the waiters are all woken: they can't be moved to the futex of a pthread_mutex_t, whose unlock only wakes a
+        // waiter when the mutex is marked as contended by the thread that blocked on it.
+        sequence.notify_all();
+#else
 #if defined BOOST_THREAD_PROVIDES_INTERRUPTIONS
         boost::pthread::pthread_mutex_scoped_lock internal_lock(&internal_mutex);
 #endif
         BOOST_VERIFY(!pthread_cond_broadcast(&cond));
+#endif
     }
 
     class condition_variable_any
@@ -156,11 +202,11 @@ namespace boost
             {
                 boost::throw_exception(thread_resource_error(res, "boost::condition_variable_any::condition_variable_any() failed in pthread_mutex_init"));
             }
-            int const res2=pthread_cond_init(&cond,NULL);
+            int const res2=detail::cond_init(cond);
             if(res2)
             {
                 BOOST_VERIFY(!pthread_mutex_destroy(&internal_mutex));
-                boost::throw_exception(thread_resource_error(res, "boost::condition_variable_any::condition_variable_any() failed in pthread_cond_init"));
+                boost::throw_exception(thread_resource_error(res2, "boost::condition_variable_any::condition_variable_any() failed in pthread_cond_init"));
             }
         }
         ~condition_variable_any()
@@ -203,7 +249,7 @@ namespace boost
         bool timed_wait(lock_type& m,boost::system_time const& abs_time)
         {
             struct timespec const timeout=detail::to_timespec(abs_time);
-            return do_wait_until(m, timeout);
+            return do_wait_until(m, detail::timespec_realtime_to_internal(timeout));
         }
         template<typename lock_type>
         bool timed_wait(lock_type& m,xtime const& abs_time)
@@ -245,13 +291,13 @@ namespace boost
         cv_status
         wait_until(
                 lock_type& lock,
-                const chrono::time_point<chrono::system_clock, Duration>& t)
+                const chrono::time_point<boost::detail::internal_clock, Duration>& t)
         {
           using namespace chrono;
-          typedef time_point<system_clock, nanoseconds> nano_sys_tmpt;
+          typedef time_point<boost::detail::internal_clock, nanoseconds> nano_internal_tmpt;
           wait_until(lock,
-                        nano_sys_tmpt(ceil<nanoseconds>(t.time_since_epoch())));
-          return system_clock::now() < t ? cv_status::no_timeout :
+                        nano_internal_tmpt(ceil<nanoseconds>(t.time_since_epoch())));
+          return boost::detail::internal_clock::now() < t ? cv_status::no_timeout :
                                              cv_status::timeout;
         }
 
@@ -262,7 +308,7 @@ namespace boost
                 const chrono::time_point<Clock, Duration>& t)
         {
           using namespace chrono;
-          system_clock::time_point     s_now = system_clock::now();
+          boost::detail::internal_clock::time_point     s_now = boost::detail::internal_clock::now();
           typename Clock::time_point  c_now = Clock::now();
           wait_until(lock, s_now + ceil<nanoseconds>(t - c_now));
           return Clock::now() < t ? cv_status::no_timeout : cv_status::timeout;
@@ -291,9 +337,14 @@ namespace boost
                 const chrono::duration<Rep, Period>& d)
         {
           using namespace chrono;
+#if defined BOOST_THREAD_HAS_CONDATTR_SET_CLOCK_MONOTONIC
+          steady_clock::time_point c_now = steady_clock::now();
+          wait_until(lock, c_now + ceil<nanoseconds>(d));
+#else
           system_clock::time_point s_now = system_clock::now();
           steady_clock::time_point c_now = steady_clock::now();
           wait_until(lock, s_now + ceil<nanoseconds>(d));
+#endif
           return steady_clock::now() - c_now < d ? cv_status::no_timeout :
                                                    cv_status::timeout;
 
@@ -320,7 +371,7 @@ namespace boost
         template <class lock_type>
         cv_status wait_until(
             lock_type& lk,
-            chrono::time_point<chrono::system_clock, chrono::nanoseconds> tp)
+            chrono::time_point<boost::detail::internal_clock, chrono::nanoseconds> tp)
         {
             using namespace chrono;
             nanoseconds d = tp.time_since_epoch();
@@ -343,6 +394,7 @@ namespace boost
         }
     private: // used by boost::thread::try_join_until
 
+        // timeout is an absolute time of the clock of boost::detail::timespec_now_internal().
         template <class lock_type>
         inline bool do_wait_until(
           lock_type& m,
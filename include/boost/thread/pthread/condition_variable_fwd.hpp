@@ -11,6 +11,7 @@
 #include <pthread.h>
 #include <boost/thread/cv_status.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/detail/futex.hpp>
 #include <boost/thread/lock_types.hpp>
 #include <boost/thread/thread_time.hpp>
 #include <boost/thread/pthread/timespec.hpp>
@@ -26,20 +27,47 @@
 
 #include <boost/config/abi_prefix.hpp>
 
+// With the interruptions, condition_variable waits on a futex instead of a pthread_cond_t guarded by an internal mutex.
+#if defined BOOST_THREAD_PROVIDES_INTERRUPTIONS && defined BOOST_THREAD_HAS_FUTEX \
+  && ! defined BOOST_THREAD_DONT_USE_FUTEX_CONDITION_VARIABLE
+#define BOOST_THREAD_CONDITION_VARIABLE_USES_FUTEX
+#endif
+
 namespace boost
 {
+#ifdef BOOST_THREAD_USES_CHRONO
+    namespace detail
+    {
+      /// the clock the condition variables wait on: no conversion is needed for its time points.
+#if defined BOOST_THREAD_HAS_CONDATTR_SET_CLOCK_MONOTONIC
+      typedef chrono::steady_clock internal_clock;
+#else
+      typedef chrono::system_clock internal_clock;
+#endif
+    }
+#endif
 
     class condition_variable
     {
     private:
+#if defined BOOST_THREAD_CONDITION_VARIABLE_USES_FUTEX
+        // A waiter registers itself in the sequence while holding the mutex, and is interrupted through the wait slot
+        // of its thread, which changes the sequence: there is no internal mutex to lock on each wait and notification.
+        detail::futex_sequence sequence;
+
+        static void wake_for_interruption(void* cv);
+        int futex_wait_until(unique_lock<mutex>& m, struct timespec const* timeout);
+#else
 #if defined BOOST_THREAD_PROVIDES_INTERRUPTIONS
         pthread_mutex_t internal_mutex;
 #endif
         pthread_cond_t cond;
+#endif
 
     public:
     //private: // used by boost::thread::try_join_until
 
+        // timeout is an absolute time of the clock of boost::detail::timespec_now_internal().
         inline bool do_wait_until(
             unique_lock<mutex>& lock,
             struct timespec const &timeout);
@@ -48,11 +76,16 @@ namespace boost
             unique_lock<mutex>& lock,
             struct timespec const &timeout)
         {
-          return do_wait_until(lock, boost::detail::timespec_plus(timeout, boost::detail::timespec_now()));
+          return do_wait_until(lock, boost::detail::timespec_plus(timeout, boost::detail::timespec_now_internal()));
         }
 
     public:
       BOOST_THREAD_NO_COPYABLE(condition_variable)
+#if defined BOOST_THREAD_CONDITION_VARIABLE_USES_FUTEX
+        condition_variable()
+        {
+        }
+#else
         condition_variable()
         {
 #if defined BOOST_THREAD_PROVIDES_INTERRUPTIONS
@@ -62,7 +95,7 @@ namespace boost
                 boost::throw_exception(thread_resource_error(res, "boost::condition_variable::condition_variable() constructor failed in pthread_mutex_init"));
             }
 #endif
-            int const res2=pthread_cond_init(&cond,NULL);
+            int const res2=detail::cond_init(cond);
             if(res2)
             {
 #if defined BOOST_THREAD_PROVIDES_INTERRUPTIONS
@@ -85,6 +118,7 @@ namespace boost
             } while (ret == EINTR);
             BOOST_ASSERT(!ret);
         }
+#endif
 
         void wait(unique_lock<mutex>& m);
 
@@ -102,10 +136,10 @@ namespace boost
         {
 #if defined BOOST_THREAD_WAIT_BUG
             struct timespec const timeout=detail::to_timespec(abs_time + BOOST_THREAD_WAIT_BUG);
-            return do_wait_until(m, timeout);
+            return do_wait_until(m, detail::timespec_realtime_to_internal(timeout));
 #else
             struct timespec const timeout=detail::to_timespec(abs_time);
-            return do_wait_until(m, timeout);
+            return do_wait_until(m, detail::timespec_realtime_to_internal(timeout));
 #endif
         }
         bool timed_wait(
@@ -159,13 +193,13 @@ namespace boost
         cv_status
         wait_until(
                 unique_lock<mutex>& lock,
-                const chrono::time_point<chrono::system_clock, Duration>& t)
+                const chrono::time_point<boost::detail::internal_clock, Duration>& t)
         {
           using namespace chrono;
-          typedef time_point<system_clock, nanoseconds> nano_sys_tmpt;
+          typedef time_point<boost::detail::internal_clock, nanoseconds> nano_internal_tmpt;
           wait_until(lock,
-                        nano_sys_tmpt(ceil<nanoseconds>(t.time_since_epoch())));
-          return system_clock::now() < t ? cv_status::no_timeout :
+                        nano_internal_tmpt(ceil<nanoseconds>(t.time_since_epoch())));
+          return boost::detail::internal_clock::now() < t ? cv_status::no_timeout :
                                              cv_status::timeout;
         }
 
@@ -176,7 +210,7 @@ namespace boost
                 const chrono::time_point<Clock, Duration>& t)
         {
           using namespace chrono;
-          system_clock::time_point     s_now = system_clock::now();
+          boost::detail::internal_clock::time_point     s_now = boost::detail::internal_clock::now();
           typename Clock::time_point  c_now = Clock::now();
           wait_until(lock, s_now + ceil<nanoseconds>(t - c_now));
           return Clock::now() < t ? cv_status::no_timeout : cv_status::timeout;
@@ -205,9 +239,14 @@ namespace boost
                 const chrono::duration<Rep, Period>& d)
         {
           using namespace chrono;
+#if defined BOOST_THREAD_HAS_CONDATTR_SET_CLOCK_MONOTONIC
+          steady_clock::time_point c_now = steady_clock::now();
+          wait_until(lock, c_now + ceil<nanoseconds>(d));
+#else
           system_clock::time_point s_now = system_clock::now();
           steady_clock::time_point c_now = steady_clock::now();
           wait_until(lock, s_now + ceil<nanoseconds>(d));
+#endif
           return steady_clock::now() - c_now < d ? cv_status::no_timeout :
                                                    cv_status::timeout;
 
@@ -232,12 +271,14 @@ namespace boost
         }
 #endif
 
+#if ! defined BOOST_THREAD_CONDITION_VARIABLE_USES_FUTEX
 #define BOOST_THREAD_DEFINES_CONDITION_VARIABLE_NATIVE_HANDLE
         typedef pthread_cond_t* native_handle_type;
         native_handle_type native_handle()
         {
             return &cond;
         }
+#endif
 
         void notify_one() BOOST_NOEXCEPT;
         void notify_all() BOOST_NOEXCEPT;
@@ -245,7 +286,7 @@ namespace boost
 #ifdef BOOST_THREAD_USES_CHRONO
         inline cv_status wait_until(
             unique_lock<mutex>& lk,
-            chrono::time_point<chrono::system_clock, chrono::nanoseconds> tp)
+            chrono::time_point<boost::detail::internal_clock, chrono::nanoseconds> tp)
         {
             using namespace chrono;
             nanoseconds d = tp.time_since_epoch();
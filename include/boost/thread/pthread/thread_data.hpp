@@ -8,6 +8,7 @@
 
 #include <boost/thread/detail/config.hpp>
 #include <boost/thread/exceptions.hpp>
+#include <boost/throw_exception.hpp>
 #include <boost/thread/lock_guard.hpp>
 #include <boost/thread/lock_types.hpp>
 #include <boost/thread/mutex.hpp>
@@ -21,6 +22,7 @@
 #endif
 
 #include <map>
+#include <string>
 #include <vector>
 #include <utility>
 
@@ -29,15 +31,25 @@
 #endif
 
 #include <pthread.h>
+#include <sched.h>
 #include <unistd.h>
 
 #include <boost/config/abi_prefix.hpp>
 
 namespace boost
 {
+#if defined BOOST_THREAD_LINUX && defined CPU_SET
+#define BOOST_THREAD_DEFINES_THREAD_ATTRIBUTES_CPU_SET
+    namespace detail
+    {
+        /// Returns: whether the CPUs of NUMA node @c node could be stored in @c cpus.
+        BOOST_THREAD_DECL bool get_numa_node_cpus(unsigned node, cpu_set_t& cpus);
+    }
+#endif
+
     class thread_attributes {
     public:
-        thread_attributes() BOOST_NOEXCEPT {
+        thread_attributes() BOOST_NOEXCEPT : numa_node_(-1) {
             int res = pthread_attr_init(&val_);
             BOOST_VERIFY(!res && "pthread_attr_init failed");
         }
@@ -63,6 +75,74 @@ namespace boost
             BOOST_VERIFY(!res && "pthread_attr_getstacksize failed");
             return size;
         }
+        // affinity
+#if defined BOOST_THREAD_DEFINES_THREAD_ATTRIBUTES_CPU_SET
+        typedef cpu_set_t cpu_set_type;
+        void set_affinity(cpu_set_type const& cpus) BOOST_NOEXCEPT {
+          int res = pthread_attr_setaffinity_np(&val_, sizeof(cpus), &cpus);
+          BOOST_VERIFY(!res && "pthread_attr_setaffinity_np failed");
+        }
+#endif
+        /// Binds the thread to @c cpu. Ignored on the platforms that don't support it.
+        void set_affinity(unsigned cpu) BOOST_NOEXCEPT {
+#if defined BOOST_THREAD_DEFINES_THREAD_ATTRIBUTES_CPU_SET
+          cpu_set_type cpus;
+          CPU_ZERO(&cpus);
+          CPU_SET(cpu, &cpus);
+          set_affinity(cpus);
+#else
+          (void)cpu;
+#endif
+        }
+
+        // numa
+        /// Binds the thread to the CPUs of NUMA node @c node and makes the thread allocate its memory from this
+        /// node preferably. Ignored on the platforms that don't support it.
+        void set_numa_node(unsigned node) BOOST_NOEXCEPT {
+          numa_node_ = static_cast<int>(node);
+#if defined BOOST_THREAD_DEFINES_THREAD_ATTRIBUTES_CPU_SET
+          cpu_set_type cpus;
+          if (detail::get_numa_node_cpus(node, cpus)) set_affinity(cpus);
+#endif
+        }
+        /// Returns: the NUMA node set with @c set_numa_node(), or -1.
+        int get_numa_node() const BOOST_NOEXCEPT {
+          return numa_node_;
+        }
+
+        // scheduling
+        /// Sets the scheduling policy and priority of the thread, e.g. @c SCHED_FIFO, instead of inheriting the ones
+        /// of the creating thread. The creation of the thread fails if the process is not allowed to use them.
+        /// Throws: thread_resource_error if the policy or the priority is invalid. The attributes are unchanged then.
+        void set_sched_policy(int policy, int priority) {
+          int old_policy;
+          int res = pthread_attr_getschedpolicy(&val_, &old_policy);
+          BOOST_VERIFY(!res && "pthread_attr_getschedpolicy failed");
+          res = pthread_attr_setschedpolicy(&val_, policy);
+          if (res) {
+            boost::throw_exception(thread_resource_error(res, "boost::thread_attributes::set_sched_policy failed in pthread_attr_setschedpolicy"));
+          }
+          sched_param param;
+          param.sched_priority = priority;
+          res = pthread_attr_setschedparam(&val_, &param);
+          if (res) {
+            pthread_attr_setschedpolicy(&val_, old_policy);
+            boost::throw_exception(thread_resource_error(res, "boost::thread_attributes::set_sched_policy failed in pthread_attr_setschedparam"));
+          }
+          res = pthread_attr_setinheritsched(&val_, PTHREAD_EXPLICIT_SCHED);
+          BOOST_VERIFY(!res && "pthread_attr_setinheritsched failed");
+        }
+
+        // name
+        /// Sets the name of the thread, as shown by the debuggers and the system tools. Linux truncates it to 15
+        /// characters.
+        void set_name(std::string const& name) {
+          name_ = name;
+        }
+        std::string const& get_name() const BOOST_NOEXCEPT {
+          return name_;
+        }
+
 #define BOOST_THREAD_DEFINES_THREAD_ATTRIBUTES_NATIVE_HANDLE
 
         typedef pthread_attr_t native_handle_type;
@@ -75,6 +155,8 @@ namespace boost
 
     private:
         pthread_attr_t val_;
+        std::string name_;
+        int numa_node_;
     };
 
     class thread;
@@ -115,6 +197,10 @@ namespace boost
 
             pthread_mutex_t* cond_mutex;
             pthread_cond_t* current_cond;
+            // the wait slot of a thread blocked on a condition variable that is not a pthread_cond_t:
+            // interrupt() calls current_wait_wake(current_wait) under data_mutex.
+            void* current_wait;
+            void (*current_wait_wake)(void*);
             typedef std::vector<std::pair<condition_variable*, mutex*>
             //, hidden_allocator<std::pair<condition_variable*, mutex*> >
             > notify_list_t;
@@ -123,6 +209,10 @@ namespace boost
             typedef std::vector<shared_ptr<shared_state_base> > async_states_t;
             async_states_t async_states_;
 
+            // set by the thread itself when it starts.
+            std::string name;
+            int numa_node;
+
 //#if defined BOOST_THREAD_PROVIDES_INTERRUPTIONS
             // These data must be at the end so that the access to the other fields doesn't change
             // when BOOST_THREAD_PROVIDES_INTERRUPTIONS is defined.
@@ -136,8 +226,12 @@ namespace boost
                 thread_exit_callbacks(0),
                 cond_mutex(0),
                 current_cond(0),
+                current_wait(0),
+                current_wait_wake(0),
                 notify(),
-                async_states_()
+                async_states_(),
+                name(),
+                numa_node(-1)
 //#if defined BOOST_THREAD_PROVIDES_INTERRUPTIONS
                 , interrupt_enabled(true)
                 , interrupt_requested(false)
@@ -214,6 +308,46 @@ namespace boost
                 }
             }
         };
+
+        /**
+         * Registers the wait slot @c slot of the current thread, so that @c thread::interrupt() wakes it up by
+         * calling @c wake(slot), and throws @c thread_interrupted if an interruption has already been requested.
+         */
+        class wait_slot_interruption_checker
+        {
+            thread_data_base* const thread_info;
+            bool set;
+
+            void operator=(wait_slot_interruption_checker&);
+        public:
+            wait_slot_interruption_checker(void* slot, void (*wake)(void*)):
+                thread_info(detail::get_current_thread_data()),
+                set(thread_info && thread_info->interrupt_enabled)
+            {
+                if(set)
+                {
+                    lock_guard<mutex> guard(thread_info->data_mutex);
+#ifndef BOOST_NO_EXCEPTIONS
+                    if(thread_info->interrupt_requested)
+                    {
+                        thread_info->interrupt_requested=false;
+                        throw thread_interrupted(); // BOOST_NO_EXCEPTIONS protected
+                    }
+#endif
+                    thread_info->current_wait=slot;
+                    thread_info->current_wait_wake=wake;
+                }
+            }
+            ~wait_slot_interruption_checker()
+            {
+                if(set)
+                {
+                    lock_guard<mutex> guard(thread_info->data_mutex);
+                    thread_info->current_wait=NULL;
+                    thread_info->current_wait_wake=NULL;
+                }
+            }
+        };
 #endif
     }
 
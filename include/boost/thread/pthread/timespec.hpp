@@ -9,6 +9,7 @@
 
 #include <boost/thread/detail/config.hpp>
 #include <boost/thread/thread_time.hpp>
+#include <boost/assert.hpp>
 #if defined BOOST_THREAD_USES_DATETIME
 #include <boost/date_time/posix_time/conversion.hpp>
 #endif
@@ -88,6 +89,42 @@ namespace boost
 #endif
       return ts;
     }
+#if defined BOOST_THREAD_HAS_CONDATTR_SET_CLOCK_MONOTONIC
+    inline timespec timespec_now_monotonic()
+    {
+      timespec ts;
+      if ( ::clock_gettime( CLOCK_MONOTONIC, &ts ) )
+      {
+        BOOST_ASSERT(0 && "Boost::Thread - Internal Error");
+      }
+      return ts;
+    }
+#endif
+    /// Returns: the current time of the clock the condition variables wait on.
+    inline timespec timespec_now_internal()
+    {
+#if defined BOOST_THREAD_HAS_CONDATTR_SET_CLOCK_MONOTONIC
+      return timespec_now_monotonic();
+#else
+      return timespec_now();
+#endif
+    }
+    /// Effects: initializes @c cond to wait on the clock of @c timespec_now_internal().
+    /// Returns: the error of @c pthread_cond_init().
+    inline int cond_init(pthread_cond_t& cond)
+    {
+#if defined BOOST_THREAD_HAS_CONDATTR_SET_CLOCK_MONOTONIC
+      pthread_condattr_t attr;
+      int res = pthread_condattr_init(&attr);
+      if (res) return res;
+      res = pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+      if (!res) res = pthread_cond_init(&cond, &attr);
+      BOOST_VERIFY(!pthread_condattr_destroy(&attr));
+      return res;
+#else
+      return pthread_cond_init(&cond, NULL);
+#endif
+    }
     inline timespec timespec_zero()
     {
       timespec ts;
@@ -111,6 +148,15 @@ namespace boost
     {
       return to_nanoseconds_int_max(lhs) >= to_nanoseconds_int_max(rhs);
     }
+    /// Returns: the absolute time @c ts of @c CLOCK_REALTIME as an absolute time of the clock the condition variables wait on.
+    inline timespec timespec_realtime_to_internal(timespec const& ts)
+    {
+#if defined BOOST_THREAD_HAS_CONDATTR_SET_CLOCK_MONOTONIC
+      return timespec_plus(timespec_now_monotonic(), timespec_minus(ts, timespec_now()));
+#else
+      return ts;
+#endif
+    }
 
   }
 }
@@ -0,0 +1,537 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_THREAD_READER_BIASED_SHARED_MUTEX_HPP
+#define BOOST_THREAD_READER_BIASED_SHARED_MUTEX_HPP
+
+#include <boost/thread/detail/config.hpp>
+#include <boost/thread/detail/delete.hpp>
+#include <boost/thread/detail/this_thread_token.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/lock_types.hpp>
+#include <boost/thread/lock_guard.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread_only.hpp>
+#include <boost/thread/lockable_traits.hpp>
+#if defined BOOST_THREAD_USES_DATETIME
+#include <boost/thread/thread_time.hpp>
+#endif
+#ifdef BOOST_THREAD_USES_CHRONO
+#include <boost/chrono/system_clocks.hpp>
+#endif
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <cstddef>
+
+#include <boost/config/abi_prefix.hpp>
+
+namespace boost
+{
+  /**
+   * A reader-biased adapter of a @c SharedMutex, which scales the shared locking of read-mostly data with the number
+   * of readers.
+   *
+   * While the lock is biased towards the readers, @c lock_shared() only records the calling thread in one of the
+   * @c slot_count reader slots of the lock, each on its own cache line, instead of updating the state of the
+   * underlying mutex, and @c unlock_shared() clears the slot. The writers revoke the bias: once they own the
+   * underlying mutex they wait for the readers recorded in the slots to leave. The readers then go through the
+   * underlying mutex, and re-enable the bias after @c inhibit_reads of them have done so since the last
+   * revocation. A reader whose slot is used by another thread goes through the underlying mutex as well. A writer
+   * waiting for the readers of the slots yields a few times and then blocks until the last of them leaves.
+   *
+   * It provides the interface of the @c SharedMutex, including the timed and upgrade operations and the
+   * conversions. The upgrade ownership is always taken on the underlying mutex, and is compatible with the readers
+   * recorded in the slots. The operations that are not provided by the @c SharedMutex can not be used.
+   */
+  template <class SharedMutex>
+  class basic_reader_biased_shared_mutex
+  {
+  public:
+    /// the number of reader slots of each lock.
+    BOOST_STATIC_CONSTANT(std::size_t, slot_count = 32);
+    /// the number of readers going through the underlying mutex after a revocation before the bias is restored.
+    BOOST_STATIC_CONSTANT(long, inhibit_reads = 64);
+    /// the number of times a writer yields while waiting for the readers of the slots, before blocking.
+    BOOST_STATIC_CONSTANT(unsigned, revoke_spins = 100);
+
+  private:
+    struct slot
+    {
+      /// the token of the thread recorded in the slot, or 0.
+      atomic<boost::uintmax_t> owner;
+      char pad_[64];
+    };
+
+    slot slots_[slot_count];
+    atomic<bool> read_bias_;
+    atomic<long> inhibit_;
+    /// whether readers can still be recorded in the slots since the last revocation, protected by the writers.
+    bool draining_;
+    /// whether a writer is blocked until the readers of the slots leave.
+    atomic<bool> revoking_;
+    char pad_[64];
+    SharedMutex mutex_;
+    mutex drain_mutex_;
+    condition_variable drain_cond_;
+
+    atomic<boost::uintmax_t>& slot_of(boost::uintmax_t token)
+    {
+      // the tokens can be aligned addresses: mixes the bits before taking the index.
+      boost::uint64_t h = static_cast<boost::uint64_t>(token) * ((boost::uint64_t(0x9E3779B9u) << 32) | 0x7F4A7C15u);
+      return slots_[static_cast<std::size_t>(h >> 32) % slot_count].owner;
+    }
+
+    /// Effects: records the calling thread as a reader in its slot if the lock is biased towards the readers.
+    /// Returns: whether it has been recorded.
+    bool try_lock_shared_biased()
+    {
+      if (!read_bias_.load(memory_order_relaxed)) return false;
+      boost::uintmax_t const token = detail::this_thread_token();
+      atomic<boost::uintmax_t>& s = slot_of(token);
+      boost::uintmax_t expected = 0;
+      if (!s.compare_exchange_strong(expected, token, memory_order_seq_cst)) return false;
+      // either the writer revoking the bias sees the slot, or the reader sees the revocation.
+      if (read_bias_.load(memory_order_seq_cst)) return true;
+      release_slot(s);
+      return false;
+    }
+
+    /// Effects: clears the slot @c s of the calling thread, waking the writer blocked in the revocation if any.
+    void release_slot(atomic<boost::uintmax_t>& s)
+    {
+      // either the blocked writer sees the slot cleared, or the reader sees the writer.
+      s.store(0, memory_order_seq_cst);
+      if (revoking_.load(memory_order_seq_cst))
+      {
+        {
+          lock_guard<mutex> lk(drain_mutex_);
+        }
+        drain_cond_.notify_all();
+      }
+    }
+
+    /// Effects: releases the slot of the calling thread if it holds the lock through it.
+    /// Returns: whether it held the lock through its slot.
+    bool unlock_shared_biased()
+    {
+      boost::uintmax_t const token = detail::this_thread_token();
+      atomic<boost::uintmax_t>& s = slot_of(token);
+      if (s.load(memory_order_relaxed) != token) return false;
+      release_slot(s);
+      return true;
+    }
+
+    /// Requires: shared ownership of the underlying mutex.
+    /// Effects: counts a reader that went through the underlying mutex, re-enabling the bias after enough of them.
+    void lock_shared_slow_path_taken()
+    {
+      if (read_bias_.load(memory_order_relaxed)) return;
+      if (inhibit_.fetch_sub(1, memory_order_relaxed) <= 1)
+      {
+        read_bias_.store(true, memory_order_seq_cst);
+      }
+    }
+
+    /// Requires: shared ownership of the lock by the calling thread.
+    /// Effects: moves the ownership of the calling thread from its slot to the underlying mutex, if needed.
+    /// Returns: whether the calling thread has shared ownership of the underlying mutex.
+    bool try_move_shared_to_mutex()
+    {
+      boost::uintmax_t const token = detail::this_thread_token();
+      atomic<boost::uintmax_t>& s = slot_of(token);
+      if (s.load(memory_order_relaxed) != token) return true;
+      // a writer revoking the bias can own the underlying mutex while waiting for this slot: don't block.
+      if (!mutex_.try_lock_shared()) return false;
+      release_slot(s);
+      return true;
+    }
+
+    /// Requires: exclusive ownership of the underlying mutex.
+    /// Effects: revokes the bias.
+    /// Returns: whether no reader is recorded in the slots.
+    bool try_revoke_read_bias()
+    {
+      if (read_bias_.load(memory_order_relaxed))
+      {
+        read_bias_.store(false, memory_order_seq_cst);
+        inhibit_.store(inhibit_reads, memory_order_relaxed);
+        draining_ = true;
+      }
+      if (!draining_) return true;
+      for (std::size_t i = 0; i < slot_count; ++i)
+      {
+        if (slots_[i].owner.load(memory_order_seq_cst) != 0) return false;
+      }
+      // the readers recording themselves from now on see the revocation and leave their slot.
+      draining_ = false;
+      return true;
+    }
+
+    /// Requires: exclusive ownership of the underlying mutex.
+    /// Returns: whether the bias has been revoked after yielding a few times.
+    bool try_revoke_read_bias_spinning()
+    {
+      for (unsigned i = 0; i < revoke_spins; ++i)
+      {
+        if (try_revoke_read_bias()) return true;
+        this_thread::yield();
+      }
+      return false;
+    }
+
+    /// Marks the calling writer as blocked until the readers of the slots leave.
+    struct revoking
+    {
+      atomic<bool>& revoking_;
+      explicit revoking(atomic<bool>& r) : revoking_(r)
+      {
+        revoking_.store(true, memory_order_seq_cst);
+      }
+      ~revoking()
+      {
+        revoking_.store(false, memory_order_relaxed);
+      }
+    };
+
+    /// Requires: exclusive ownership of the underlying mutex.
+    /// Effects: revokes the bias and waits for the readers recorded in the slots to leave.
+    void revoke_read_bias()
+    {
+      if (try_revoke_read_bias_spinning()) return;
+#if defined BOOST_THREAD_PROVIDES_INTERRUPTIONS
+      // the callers own the underlying mutex: the wait is not an interruption point.
+      this_thread::disable_interruption no_interruption;
+#endif
+      unique_lock<mutex> lk(drain_mutex_);
+      revoking r(revoking_);
+      while (!try_revoke_read_bias())
+      {
+        drain_cond_.wait(lk);
+      }
+    }
+
+#if defined BOOST_THREAD_USES_DATETIME
+    bool revoke_read_bias_until(system_time const& timeout)
+    {
+      if (try_revoke_read_bias_spinning()) return true;
+#if defined BOOST_THREAD_PROVIDES_INTERRUPTIONS
+      // the callers own the underlying mutex: the wait is not an interruption point.
+      this_thread::disable_interruption no_interruption;
+#endif
+      unique_lock<mutex> lk(drain_mutex_);
+      revoking r(revoking_);
+      while (!try_revoke_read_bias())
+      {
+        if (!drain_cond_.timed_wait(lk, timeout)) return try_revoke_read_bias();
+      }
+      return true;
+    }
+#endif
+#ifdef BOOST_THREAD_USES_CHRONO
+    template <class Clock, class Duration>
+    bool revoke_read_bias_until(const chrono::time_point<Clock, Duration>& abs_time)
+    {
+      if (try_revoke_read_bias_spinning()) return true;
+#if defined BOOST_THREAD_PROVIDES_INTERRUPTIONS
+      // the callers own the underlying mutex: the wait is not an interruption point.
+      this_thread::disable_interruption no_interruption;
+#endif
+      unique_lock<mutex> lk(drain_mutex_);
+      revoking r(revoking_);
+      while (!try_revoke_read_bias())
+      {
+        if (drain_cond_.wait_until(lk, abs_time) == cv_status::timeout) return try_revoke_read_bias();
+      }
+      return true;
+    }
+#endif
+
+  public:
+    typedef SharedMutex mutex_type;
+
+    BOOST_THREAD_NO_COPYABLE(basic_reader_biased_shared_mutex)
+
+    basic_reader_biased_shared_mutex() :
+      read_bias_(true), inhibit_(0), draining_(false), revoking_(false)
+    {
+      for (std::size_t i = 0; i < slot_count; ++i)
+      {
+        slots_[i].owner.store(0, memory_order_relaxed);
+      }
+    }
+
+    // Shared ownership
+
+    void lock_shared()
+    {
+      if (try_lock_shared_biased()) return;
+      mutex_.lock_shared();
+      lock_shared_slow_path_taken();
+    }
+
+    bool try_lock_shared()
+    {
+      if (try_lock_shared_biased()) return true;
+      if (!mutex_.try_lock_shared()) return false;
+      lock_shared_slow_path_taken();
+      return true;
+    }
+
+#if defined BOOST_THREAD_USES_DATETIME
+    bool timed_lock_shared(system_time const& timeout)
+    {
+      if (try_lock_shared_biased()) return true;
+      if (!mutex_.timed_lock_shared(timeout)) return false;
+      lock_shared_slow_path_taken();
+      return true;
+    }
+
+    template<typename TimeDuration>
+    bool timed_lock_shared(TimeDuration const & relative_time)
+    {
+      return timed_lock_shared(get_system_time()+relative_time);
+    }
+#endif
+#ifdef BOOST_THREAD_USES_CHRONO
+    template <class Rep, class Period>
+    bool try_lock_shared_for(const chrono::duration<Rep, Period>& rel_time)
+    {
+      return try_lock_shared_until(chrono::steady_clock::now() + rel_time);
+    }
+    template <class Clock, class Duration>
+    bool try_lock_shared_until(const chrono::time_point<Clock, Duration>& abs_time)
+    {
+      if (try_lock_shared_biased()) return true;
+      if (!mutex_.try_lock_shared_until(abs_time)) return false;
+      lock_shared_slow_path_taken();
+      return true;
+    }
+#endif
+
+    void unlock_shared()
+    {
+      if (unlock_shared_biased()) return;
+      mutex_.unlock_shared();
+    }
+
+    // Exclusive ownership
+
+    void lock()
+    {
+      mutex_.lock();
+      revoke_read_bias();
+    }
+
+    bool try_lock()
+    {
+      if (!mutex_.try_lock()) return false;
+      if (try_revoke_read_bias()) return true;
+      mutex_.unlock();
+      return false;
+    }
+
+#if defined BOOST_THREAD_USES_DATETIME
+    bool timed_lock(system_time const& timeout)
+    {
+      if (!mutex_.timed_lock(timeout)) return false;
+      if (revoke_read_bias_until(timeout)) return true;
+      mutex_.unlock();
+      return false;
+    }
+
+    template<typename TimeDuration>
+    bool timed_lock(TimeDuration const & relative_time)
+    {
+      return timed_lock(get_system_time()+relative_time);
+    }
+#endif
+#ifdef BOOST_THREAD_USES_CHRONO
+    template <class Rep, class Period>
+    bool try_lock_for(const chrono::duration<Rep, Period>& rel_time)
+    {
+      return try_lock_until(chrono::steady_clock::now() + rel_time);
+    }
+    template <class Clock, class Duration>
+    bool try_lock_until(const chrono::time_point<Clock, Duration>& abs_time)
+    {
+      if (!mutex_.try_lock_until(abs_time)) return false;
+      if (revoke_read_bias_until(abs_time)) return true;
+      mutex_.unlock();
+      return false;
+    }
+#endif
+
+    void unlock()
+    {
+      mutex_.unlock();
+    }
+
+    // Upgrade ownership
+
+    void lock_upgrade()
+    {
+      mutex_.lock_upgrade();
+    }
+
+    bool try_lock_upgrade()
+    {
+      return mutex_.try_lock_upgrade();
+    }
+
+#if defined BOOST_THREAD_USES_DATETIME
+    bool timed_lock_upgrade(system_time const& timeout)
+    {
+      return mutex_.timed_lock_upgrade(timeout);
+    }
+
+    template<typename TimeDuration>
+    bool timed_lock_upgrade(TimeDuration const & relative_time)
+    {
+      return timed_lock_upgrade(get_system_time()+relative_time);
+    }
+#endif
+#ifdef BOOST_THREAD_USES_CHRONO
+    template <class Rep, class Period>
+    bool try_lock_upgrade_for(const chrono::duration<Rep, Period>& rel_time)
+    {
+      return try_lock_upgrade_until(chrono::steady_clock::now() + rel_time);
+    }
+    template <class Clock, class Duration>
+    bool try_lock_upgrade_until(const chrono::time_point<Clock, Duration>& abs_time)
+    {
+      return mutex_.try_lock_upgrade_until(abs_time);
+    }
+#endif
+
+    void unlock_upgrade()
+    {
+      mutex_.unlock_upgrade();
+    }
+
+    // Upgrade <-> Exclusive
+
+    void unlock_upgrade_and_lock()
+    {
+      mutex_.unlock_upgrade_and_lock();
+      revoke_read_bias();
+    }
+
+    void unlock_and_lock_upgrade()
+    {
+      mutex_.unlock_and_lock_upgrade();
+    }
+
+    bool try_unlock_upgrade_and_lock()
+    {
+      if (!mutex_.try_unlock_upgrade_and_lock()) return false;
+      if (try_revoke_read_bias()) return true;
+      mutex_.unlock_and_lock_upgrade();
+      return false;
+    }
+
+#ifdef BOOST_THREAD_USES_CHRONO
+    template <class Rep, class Period>
+    bool try_unlock_upgrade_and_lock_for(const chrono::duration<Rep, Period>& rel_time)
+    {
+      return try_unlock_upgrade_and_lock_until(chrono::steady_clock::now() + rel_time);
+    }
+    template <class Clock, class Duration>
+    bool try_unlock_upgrade_and_lock_until(const chrono::time_point<Clock, Duration>& abs_time)
+    {
+      if (!mutex_.try_unlock_upgrade_and_lock_until(abs_time)) return false;
+      if (revoke_read_bias_until(abs_time)) return true;
+      mutex_.unlock_and_lock_upgrade();
+      return false;
+    }
+#endif
+
+    // Shared <-> Exclusive
+
+    void unlock_and_lock_shared()
+    {
+      mutex_.unlock_and_lock_shared();
+    }
+
+#ifdef BOOST_THREAD_PROVIDES_SHARED_MUTEX_UPWARDS_CONVERSIONS
+    bool try_unlock_shared_and_lock()
+    {
+      if (!try_move_shared_to_mutex()) return false;
+      if (!mutex_.try_unlock_shared_and_lock()) return false;
+      if (try_revoke_read_bias()) return true;
+      mutex_.unlock_and_lock_shared();
+      return false;
+    }
+
+#ifdef BOOST_THREAD_USES_CHRONO
+    template <class Rep, class Period>
+    bool try_unlock_shared_and_lock_for(const chrono::duration<Rep, Period>& rel_time)
+    {
+      return try_unlock_shared_and_lock_until(chrono::steady_clock::now() + rel_time);
+    }
+    template <class Clock, class Duration>
+    bool try_unlock_shared_and_lock_until(const chrono::time_point<Clock, Duration>& abs_time)
+    {
+      if (!try_move_shared_to_mutex()) return false;
+      if (!mutex_.try_unlock_shared_and_lock_until(abs_time)) return false;
+      if (revoke_read_bias_until(abs_time)) return true;
+      mutex_.unlock_and_lock_shared();
+      return false;
+    }
+#endif
+#endif
+
+    // Shared <-> Upgrade
+
+    void unlock_upgrade_and_lock_shared()
+    {
+      mutex_.unlock_upgrade_and_lock_shared();
+    }
+
+#ifdef BOOST_THREAD_PROVIDES_SHARED_MUTEX_UPWARDS_CONVERSIONS
+    bool try_unlock_shared_and_lock_upgrade()
+    {
+      if (!try_move_shared_to_mutex()) return false;
+      return mutex_.try_unlock_shared_and_lock_upgrade();
+    }
+
+#ifdef BOOST_THREAD_USES_CHRONO
+    template <class Rep, class Period>
+    bool try_unlock_shared_and_lock_upgrade_for(const chrono::duration<Rep, Period>& rel_time)
+    {
+      return try_unlock_shared_and_lock_upgrade_until(chrono::steady_clock::now() + rel_time);
+    }
+    template <class Clock, class Duration>
+    bool try_unlock_shared_and_lock_upgrade_until(const chrono::time_point<Clock, Duration>& abs_time)
+    {
+      if (!try_move_shared_to_mutex()) return false;
+      return mutex_.try_unlock_shared_and_lock_upgrade_until(abs_time);
+    }
+#endif
+#endif
+  };
+
+  typedef basic_reader_biased_shared_mutex<shared_mutex> reader_biased_shared_mutex;
+
+  namespace sync
+  {
+#ifdef BOOST_THREAD_NO_AUTO_DETECT_MUTEX_TYPES
+    template<class SharedMutex>
+    struct is_basic_lockable<basic_reader_biased_shared_mutex<SharedMutex> >
+    {
+      BOOST_STATIC_CONSTANT(bool, value = true);
+    };
+    template<class SharedMutex>
+    struct is_lockable<basic_reader_biased_shared_mutex<SharedMutex> >
+    {
+      BOOST_STATIC_CONSTANT(bool, value = true);
+    };
+#endif
+  }
+}
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif
@@ -0,0 +1,166 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_THREAD_TOPOLOGY_HPP
+#define BOOST_THREAD_TOPOLOGY_HPP
+
+#include <boost/thread/detail/config.hpp>
+#include <cstddef>
+#include <vector>
+
+#include <boost/config/abi_prefix.hpp>
+
+namespace boost
+{
+  namespace detail
+  {
+    struct cpu_topology_builder;
+  }
+
+  namespace this_system
+  {
+    /**
+     * A snapshot of the CPU topology of the system: its logical CPUs, grouped by physical core, by shared L2 and L3
+     * cache and by NUMA node.
+     *
+     * The groups are designated by their index in the vectors returned by @c cores(), @c l2_groups(),
+     * @c l3_groups() and @c numa_nodes(), and list the system ids of their CPUs, as used by
+     * @c thread_attributes::set_affinity(). When a level of the topology can not be read, each CPU is its own group
+     * at this level, except for the NUMA nodes where all the CPUs are on a single node.
+     */
+    class cpu_topology
+    {
+    public:
+      typedef std::vector<unsigned> cpu_list;
+
+      /// A logical CPU, i.e. a hardware thread.
+      struct cpu
+      {
+        /// the id of the CPU for the system.
+        unsigned id;
+        /// the index of its physical core in @c cores().
+        std::size_t core;
+        /// the index of the CPUs sharing its L2 cache in @c l2_groups().
+        std::size_t l2;
+        /// the index of the CPUs sharing its L3 cache in @c l3_groups().
+        std::size_t l3;
+        /// the index of its NUMA node in @c numa_nodes().
+        std::size_t numa_node;
+      };
+
+      /// Returns: the online logical CPUs, ordered by id.
+      std::vector<cpu> const& cpus() const BOOST_NOEXCEPT
+      {
+        return cpus_;
+      }
+      std::size_t logical_cpu_count() const BOOST_NOEXCEPT
+      {
+        return cpus_.size();
+      }
+      /// Returns: the CPUs of each physical core, i.e. the SMT siblings.
+      std::vector<cpu_list> const& cores() const BOOST_NOEXCEPT
+      {
+        return cores_;
+      }
+      std::size_t physical_core_count() const BOOST_NOEXCEPT
+      {
+        return cores_.size();
+      }
+      /// Returns: the groups of CPUs sharing an L2 cache.
+      std::vector<cpu_list> const& l2_groups() const BOOST_NOEXCEPT
+      {
+        return l2_groups_;
+      }
+      /// Returns: the groups of CPUs sharing an L3 cache.
+      std::vector<cpu_list> const& l3_groups() const BOOST_NOEXCEPT
+      {
+        return l3_groups_;
+      }
+      /// Returns: the CPUs of each NUMA node.
+      std::vector<cpu_list> const& numa_nodes() const BOOST_NOEXCEPT
+      {
+        return numa_nodes_;
+      }
+      /// Returns: the id of each NUMA node for the system.
+      std::vector<unsigned> const& numa_node_ids() const BOOST_NOEXCEPT
+      {
+        return numa_node_ids_;
+      }
+
+      /// Returns: the CPU whose system id is @c id, or 0 if it is not online.
+      cpu const* find(unsigned id) const BOOST_NOEXCEPT
+      {
+        for (std::size_t i = 0; i < cpus_.size(); ++i)
+        {
+          if (cpus_[i].id == id) return &cpus_[i];
+        }
+        return 0;
+      }
+
+    private:
+      friend struct detail::cpu_topology_builder;
+
+      std::vector<cpu> cpus_;
+      std::vector<cpu_list> cores_;
+      std::vector<cpu_list> l2_groups_;
+      std::vector<cpu_list> l3_groups_;
+      std::vector<cpu_list> numa_nodes_;
+      std::vector<unsigned> numa_node_ids_;
+
+      /// Returns: the index of @c group in @c groups, where it is added if not yet there.
+      static std::size_t group_of(std::vector<cpu_list>& groups, cpu_list const& group)
+      {
+        for (std::size_t i = 0; i < groups.size(); ++i)
+        {
+          if (groups[i] == group) return i;
+        }
+        groups.push_back(group);
+        return groups.size() - 1;
+      }
+
+      void add(unsigned id, cpu_list const& siblings, cpu_list const& l2, cpu_list const& l3, std::size_t node)
+      {
+        cpu c;
+        c.id = id;
+        c.core = group_of(cores_, siblings);
+        c.l2 = group_of(l2_groups_, l2);
+        c.l3 = group_of(l3_groups_, l3);
+        c.numa_node = node;
+        cpus_.push_back(c);
+      }
+    };
+
+    /**
+     * \b Returns: the topology of the system, read the first time it is called.
+     *
+     * \b Thread safety: safe, the snapshot is never modified once read.
+     */
+    BOOST_THREAD_DECL cpu_topology const& topology();
+
+    /**
+     * \b Returns: the number of threads the process can run in parallel, at least 1: the number of CPUs it is
+     * allowed to run on (see @c sched_setaffinity()), limited by the CPU quota of its cgroup (@c cpu.max for cgroup
+     * v2, @c cpu.cfs_quota_us / @c cpu.cfs_period_us for cgroup v1) rounded up. This is the default size of the
+     * thread pools and executors, which would otherwise oversubscribe a container limited to a few CPUs of a large
+     * machine.
+     *
+     * The value is computed the first time it is called, see @c refresh_effective_concurrency().
+     * On the platforms without affinity or quota, returns @c thread::hardware_concurrency(), or 1 if unknown.
+     */
+    BOOST_THREAD_DECL unsigned effective_concurrency() BOOST_NOEXCEPT;
+
+    /**
+     * \b Effects: evaluates again the value returned by @c effective_concurrency(), e.g. after the affinity of the
+     * process or the quota of its container have changed. The executors already created keep their size.
+     *
+     * \b Returns: the new value.
+     */
+    BOOST_THREAD_DECL unsigned refresh_effective_concurrency() BOOST_NOEXCEPT;
+  }
+}
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif
@@ -0,0 +1,275 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_THREAD_TREE_BARRIER_HPP
+#define BOOST_THREAD_TREE_BARRIER_HPP
+
+#include <boost/thread/detail/config.hpp>
+#include <boost/thread/detail/delete.hpp>
+#include <boost/thread/detail/futex.hpp>
+#include <boost/thread/detail/this_thread_token.hpp>
+#include <boost/thread/barrier.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/lock_types.hpp>
+#include <boost/thread/lock_guard.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/topology.hpp>
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/scoped_array.hpp>
+#include <cstddef>
+
+#include <boost/config/abi_prefix.hpp>
+
+namespace boost
+{
+  /**
+   * A barrier whose arrivals combine in a tree instead of all updating the same counter under a mutex.
+   *
+   * The arriving threads pair up in the nodes of the first level of the tree, starting from a node chosen from their
+   * identity, the second one of each pair going up to the next level, until a single thread remains: the last one to
+   * arrive, which calls the completion function and releases the others. The tickets of the nodes hold the phase of
+   * the barrier, which goes up by two at each phase: the arrivals move a ticket to the next phase, so there is no
+   * reset and no sense to reverse.
+   *
+   * The released threads spin for a while on the phase, when there are several CPUs, and then block on a condition
+   * variable.
+   *
+   * It has the interface and the completion function variants of @c barrier.
+   */
+  class tree_barrier
+  {
+    /// a node can combine up to 2^max_rounds threads.
+    BOOST_STATIC_CONSTANT(unsigned, max_rounds = 32);
+    BOOST_STATIC_CONSTANT(unsigned, spin_count = 1000);
+
+    struct node
+    {
+      atomic<unsigned> tickets[max_rounds];
+    };
+
+    static inline unsigned int check_counter(unsigned int count)
+    {
+      if (count == 0) boost::throw_exception(
+          thread_exception(system::errc::invalid_argument, "tree_barrier constructor: count cannot be zero."));
+      return count;
+    }
+    struct dummy
+    {
+    };
+
+    /// Effects: allocates the nodes of a tree of @c count threads, with all the tickets at @c phase.
+    void init_nodes(unsigned int count, unsigned phase)
+    {
+      std::size_t const n = (count + 1) / 2;
+      nodes_.reset(new node[n]);
+      for (std::size_t i = 0; i < n; ++i)
+        for (unsigned r = 0; r < max_rounds; ++r)
+          nodes_[i].tickets[r].store(phase, memory_order_relaxed);
+      count_ = count;
+    }
+
+    /// Returns: true if the calling thread is the last one to arrive at the phase @c old_phase.
+    bool arrive(unsigned old_phase)
+    {
+      unsigned const half_step = old_phase + 1;
+      unsigned const full_step = old_phase + 2;
+      std::size_t expected = count_;
+      // the threads starting on different nodes don't contend for the same tickets.
+      std::size_t current = static_cast<std::size_t>((detail::this_thread_token() * 0x9E3779B97F4A7C15ull) >> 32)
+          % ((expected + 1) / 2);
+      for (unsigned round = 0;; ++round)
+      {
+        if (expected <= 1) return true;
+        std::size_t const end_node = (expected + 1) / 2;
+        std::size_t const last_node = end_node - 1;
+        for (;; ++current)
+        {
+          if (current == end_node) current = 0;
+          atomic<unsigned>& ticket = nodes_[current].tickets[round];
+          unsigned expect = old_phase;
+          if (current == last_node && (expected & 1))
+          {
+            // the only thread of this node goes up.
+            if (ticket.compare_exchange_strong(expect, full_step, memory_order_acq_rel)) break;
+          }
+          else if (ticket.compare_exchange_strong(expect, half_step, memory_order_acq_rel))
+          {
+            // the first thread of this node leaves the second one go up.
+            return false;
+          }
+          else if (expect == half_step && ticket.compare_exchange_strong(expect, full_step, memory_order_acq_rel))
+          {
+            break;
+          }
+        }
+        expected = end_node;
+        current /= 2;
+      }
+    }
+
+    struct sleeper
+    {
+      atomic<unsigned>& sleepers_;
+      explicit sleeper(atomic<unsigned>& sleepers) : sleepers_(sleepers)
+      {
+        sleepers_.fetch_add(1, memory_order_seq_cst);
+      }
+      ~sleeper()
+      {
+        sleepers_.fetch_sub(1, memory_order_relaxed);
+      }
+    };
+
+    void init()
+    {
+      init_nodes(count_, 0);
+      spins_ = this_system::effective_concurrency() > 1 ? spin_count : 0;
+    }
+
+  public:
+    BOOST_THREAD_NO_COPYABLE( tree_barrier)
+
+    explicit tree_barrier(unsigned int count) :
+      count_(check_counter(count)), phase_(0), sleepers_(0),
+      fct_(BOOST_THREAD_MAKE_RV_REF(thread_detail::default_barrier_reseter(count)))
+    {
+      init();
+    }
+
+    template <typename F>
+    tree_barrier(
+        unsigned int count,
+        BOOST_THREAD_RV_REF(F) funct,
+        typename enable_if<
+        typename is_void<typename result_of<F>::type>::type, dummy*
+        >::type=0
+    )
+    : count_(check_counter(count)), phase_(0), sleepers_(0),
+      fct_(BOOST_THREAD_MAKE_RV_REF(thread_detail::void_functor_barrier_reseter(count,
+        boost::move(funct)))
+    )
+    {
+      init();
+    }
+    template <typename F>
+    tree_barrier(
+        unsigned int count,
+        F &funct,
+        typename enable_if<
+        typename is_void<typename result_of<F>::type>::type, dummy*
+        >::type=0
+    )
+    : count_(check_counter(count)), phase_(0), sleepers_(0),
+      fct_(BOOST_THREAD_MAKE_RV_REF(thread_detail::void_functor_barrier_reseter(count,
+        funct))
+    )
+    {
+      init();
+    }
+
+    template <typename F>
+    tree_barrier(
+        unsigned int count,
+        BOOST_THREAD_RV_REF(F) funct,
+        typename enable_if<
+        typename is_same<typename result_of<F>::type, unsigned int>::type, dummy*
+        >::type=0
+    )
+    : count_(check_counter(count)), phase_(0), sleepers_(0),
+      fct_(boost::move(funct))
+    {
+      init();
+    }
+    template <typename F>
+    tree_barrier(
+        unsigned int count,
+        F& funct,
+        typename enable_if<
+        typename is_same<typename result_of<F>::type, unsigned int>::type, dummy*
+        >::type=0
+    )
+    : count_(check_counter(count)), phase_(0), sleepers_(0),
+      fct_(funct)
+    {
+      init();
+    }
+
+    tree_barrier(unsigned int count, void(*funct)()) :
+      count_(check_counter(count)), phase_(0), sleepers_(0),
+      fct_(funct
+          ? BOOST_THREAD_MAKE_RV_REF(thread_detail::size_completion_function(BOOST_THREAD_MAKE_RV_REF(thread_detail::void_fct_ptr_barrier_reseter(count, funct))))
+          : BOOST_THREAD_MAKE_RV_REF(thread_detail::size_completion_function(BOOST_THREAD_MAKE_RV_REF(thread_detail::default_barrier_reseter(count))))
+      )
+    {
+      init();
+    }
+    tree_barrier(unsigned int count, unsigned int(*funct)()) :
+      count_(check_counter(count)), phase_(0), sleepers_(0),
+      fct_(funct
+          ? BOOST_THREAD_MAKE_RV_REF(thread_detail::size_completion_function(funct))
+          : BOOST_THREAD_MAKE_RV_REF(thread_detail::size_completion_function(BOOST_THREAD_MAKE_RV_REF(thread_detail::default_barrier_reseter(count))))
+      )
+    {
+      init();
+    }
+
+    /// Effects: arrives at the barrier and blocks until all the threads have arrived.
+    /// Returns: true for the last thread to arrive, which has called the completion function, false for the others.
+    bool wait()
+    {
+      unsigned const old_phase = phase_.load(memory_order_acquire);
+      if (arrive(old_phase))
+      {
+        unsigned const count = static_cast<unsigned int>(fct_());
+        BOOST_ASSERT(count != 0);
+        // the other threads don't use the tree until the new phase is published.
+        if (count != count_) init_nodes(count, old_phase + 2);
+        phase_.store(old_phase + 2, memory_order_seq_cst);
+        if (sleepers_.load(memory_order_seq_cst) != 0)
+        {
+          {
+            // a sleeper has either seen the new phase or is blocked on the condition.
+            boost::lock_guard<boost::mutex> lk(mutex_);
+          }
+          cond_.notify_all();
+        }
+        return true;
+      }
+
+      for (unsigned i = 0; i < spins_; ++i)
+      {
+        if (phase_.load(memory_order_acquire) != old_phase) return false;
+        detail::cpu_relax();
+      }
+      boost::unique_lock<boost::mutex> lk(mutex_);
+      sleeper s(sleepers_);
+      while (phase_.load(memory_order_seq_cst) == old_phase)
+        cond_.wait(lk);
+      return false;
+    }
+
+    void count_down_and_wait()
+    {
+      wait();
+    }
+
+  private:
+    /// the number of threads of the current phase, changed by the last thread to arrive.
+    unsigned int count_;
+    boost::scoped_array<node> nodes_;
+    atomic<unsigned> phase_;
+    atomic<unsigned> sleepers_;
+    unsigned spins_;
+    mutex mutex_;
+    condition_variable cond_;
+    thread_detail::size_completion_function fct_;
+  };
+
+} // namespace boost
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif
@@ -46,6 +46,9 @@ namespace boost
         case future_errc::no_state:
             return std::string("Operation not permitted on an object without "
                           "an associated state.");
+        case future_errc::cancelled:
+            return std::string("The task associated to the state has been cancelled "
+                          "before it was invoked.");
         }
         return std::string("unspecified future_errc value\n");
     }
@@ -62,3 +65,46 @@ namespace boost
 }
 #endif
 
+#include <boost/thread/executors/current_executor.hpp>
+#if defined BOOST_NO_CXX11_THREAD_LOCAL
+#include <boost/thread/tss.hpp>
+#endif
+
+namespace boost
+{
+  namespace detail
+  {
+    namespace
+    {
+      // read by every blocking wait on a future: a native thread local variable when there is one.
+#if ! defined BOOST_NO_CXX11_THREAD_LOCAL
+      thread_local current_executor_entry* current_executor = 0;
+#else
+      // the entries are owned by the current_executor_guard instances.
+      void no_cleanup(current_executor_entry*)
+      {
+      }
+      boost::thread_specific_ptr<current_executor_entry> current_executor(&no_cleanup);
+#endif
+    }
+
+    BOOST_THREAD_DECL current_executor_entry* get_current_executor() BOOST_NOEXCEPT
+    {
+#if ! defined BOOST_NO_CXX11_THREAD_LOCAL
+      return current_executor;
+#else
+      return current_executor.get();
+#endif
+    }
+
+    BOOST_THREAD_DECL void set_current_executor(current_executor_entry* entry)
+    {
+#if ! defined BOOST_NO_CXX11_THREAD_LOCAL
+      current_executor = entry;
+#else
+      current_executor.reset(entry);
+#endif
+    }
+  }
+}
+
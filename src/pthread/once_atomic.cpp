@@ -8,11 +8,13 @@
 #include <boost/thread/detail/config.hpp>
 #include <boost/thread/once.hpp>
 #include <boost/thread/pthread/pthread_mutex_scoped_lock.hpp>
+#include <boost/thread/detail/futex.hpp>
 #include <boost/assert.hpp>
 #include <boost/static_assert.hpp>
 #include <boost/atomic.hpp>
 #include <boost/memory_order.hpp>
 #include <pthread.h>
+#include <climits>
 
 namespace boost
 {
@@ -21,7 +23,8 @@ namespace boost
 
     enum flag_states
     {
-      uninitialized, in_progress, initialized
+      // in_progress_with_waiters: other threads wait for the end of the initialization, which has to wake them.
+      uninitialized, in_progress, initialized, in_progress_with_waiters
     };
 
 
@@ -29,60 +32,100 @@ namespace boost
     BOOST_STATIC_ASSERT_MSG(sizeof(atomic_int_type) == sizeof(atomic_type), "Boost.Thread: unsupported platform");
 #endif
 
+#if defined BOOST_THREAD_HAS_FUTEX && BOOST_ATOMIC_INT_LOCK_FREE == 2
+    // The waiters of a flag block on a futex on the storage of the flag: the end of an initialization only wakes the
+    // threads waiting for the same flag, and only makes a system call if there are some.
+    namespace
+    {
+      atomic<int>& futex_storage(atomic_type& f)
+      {
+        BOOST_STATIC_ASSERT(sizeof(atomic_type) == sizeof(atomic<int>));
+        return reinterpret_cast<atomic<int>&>(f);
+      }
+
+      /// Effects: blocks while the flag is in_progress_with_waiters.
+      void wait_for_end_of_region(atomic_type& f)
+      {
+        detail::futex_wait(futex_storage(f), in_progress_with_waiters);
+      }
+
+      /// Effects: stores @c state in the flag and wakes its waiters if any.
+      void end_region(atomic_type& f, atomic_int_type state)
+      {
+        if (f.exchange(state, memory_order_acq_rel) == in_progress_with_waiters)
+        {
+          detail::futex_wake(futex_storage(f), INT_MAX);
+        }
+      }
+    }
+#else
+    // Without futexes, the waiters of all the flags share a condition variable, only notified by the end of an
+    // initialization which has waiters.
     static pthread_mutex_t once_mutex = PTHREAD_MUTEX_INITIALIZER;
     static pthread_cond_t once_cv = PTHREAD_COND_INITIALIZER;
 
-    BOOST_THREAD_DECL bool enter_once_region(once_flag& flag) BOOST_NOEXCEPT
+    namespace
     {
-      atomic_type& f = get_atomic_storage(flag);
-      if (f.load(memory_order_acquire) != initialized)
+      void wait_for_end_of_region(atomic_type& f)
       {
         pthread::pthread_mutex_scoped_lock lk(&once_mutex);
-        if (f.load(memory_order_acquire) != initialized)
+        if (f.load(memory_order_acquire) == in_progress_with_waiters)
+        {
+          BOOST_VERIFY(!pthread_cond_wait(&once_cv, &once_mutex));
+        }
+      }
+
+      void end_region(atomic_type& f, atomic_int_type state)
+      {
+        if (f.exchange(state, memory_order_acq_rel) == in_progress_with_waiters)
         {
-          while (true)
           {
-            atomic_int_type expected = uninitialized;
-            if (f.compare_exchange_strong(expected, in_progress, memory_order_acq_rel, memory_order_acquire))
-            {
-              // We have set the flag to in_progress
-              return true;
-            }
-            else if (expected == initialized)
-            {
-              // Another thread managed to complete the initialization
-              return false;
-            }
-            else
-            {
-              // Wait until the initialization is complete
-              //pthread::pthread_mutex_scoped_lock lk(&once_mutex);
-              BOOST_VERIFY(!pthread_cond_wait(&once_cv, &once_mutex));
-            }
+            // a waiter has either seen the new state or is blocked on the condition.
+            pthread::pthread_mutex_scoped_lock lk(&once_mutex);
           }
+          BOOST_VERIFY(!pthread_cond_broadcast(&once_cv));
         }
       }
-      return false;
     }
+#endif
 
-    BOOST_THREAD_DECL void commit_once_region(once_flag& flag) BOOST_NOEXCEPT
+    BOOST_THREAD_DECL bool enter_once_region(once_flag& flag) BOOST_NOEXCEPT
     {
       atomic_type& f = get_atomic_storage(flag);
+      atomic_int_type expected = f.load(memory_order_acquire);
+      while (true)
       {
-        pthread::pthread_mutex_scoped_lock lk(&once_mutex);
-        f.store(initialized, memory_order_release);
+        if (expected == initialized)
+        {
+          // Another thread managed to complete the initialization
+          return false;
+        }
+        else if (expected == uninitialized)
+        {
+          if (f.compare_exchange_strong(expected, in_progress, memory_order_acq_rel, memory_order_acquire))
+          {
+            // We have set the flag to in_progress
+            return true;
+          }
+        }
+        else if (expected == in_progress_with_waiters
+            || f.compare_exchange_strong(expected, in_progress_with_waiters, memory_order_acq_rel, memory_order_acquire))
+        {
+          // Wait until the initialization is complete or rolled back
+          wait_for_end_of_region(f);
+          expected = f.load(memory_order_acquire);
+        }
       }
-      BOOST_VERIFY(!pthread_cond_broadcast(&once_cv));
+    }
+
+    BOOST_THREAD_DECL void commit_once_region(once_flag& flag) BOOST_NOEXCEPT
+    {
+      end_region(get_atomic_storage(flag), initialized);
     }
 
     BOOST_THREAD_DECL void rollback_once_region(once_flag& flag) BOOST_NOEXCEPT
     {
-      atomic_type& f = get_atomic_storage(flag);
-      {
-        pthread::pthread_mutex_scoped_lock lk(&once_mutex);
-        f.store(uninitialized, memory_order_release);
-      }
-      BOOST_VERIFY(!pthread_cond_broadcast(&once_cv));
+      end_region(get_atomic_storage(flag), uninitialized);
     }
 
   } // namespace thread_detail
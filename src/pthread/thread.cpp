@@ -17,6 +17,9 @@
 #include <boost/thread/once.hpp>
 #include <boost/thread/tss.hpp>
 #include <boost/thread/future.hpp>
+#include <boost/thread/detail/numa.hpp>
+#include <boost/thread/topology.hpp>
+#include <boost/atomic.hpp>
 
 #ifdef __GLIBC__
 #include <sys/sysinfo.h>
@@ -31,6 +34,12 @@
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/lexical_cast.hpp>
 
+#if defined BOOST_THREAD_LINUX
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
 #include <fstream>
 #include <string>
 #include <set>
@@ -54,6 +63,7 @@ namespace boost
                     i != e; ++i)
             {
                 (*i)->make_ready();
+                resume_waiters(**i);
             }
         }
 
@@ -155,10 +165,346 @@ namespace boost
             boost::call_once(current_thread_tls_init_flag,create_current_thread_tls_key);
             BOOST_VERIFY(!pthread_setspecific(current_thread_tls_key,new_data));
         }
+
+#if defined BOOST_THREAD_LINUX
+        namespace
+        {
+            // reads a list of the form 0-3,8-11 from the file at path.
+            bool read_id_list(std::string const& path, std::vector<unsigned>& ids)
+            {
+                std::ifstream file(path.c_str());
+                std::string line;
+                if (!std::getline(file, line))
+                    return false;
+                ids.clear();
+                std::vector<std::string> ranges;
+                boost::split(ranges, line, boost::is_any_of(","));
+                for (std::size_t i = 0; i < ranges.size(); ++i)
+                {
+                    std::string range = boost::trim_copy(ranges[i]);
+                    if (range.empty())
+                        continue;
+                    std::string::size_type dash = range.find('-');
+                    try {
+                        unsigned first = boost::lexical_cast<unsigned>(range.substr(0, dash));
+                        unsigned last = dash == std::string::npos ? first : boost::lexical_cast<unsigned>(range.substr(dash + 1));
+                        for (unsigned id = first; id <= last; ++id)
+                        {
+                            ids.push_back(id);
+                        }
+                    } catch(...) {
+                        return false;
+                    }
+                }
+                return !ids.empty();
+            }
+        }
+
+        bool get_numa_nodes(std::vector<unsigned>& nodes)
+        {
+            return read_id_list("/sys/devices/system/node/online", nodes);
+        }
+
+        bool get_numa_node_cpu_list(unsigned node, std::vector<unsigned>& cpus)
+        {
+            return read_id_list("/sys/devices/system/node/node" + boost::lexical_cast<std::string>(node) + "/cpulist", cpus);
+        }
+#endif
+
+        struct cpu_topology_builder
+        {
+            typedef this_system::cpu_topology::cpu_list cpu_list;
+
+            static void build_default(this_system::cpu_topology& t)
+            {
+                unsigned n = thread::hardware_concurrency();
+                if (n == 0) n = 1;
+                t.numa_node_ids_.assign(1, 0u);
+                t.numa_nodes_.assign(1, cpu_list());
+                for (unsigned id = 0; id < n; ++id)
+                {
+                    cpu_list self(1, id);
+                    t.numa_nodes_[0].push_back(id);
+                    t.add(id, self, self, self, 0);
+                }
+            }
+
+#if defined BOOST_THREAD_LINUX
+            // the CPUs sharing the cache of the given level with cpu, read from its cache/indexN directories.
+            static cpu_list shared_cache(std::string const& cpu, unsigned level, cpu_list const& self)
+            {
+                for (unsigned index = 0; ; ++index)
+                {
+                    std::string cache = cpu + "/cache/index" + boost::lexical_cast<std::string>(index);
+                    std::ifstream level_file((cache + "/level").c_str());
+                    unsigned cache_level;
+                    if (!(level_file >> cache_level))
+                        return self;
+                    std::ifstream type_file((cache + "/type").c_str());
+                    std::string type;
+                    type_file >> type;
+                    cpu_list shared;
+                    if (cache_level == level && type != "Instruction" && read_id_list(cache + "/shared_cpu_list", shared))
+                        return shared;
+                }
+            }
+
+            static bool build_linux(this_system::cpu_topology& t)
+            {
+                cpu_list online;
+                if (!read_id_list("/sys/devices/system/cpu/online", online))
+                    return false;
+                std::vector<unsigned> nodes;
+                if (get_numa_nodes(nodes))
+                {
+                    for (std::size_t i = 0; i < nodes.size(); ++i)
+                    {
+                        cpu_list cpus;
+                        // a node can have memory and no CPU.
+                        get_numa_node_cpu_list(nodes[i], cpus);
+                        t.numa_node_ids_.push_back(nodes[i]);
+                        t.numa_nodes_.push_back(cpus);
+                    }
+                }
+                else
+                {
+                    t.numa_node_ids_.assign(1, 0u);
+                    t.numa_nodes_.assign(1, online);
+                }
+                for (std::size_t i = 0; i < online.size(); ++i)
+                {
+                    unsigned id = online[i];
+                    std::string cpu = "/sys/devices/system/cpu/cpu" + boost::lexical_cast<std::string>(id);
+                    cpu_list self(1, id);
+                    cpu_list siblings;
+                    if (!read_id_list(cpu + "/topology/thread_siblings_list", siblings))
+                        siblings = self;
+                    std::size_t node = 0;
+                    for (std::size_t n = 0; n < t.numa_nodes_.size(); ++n)
+                    {
+                        if (std::find(t.numa_nodes_[n].begin(), t.numa_nodes_[n].end(), id) != t.numa_nodes_[n].end())
+                            node = n;
+                    }
+                    t.add(id, siblings, shared_cache(cpu, 2, self), shared_cache(cpu, 3, self), node);
+                }
+                return true;
+            }
+#endif
+
+            static void build(this_system::cpu_topology& t)
+            {
+#if defined BOOST_THREAD_LINUX
+                if (build_linux(t))
+                    return;
+                t = this_system::cpu_topology();
+#endif
+                build_default(t);
+            }
+        };
+
+#if defined BOOST_THREAD_DEFINES_THREAD_ATTRIBUTES_CPU_SET
+        bool get_numa_node_cpus(unsigned node, cpu_set_t& cpus)
+        {
+            this_system::cpu_topology const& t = this_system::topology();
+            std::vector<unsigned> ids;
+            for (std::size_t i = 0; i < t.numa_node_ids().size(); ++i)
+            {
+                if (t.numa_node_ids()[i] == node)
+                    ids = t.numa_nodes()[i];
+            }
+            CPU_ZERO(&cpus);
+            bool found = false;
+            for (std::size_t i = 0; i < ids.size(); ++i)
+            {
+                if (ids[i] < CPU_SETSIZE)
+                {
+                    CPU_SET(ids[i], &cpus);
+                    found = true;
+                }
+            }
+            return found;
+        }
+#endif
+    }
+
+    namespace this_system
+    {
+        namespace
+        {
+            boost::once_flag topology_flag = BOOST_ONCE_INIT;
+            cpu_topology const* the_topology = 0;
+
+            void read_topology()
+            {
+                static cpu_topology t;
+                detail::cpu_topology_builder::build(t);
+                the_topology = &t;
+            }
+        }
+
+        cpu_topology const& topology()
+        {
+            boost::call_once(topology_flag, read_topology);
+            return *the_topology;
+        }
+
+        namespace
+        {
+#if defined BOOST_THREAD_LINUX
+            // the quota of the cgroup v2 at dir in CPUs rounded up, or 0 if unlimited or unknown.
+            unsigned cgroup_v2_quota(std::string const& dir)
+            {
+                std::ifstream file((dir + "/cpu.max").c_str());
+                std::string quota;
+                long period = 0;
+                if (!(file >> quota >> period) || quota == "max" || period <= 0)
+                    return 0;
+                try {
+                    long q = boost::lexical_cast<long>(quota);
+                    return q <= 0 ? 0 : static_cast<unsigned>((q + period - 1) / period);
+                } catch(...) {
+                    return 0;
+                }
+            }
+
+            // the quota of the cgroup v1 at dir in CPUs rounded up, or 0 if unlimited (-1) or unknown.
+            unsigned cgroup_v1_quota(std::string const& dir)
+            {
+                std::ifstream quota_file((dir + "/cpu.cfs_quota_us").c_str());
+                std::ifstream period_file((dir + "/cpu.cfs_period_us").c_str());
+                long quota = 0;
+                long period = 0;
+                if (!(quota_file >> quota) || !(period_file >> period) || quota <= 0 || period <= 0)
+                    return 0;
+                return static_cast<unsigned>((quota + period - 1) / period);
+            }
+
+            unsigned min_quota(unsigned a, unsigned b)
+            {
+                return a == 0 ? b : (b == 0 ? a : (std::min)(a, b));
+            }
+
+            // the smallest quota of the cgroup at root + path and of its ancestors. Inside a container the path is
+            // the one of the host, which does not exist, but the root is the cgroup of the container.
+            unsigned cgroup_hierarchy_quota(std::string const& root, std::string path,
+                unsigned (*quota_of)(std::string const&))
+            {
+                unsigned quota = 0;
+                for (;;)
+                {
+                    quota = min_quota(quota, quota_of(root + path));
+                    if (path.empty() || path == "/")
+                        break;
+                    path.erase(path.rfind('/'));
+                }
+                return quota;
+            }
+
+            // the CPU quota of the process, read from the cgroups listed in /proc/self/cgroup, or 0 if unlimited.
+            unsigned cgroup_quota()
+            {
+                std::ifstream file("/proc/self/cgroup");
+                std::string line;
+                unsigned quota = 0;
+                // hierarchy-id:controller-list:path
+                while (std::getline(file, line))
+                {
+                    std::string::size_type first = line.find(':');
+                    std::string::size_type second = line.find(':', first == std::string::npos ? first : first + 1);
+                    if (second == std::string::npos)
+                        continue;
+                    std::string id = line.substr(0, first);
+                    std::string path = line.substr(second + 1);
+                    std::string controller_list = line.substr(first + 1, second - first - 1);
+                    std::vector<std::string> controllers;
+                    boost::split(controllers, controller_list, boost::is_any_of(","));
+                    if (id == "0")
+                    {
+                        quota = min_quota(quota, cgroup_hierarchy_quota("/sys/fs/cgroup", path, cgroup_v2_quota));
+                        quota = min_quota(quota, cgroup_hierarchy_quota("/sys/fs/cgroup/unified", path, cgroup_v2_quota));
+                    }
+                    else if (std::find(controllers.begin(), controllers.end(), "cpu") != controllers.end())
+                    {
+                        quota = min_quota(quota, cgroup_hierarchy_quota("/sys/fs/cgroup/cpu", path, cgroup_v1_quota));
+                        quota = min_quota(quota, cgroup_hierarchy_quota("/sys/fs/cgroup/cpu,cpuacct", path, cgroup_v1_quota));
+                    }
+                }
+                return quota;
+            }
+#endif
+
+            unsigned compute_effective_concurrency()
+            {
+                unsigned n = thread::hardware_concurrency();
+#if defined BOOST_THREAD_LINUX && defined CPU_COUNT
+                cpu_set_t cpus;
+                CPU_ZERO(&cpus);
+                if (sched_getaffinity(0, sizeof(cpus), &cpus) == 0 && CPU_COUNT(&cpus) > 0)
+                    n = static_cast<unsigned>(CPU_COUNT(&cpus));
+#endif
+#if defined BOOST_THREAD_LINUX
+                try
+                {
+                    unsigned quota = cgroup_quota();
+                    if (quota != 0 && quota < n)
+                        n = quota;
+                }
+                catch (...)
+                {
+                    // unreadable cgroups (e.g. bad_alloc): keeps the count of the affinity mask.
+                }
+#endif
+                return n == 0 ? 1 : n;
+            }
+
+            // 0 until computed. Concurrent first calls compute the same value.
+            boost::atomic<unsigned> the_effective_concurrency(0);
+        }
+
+        unsigned effective_concurrency() BOOST_NOEXCEPT
+        {
+            unsigned n = the_effective_concurrency.load(boost::memory_order_acquire);
+            if (n == 0)
+            {
+                n = compute_effective_concurrency();
+                the_effective_concurrency.store(n, boost::memory_order_release);
+            }
+            return n;
+        }
+
+        unsigned refresh_effective_concurrency() BOOST_NOEXCEPT
+        {
+            unsigned n = compute_effective_concurrency();
+            the_effective_concurrency.store(n, boost::memory_order_release);
+            return n;
+        }
     }
 
     namespace
     {
+        // applies the attributes that the thread must set itself.
+        void apply_thread_start_attributes(detail::thread_data_base& thread_info)
+        {
+#if defined BOOST_THREAD_LINUX && defined __GLIBC__
+            if (!thread_info.name.empty())
+            {
+                // the name is limited to 16 characters including the terminating null.
+                pthread_setname_np(pthread_self(), thread_info.name.substr(0, 15).c_str());
+            }
+#endif
+#if defined BOOST_THREAD_LINUX && defined SYS_set_mempolicy
+            if (thread_info.numa_node >= 0 && thread_info.numa_node < 1024)
+            {
+                // MPOL_PREFERRED: allocate on the node while it has free memory.
+                const int mpol_preferred = 1;
+                const unsigned bits = 8 * sizeof(unsigned long);
+                unsigned long mask[1024 / (8 * sizeof(unsigned long))] = { 0 };
+                mask[thread_info.numa_node / bits] |= 1UL << (thread_info.numa_node % bits);
+                syscall(SYS_set_mempolicy, mpol_preferred, mask, sizeof(mask) * 8 + 1);
+            }
+#endif
+        }
+
         extern "C"
         {
             static void* thread_proxy(void* param)
@@ -166,6 +512,7 @@ namespace boost
                 boost::detail::thread_data_ptr thread_info = static_cast<boost::detail::thread_data_base*>(param)->self;
                 thread_info->self.reset();
                 detail::set_current_thread_data(thread_info.get());
+                apply_thread_start_attributes(*thread_info);
 #if defined BOOST_THREAD_PROVIDES_INTERRUPTIONS
                 BOOST_TRY
                 {
@@ -265,6 +612,8 @@ namespace boost
     bool thread::start_thread_noexcept(const attributes& attr)
     {
         thread_info->self=thread_info;
+        thread_info->name=attr.get_name();
+        thread_info->numa_node=attr.get_numa_node();
         const attributes::native_handle_type* h = attr.native_handle();
         int res = pthread_create(&thread_info->thread_handle, h, &thread_proxy, thread_info.get());
         if (res != 0)
@@ -366,7 +715,7 @@ namespace boost
                 unique_lock<mutex> lock(local_thread_info->data_mutex);
                 while(!local_thread_info->done)
                 {
-                    if(!local_thread_info->done_condition.do_wait_until(lock,timeout))
+                    if(!local_thread_info->done_condition.do_wait_until(lock,boost::detail::timespec_realtime_to_internal(timeout)))
                     {
                       res=false;
                       return true;
@@ -482,7 +831,7 @@ namespace boost
                     mutex mx;
                     unique_lock<mutex> lock(mx);
                     condition_variable cond;
-                    cond.do_wait_until(lock, ts);
+                    cond.do_wait_until(lock, boost::detail::timespec_realtime_to_internal(ts));
     #   endif
                     timespec now2 = boost::detail::timespec_now();
                     if (boost::detail::timespec_ge(now2, ts))
@@ -519,7 +868,7 @@ namespace boost
             if(thread_info)
             {
               unique_lock<mutex> lk(thread_info->sleep_mutex);
-              while(thread_info->sleep_condition.do_wait_until(lk,ts)) {}
+              while(thread_info->sleep_condition.do_wait_until(lk,boost::detail::timespec_realtime_to_internal(ts))) {}
             }
             else
             {
@@ -573,48 +922,8 @@ namespace boost
     {
 #ifdef __linux__
         try {
-            using namespace std;
-
-            ifstream proc_cpuinfo ("/proc/cpuinfo");
-
-            const string physical_id("physical id"), core_id("core id");
-
-            typedef std::pair<unsigned, unsigned> core_entry; // [physical ID, core id]
-
-            std::set<core_entry> cores;
-
-            core_entry current_core_entry;
-
-            string line;
-            while ( getline(proc_cpuinfo, line) ) {
-                if (line.empty())
-                    continue;
-
-                vector<string> key_val(2);
-                boost::split(key_val, line, boost::is_any_of(":"));
-
-                if (key_val.size() != 2)
-                  return hardware_concurrency();
-
-                string key   = key_val[0];
-                string value = key_val[1];
-                boost::trim(key);
-                boost::trim(value);
-
-                if (key == physical_id) {
-                    current_core_entry.first = boost::lexical_cast<unsigned>(value);
-                    continue;
-                }
-
-                if (key == core_id) {
-                    current_core_entry.second = boost::lexical_cast<unsigned>(value);
-                    cores.insert(current_core_entry);
-                    continue;
-                }
-            }
-            // Fall back to hardware_concurrency() in case
-            // /proc/cpuinfo is formatted differently than we expect.
-            return cores.size() != 0 ? cores.size() : hardware_concurrency();
+            unsigned cores = static_cast<unsigned>(this_system::topology().physical_core_count());
+            return cores != 0 ? cores : hardware_concurrency();
         } catch(...) {
           return hardware_concurrency();
         }
@@ -640,6 +949,10 @@ namespace boost
                 boost::pthread::pthread_mutex_scoped_lock internal_lock(local_thread_info->cond_mutex);
                 BOOST_VERIFY(!pthread_cond_broadcast(local_thread_info->current_cond));
             }
+            if(local_thread_info->current_wait)
+            {
+                local_thread_info->current_wait_wake(local_thread_info->current_wait);
+            }
         }
     }
 
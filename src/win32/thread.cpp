@@ -20,6 +20,7 @@
 #include <boost/thread/condition_variable.hpp>
 #include <boost/thread/detail/tss_hooks.hpp>
 #include <boost/thread/future.hpp>
+#include <boost/thread/topology.hpp>
 
 #include <boost/assert.hpp>
 #include <boost/cstdint.hpp>
@@ -441,6 +442,72 @@ namespace boost
         return cores;
     }
 
+    namespace detail
+    {
+        struct cpu_topology_builder
+        {
+            typedef this_system::cpu_topology::cpu_list cpu_list;
+
+            // each CPU is its own core and cache group, on a single node.
+            static void build(this_system::cpu_topology& t)
+            {
+                unsigned n = thread::hardware_concurrency();
+                if (n == 0) n = 1;
+                t.numa_node_ids_.assign(1, 0u);
+                t.numa_nodes_.assign(1, cpu_list());
+                for (unsigned id = 0; id < n; ++id)
+                {
+                    cpu_list self(1, id);
+                    t.numa_nodes_[0].push_back(id);
+                    t.add(id, self, self, self, 0);
+                }
+            }
+        };
+    }
+
+    namespace this_system
+    {
+        namespace
+        {
+            boost::once_flag topology_flag = BOOST_ONCE_INIT;
+            cpu_topology const* the_topology = 0;
+
+            void read_topology()
+            {
+                static cpu_topology t;
+                detail::cpu_topology_builder::build(t);
+                the_topology = &t;
+            }
+        }
+
+        cpu_topology const& topology()
+        {
+            boost::call_once(topology_flag, read_topology);
+            return *the_topology;
+        }
+
+        // neither cached nor limited by the job objects: counts the CPUs of the affinity mask of the process.
+        unsigned effective_concurrency() BOOST_NOEXCEPT
+        {
+            unsigned n = 0;
+            DWORD_PTR process_mask = 0;
+            DWORD_PTR system_mask = 0;
+            if (GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask))
+            {
+                for (; process_mask != 0; process_mask &= process_mask - 1)
+                    ++n;
+            }
+            if (n == 0)
+                n = thread::hardware_concurrency();
+            return n == 0 ? 1 : n;
+        }
+
+        unsigned refresh_effective_concurrency() BOOST_NOEXCEPT
+        {
+            return effective_concurrency();
+        }
+    }
+
     thread::native_handle_type thread::native_handle()
     {
         detail::thread_data_ptr local_thread_info=(get_thread_info)();
@@ -0,0 +1,104 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/condition_variable.hpp>
+
+// class condition_variable;
+
+// void wait(unique_lock<mutex>& lock);
+
+// the wait is an interruption point.
+
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+#if defined BOOST_THREAD_PROVIDES_INTERRUPTIONS
+
+boost::condition_variable cv;
+boost::mutex mut;
+
+bool waiting = false;
+bool interrupted = false;
+
+const int N_ROUNDS = 1000;
+int round_waiting = -1;
+int rounds_interrupted = 0;
+
+void f()
+{
+  boost::unique_lock<boost::mutex> lk(mut);
+  waiting = true;
+  try
+  {
+    for (;;)
+      cv.wait(lk);
+  }
+  catch (boost::thread_interrupted&)
+  {
+    // the mutex is locked again.
+    BOOST_TEST(lk.owns_lock());
+    interrupted = true;
+  }
+}
+
+// interrupted at each round while it enters the wait.
+void g()
+{
+  for (int r = 0; r < N_ROUNDS; ++r)
+  {
+    boost::unique_lock<boost::mutex> lk(mut);
+    round_waiting = r;
+    try
+    {
+      for (;;)
+        cv.wait(lk);
+    }
+    catch (boost::thread_interrupted&)
+    {
+      ++rounds_interrupted;
+    }
+  }
+}
+
+int main()
+{
+  {
+    boost::thread t(g);
+    for (int r = 0; r < N_ROUNDS; ++r)
+    {
+      for (;;)
+      {
+        boost::unique_lock<boost::mutex> lk(mut);
+        if (round_waiting == r) break;
+        lk.unlock();
+        boost::this_thread::yield();
+      }
+      // g() holds the lock between the round update and the wait: the interruption comes as it enters the wait.
+      t.interrupt();
+    }
+    t.join();
+    BOOST_TEST_EQ(rounds_interrupted, N_ROUNDS);
+  }
+  boost::thread t(f);
+  for (;;)
+  {
+    boost::this_thread::yield();
+    boost::unique_lock<boost::mutex> lk(mut);
+    if (waiting) break;
+  }
+  // f() is blocked in wait(), or about to be.
+  t.interrupt();
+  t.join();
+  BOOST_TEST(interrupted);
+
+  return boost::report_errors();
+}
+#else
+int main()
+{
+  return 0;
+}
+#endif
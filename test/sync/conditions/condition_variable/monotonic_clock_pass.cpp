@@ -0,0 +1,74 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/condition_variable>
+
+// class condition_variable;
+
+// the native condition variable waits on CLOCK_MONOTONIC.
+
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+#if defined BOOST_THREAD_USES_CHRONO
+typedef boost::chrono::steady_clock Clock;
+typedef boost::chrono::milliseconds milliseconds;
+#endif
+
+int main()
+{
+#if defined BOOST_THREAD_HAS_CONDATTR_SET_CLOCK_MONOTONIC
+  boost::condition_variable cv;
+  boost::mutex m;
+#if defined BOOST_THREAD_DEFINES_CONDITION_VARIABLE_NATIVE_HANDLE
+  {
+    // a CLOCK_MONOTONIC time is in the past of CLOCK_REALTIME: the wait would not block on the wrong clock.
+    timespec ts;
+    BOOST_TEST(::clock_gettime(CLOCK_MONOTONIC, &ts) == 0);
+    timespec const start = ts;
+    ts.tv_nsec += 100000000;
+    if (ts.tv_nsec >= 1000000000) { ts.tv_nsec -= 1000000000; ++ts.tv_sec; }
+    boost::unique_lock<boost::mutex> lk(m);
+    int res;
+    do
+    {
+      res = pthread_cond_timedwait(cv.native_handle(), m.native_handle(), &ts);
+    } while (res == 0);
+    BOOST_TEST_EQ(res, ETIMEDOUT);
+    timespec end;
+    BOOST_TEST(::clock_gettime(CLOCK_MONOTONIC, &end) == 0);
+    long long const waited = (end.tv_sec - start.tv_sec) * 1000000000LL + (end.tv_nsec - start.tv_nsec);
+    BOOST_TEST(waited >= 100000000LL);
+  }
+#endif
+#if defined BOOST_THREAD_USES_CHRONO
+  {
+    // the steady_clock deadlines are waited on directly.
+    boost::unique_lock<boost::mutex> lk(m);
+    Clock::time_point const t0 = Clock::now();
+    while (cv.wait_until(lk, t0 + milliseconds(100)) == boost::cv_status::no_timeout)
+    {
+    }
+    BOOST_TEST(Clock::now() - t0 >= milliseconds(100));
+    Clock::time_point const t1 = Clock::now();
+    while (cv.wait_for(lk, milliseconds(100)) == boost::cv_status::no_timeout)
+    {
+    }
+    BOOST_TEST(Clock::now() - t1 >= milliseconds(100));
+  }
+  {
+    // the system_clock deadlines are converted.
+    boost::unique_lock<boost::mutex> lk(m);
+    boost::chrono::system_clock::time_point const t0 = boost::chrono::system_clock::now();
+    while (cv.wait_until(lk, t0 + milliseconds(100)) == boost::cv_status::no_timeout)
+    {
+    }
+    BOOST_TEST(boost::chrono::system_clock::now() - t0 >= milliseconds(100));
+  }
+#endif
+#endif
+  return boost::report_errors();
+}
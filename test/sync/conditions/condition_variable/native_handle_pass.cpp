@@ -29,6 +29,8 @@ int main()
   boost::condition_variable cv;
   boost::condition_variable::native_handle_type h = cv.native_handle();
   BOOST_TEST(h != 0);
+#elif defined BOOST_THREAD_CONDITION_VARIABLE_USES_FUTEX
+  // the condition variable waits on a futex: it has no pthread_cond_t.
 #else
 #error "Test not applicable: BOOST_THREAD_DEFINES_CONDITION_VARIABLE_NATIVE_HANDLE not defined for this platform as not supported"
 #endif
@@ -0,0 +1,20 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/fast_condition_variable.hpp>
+
+// class fast_condition_variable;
+
+// fast_condition_variable(const fast_condition_variable&) = delete;
+
+#include <boost/thread/fast_condition_variable.hpp>
+
+int main()
+{
+  boost::fast_condition_variable cv0;
+  boost::fast_condition_variable cv1(cv0);
+}
+
+#include "../../../remove_error_code_unused_warning.hpp"
@@ -0,0 +1,60 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/fast_condition_variable.hpp>
+
+// class fast_condition_variable;
+
+// void notify_all();
+
+#include <boost/thread/fast_condition_variable.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+boost::fast_condition_variable cv;
+boost::fast_mutex mut;
+
+const int n_threads = 8;
+const int n_rounds = 100;
+
+int current_round = 0;
+int waiting = 0;
+int done = 0;
+
+void f()
+{
+  boost::unique_lock<boost::fast_mutex> lk(mut);
+  for (int r = 0; r < n_rounds; ++r)
+  {
+    ++waiting;
+    cv.notify_all();
+    // all the waiters are moved to the mutex: each of them must get it in turn.
+    while (current_round == r)
+      cv.wait(lk);
+  }
+  ++done;
+}
+
+int main()
+{
+  boost::thread_group g;
+  for (int i = 0; i < n_threads; ++i)
+    g.create_thread(&f);
+  {
+    boost::unique_lock<boost::fast_mutex> lk(mut);
+    for (int r = 0; r < n_rounds; ++r)
+    {
+      while (waiting != n_threads)
+        cv.wait(lk);
+      waiting = 0;
+      ++current_round;
+      cv.notify_all();
+    }
+  }
+  g.join_all();
+  BOOST_TEST_EQ(done, n_threads);
+
+  return boost::report_errors();
+}
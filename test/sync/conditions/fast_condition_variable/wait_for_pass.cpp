@@ -0,0 +1,71 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/fast_condition_variable.hpp>
+
+// class fast_condition_variable;
+
+// template <class Rep, class Period>
+//   cv_status wait_for(unique_lock<fast_mutex>& lock, const chrono::duration<Rep, Period>& rel_time);
+// template <class Rep, class Period, class Predicate>
+//   bool wait_for(unique_lock<fast_mutex>& lock, const chrono::duration<Rep, Period>& rel_time, Predicate pred);
+
+#include <boost/thread/fast_condition_variable.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+#if defined BOOST_THREAD_USES_CHRONO
+
+typedef boost::chrono::steady_clock Clock;
+typedef boost::chrono::milliseconds milliseconds;
+
+boost::fast_condition_variable cv;
+boost::fast_mutex mut;
+
+int test1 = 0;
+int test2 = 0;
+
+struct test2_set
+{
+  bool operator()() const { return test2 != 0; }
+};
+
+void f()
+{
+  boost::unique_lock<boost::fast_mutex> lk(mut);
+  test1 = 1;
+  cv.notify_one();
+  BOOST_TEST(cv.wait_for(lk, milliseconds(5000), test2_set()));
+}
+
+int main()
+{
+  {
+    // nobody notifies: times out.
+    boost::unique_lock<boost::fast_mutex> lk(mut);
+    Clock::time_point t0 = Clock::now();
+    while (cv.wait_for(lk, milliseconds(250)) == boost::cv_status::no_timeout)
+    {
+    }
+    Clock::time_point t1 = Clock::now();
+    BOOST_TEST(t1 - t0 >= milliseconds(250));
+    BOOST_TEST(!cv.wait_for(lk, milliseconds(50), test2_set()));
+  }
+  {
+    boost::unique_lock<boost::fast_mutex> lk(mut);
+    boost::thread t(f);
+    while (test1 == 0)
+      cv.wait(lk);
+    test2 = 1;
+    lk.unlock();
+    cv.notify_one();
+    t.join();
+  }
+
+  return boost::report_errors();
+}
+#else
+#error "Test not applicable: BOOST_THREAD_USES_CHRONO not defined for this platform as not supported"
+#endif
@@ -0,0 +1,48 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/fast_condition_variable.hpp>
+
+// class fast_condition_variable;
+
+// void wait(unique_lock<fast_mutex>& lock);
+// void notify_one();
+
+#include <boost/thread/fast_condition_variable.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+boost::fast_condition_variable cv;
+boost::fast_mutex mut;
+
+int test1 = 0;
+int test2 = 0;
+
+void f()
+{
+  boost::unique_lock<boost::fast_mutex> lk(mut);
+  BOOST_TEST(test2 == 0);
+  test1 = 1;
+  cv.notify_one();
+  while (test2 == 0)
+    cv.wait(lk);
+  BOOST_TEST(test2 != 0);
+}
+
+int main()
+{
+  boost::unique_lock<boost::fast_mutex> lk(mut);
+  boost::thread t(f);
+  BOOST_TEST(test1 == 0);
+  while (test1 == 0)
+    cv.wait(lk);
+  BOOST_TEST(test1 != 0);
+  test2 = 1;
+  lk.unlock();
+  cv.notify_one();
+  t.join();
+
+  return boost::report_errors();
+}
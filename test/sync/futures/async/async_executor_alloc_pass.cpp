@@ -0,0 +1,72 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/future.hpp>
+
+// template <class Allocator, class Executor, class F, class... Args>
+//     future<typename result_of<F(Args...)>::type>
+//     async(allocator_arg_t, const Allocator& a, Executor& ex, F&& f, Args&&... args);
+
+#define BOOST_THREAD_VERSION 4
+#define BOOST_THREAD_PROVIDES_EXECUTORS
+#include <boost/config.hpp>
+#if ! defined  BOOST_NO_CXX11_DECLTYPE
+#define BOOST_RESULT_OF_USE_DECLTYPE
+#endif
+#include <boost/thread/future.hpp>
+#include <boost/thread/executors/basic_thread_pool.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+#if defined BOOST_THREAD_PROVIDES_FUTURE_CTOR_ALLOCATORS && ! defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+#include "../test_allocator.hpp"
+
+int f0()
+{
+  return 3;
+}
+
+void f1()
+{
+}
+
+int f2(int i)
+{
+  return i * 2;
+}
+
+int main()
+{
+  // the pool releases the shared state once the task has run: the pool is joined before checking the count.
+  BOOST_TEST(test_alloc_base::count == 0);
+  {
+    boost::basic_thread_pool ex(1);
+    boost::future<int> f = boost::async(boost::allocator_arg, test_allocator<int>(), ex, &f0);
+    BOOST_TEST(test_alloc_base::count == 1);
+    BOOST_TEST(f.get() == 3);
+  }
+  BOOST_TEST(test_alloc_base::count == 0);
+  {
+    boost::basic_thread_pool ex(1);
+    boost::future<void> f = boost::async(boost::allocator_arg, test_allocator<int>(), ex, &f1);
+    BOOST_TEST(test_alloc_base::count == 1);
+    f.get();
+  }
+  BOOST_TEST(test_alloc_base::count == 0);
+  {
+    boost::basic_thread_pool ex(1);
+    boost::future<int> f = boost::async(boost::allocator_arg, test_allocator<int>(), ex, &f2, 4);
+    BOOST_TEST(test_alloc_base::count == 1);
+    BOOST_TEST(f.get() == 8);
+  }
+  BOOST_TEST(test_alloc_base::count == 0);
+  return boost::report_errors();
+}
+
+#else
+int main()
+{
+  return boost::report_errors();
+}
+#endif
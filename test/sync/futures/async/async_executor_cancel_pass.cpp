@@ -0,0 +1,95 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/future.hpp>
+
+// template <class Executor, class F, class... Args>
+//     future<typename result_of<F(Args...)>::type>
+//     async(Executor& ex, cancellation_token const& token, F&& f, Args&&... args);
+
+#define BOOST_THREAD_VERSION 4
+#define BOOST_THREAD_PROVIDES_EXECUTORS
+#include <boost/config.hpp>
+#if ! defined  BOOST_NO_CXX11_DECLTYPE
+#define BOOST_RESULT_OF_USE_DECLTYPE
+#endif
+#include <boost/thread/future.hpp>
+#include <boost/thread/executors/basic_thread_pool.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+#if ! defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+
+int invoked = 0;
+
+int f0()
+{
+  ++invoked;
+  return 3;
+}
+
+int f2(int i)
+{
+  ++invoked;
+  return i * 2;
+}
+
+int wait_for(boost::shared_future<void> gate)
+{
+  gate.wait();
+  return 0;
+}
+
+int main()
+{
+  {
+    boost::basic_thread_pool ex(1);
+    boost::cancellation_source src;
+    boost::future<int> f = boost::async(ex, src.get_token(), &f0);
+    BOOST_TEST(f.get() == 3);
+    BOOST_TEST(src.shed_count() == 0);
+  }
+  {
+    invoked = 0;
+    boost::basic_thread_pool ex(1);
+    boost::promise<void> gate;
+    boost::shared_future<void> sgate = gate.get_future().share();
+    boost::cancellation_source src;
+    boost::cancellation_token token = src.get_token();
+    // block the single worker so that the next tasks stay in the queue.
+    boost::future<int> blocker = boost::async(ex, &wait_for, sgate);
+    boost::future<int> r1 = boost::async(ex, token, &f0);
+    boost::future<int> r2 = boost::async(ex, token, &f2, 4);
+    src.request_cancellation();
+    BOOST_TEST(token.is_cancellation_requested());
+    gate.set_value();
+    BOOST_TEST(blocker.get() == 0);
+    try {
+      r1.get();
+      BOOST_TEST(false);
+    } catch (boost::future_error& e) {
+      BOOST_TEST(e.code() == boost::system::make_error_code(boost::future_errc::cancelled));
+    }
+    try {
+      r2.get();
+      BOOST_TEST(false);
+    } catch (boost::future_cancelled&) {
+    }
+    BOOST_TEST(invoked == 0);
+    BOOST_TEST(src.shed_count() == 2);
+  }
+  {
+    boost::cancellation_token token;
+    BOOST_TEST(! token.cancellation_possible());
+    BOOST_TEST(! token.is_cancellation_requested());
+  }
+  return boost::report_errors();
+}
+
+#else
+int main()
+{
+  return boost::report_errors();
+}
+#endif
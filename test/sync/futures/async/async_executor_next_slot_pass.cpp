@@ -0,0 +1,133 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/executors/basic_thread_pool.hpp>
+
+// class basic_thread_pool
+
+// A closure submitted from a worker thread runs next on the same worker, within a budget, and can be stolen by
+// an idle worker.
+
+#define BOOST_THREAD_VERSION 4
+#define BOOST_THREAD_PROVIDES_EXECUTORS
+#define BOOST_THREAD_USES_CHRONO
+
+#include <boost/thread/future.hpp>
+#include <boost/thread/executors/basic_thread_pool.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/lock_guard.hpp>
+#include <boost/detail/lightweight_test.hpp>
+#include <vector>
+
+boost::basic_thread_pool* pool = 0;
+// the pool must not be closed before the closures submitted by the workers have been submitted.
+boost::promise<void>* done = 0;
+boost::mutex order_mtx;
+std::vector<int> order;
+
+void record(int i)
+{
+  boost::lock_guard<boost::mutex> lk(order_mtx);
+  order.push_back(i);
+}
+
+void first() { record(1); done->set_value(); }
+void second() { record(2); }
+
+void submitter()
+{
+  record(0);
+  pool->submit(&first);
+  pool->submit(&second);
+}
+
+int chain_length = 0;
+int queued_at = -1;
+
+void queued()
+{
+  queued_at = chain_length;
+}
+
+void chain()
+{
+  if (++chain_length == 1)
+  {
+    // goes to the queue, as the next submission from this worker displaces it from the slot.
+    pool->submit(&queued);
+  }
+  if (chain_length < 200)
+  {
+    pool->submit(&chain);
+  }
+  else
+  {
+    done->set_value();
+  }
+}
+
+boost::promise<void>* stolen = 0;
+
+void set_stolen()
+{
+  stolen->set_value();
+}
+
+void blocked()
+{
+  pool->submit(&set_stolen);
+  // a timed wait doesn't run the closures of the pool, so another worker must steal set_stolen.
+  record(stolen->get_future().wait_for(boost::chrono::seconds(10)) == boost::future_status::ready ? 1 : 0);
+  done->set_value();
+}
+
+int main()
+{
+  {
+    boost::basic_thread_pool ex(1);
+    boost::promise<void> p;
+    done = &p;
+    pool = &ex;
+    ex.submit(&submitter);
+    p.get_future().wait();
+  }
+  BOOST_TEST_EQ(order.size(), 3u);
+  if (order.size() == 3)
+  {
+    // the last submission runs first.
+    BOOST_TEST_EQ(order[0], 0);
+    BOOST_TEST_EQ(order[1], 2);
+    BOOST_TEST_EQ(order[2], 1);
+  }
+  {
+    boost::basic_thread_pool ex(1);
+    boost::promise<void> p;
+    done = &p;
+    pool = &ex;
+    ex.submit(&chain);
+    p.get_future().wait();
+  }
+  BOOST_TEST_EQ(chain_length, 200);
+  // the budget lets the queued closure run before the end of the chain.
+  BOOST_TEST(queued_at > 0);
+  BOOST_TEST(queued_at < 100);
+  order.clear();
+  {
+    boost::promise<void> s;
+    stolen = &s;
+    boost::basic_thread_pool ex(2);
+    boost::promise<void> p;
+    done = &p;
+    pool = &ex;
+    ex.submit(&blocked);
+    p.get_future().wait();
+  }
+  BOOST_TEST_EQ(order.size(), 1u);
+  if (order.size() == 1)
+  {
+    BOOST_TEST_EQ(order[0], 1);
+  }
+  return boost::report_errors();
+}
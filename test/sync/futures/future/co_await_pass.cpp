@@ -0,0 +1,165 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/future_coroutine.hpp>
+
+// template <class R>
+//   unspecified operator co_await(future<R>&& f);
+// template <class R>
+//   unspecified operator co_await(shared_future<R> const& f);
+// template <class Executor>
+//   unspecified schedule_on(Executor& ex);
+//
+// future<R> as a coroutine return type.
+
+#define BOOST_THREAD_VERSION 4
+#define BOOST_THREAD_PROVIDES_EXECUTORS
+
+#include <boost/thread/future_coroutine.hpp>
+#include <boost/thread/executors/basic_thread_pool.hpp>
+#include <boost/thread/executors/loop_executor.hpp>
+#include <boost/thread/thread_only.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+#if defined BOOST_THREAD_PROVIDES_FUTURE_COROUTINES
+
+boost::future<int> twice(boost::future<int> f)
+{
+  int i = co_await std::move(f);
+  co_return 2 * i;
+}
+
+boost::future<void> add_to(boost::shared_future<int> f, int& sum)
+{
+  sum += co_await f;
+  co_return;
+}
+
+boost::future<int> throws(boost::future<int> f)
+{
+  co_await std::move(f);
+  throw 3;
+  co_return 0;
+}
+
+// the resumed coroutine releases the last references to the shared state it was waiting on.
+boost::future<void> delete_promise(boost::future<int> f, boost::promise<int>* p, int& value)
+{
+  value = co_await std::move(f);
+  delete p;
+  co_return;
+}
+
+boost::future<boost::thread::id> on_executor(boost::basic_thread_pool& ex)
+{
+  co_await boost::schedule_on(ex);
+  co_return boost::this_thread::get_id();
+}
+
+boost::future<int> on_loop(boost::loop_executor& ex)
+{
+  co_await schedule_on(ex);
+  co_return 1;
+}
+
+int main()
+{
+  {
+    // the coroutine is suspended until the promise is satisfied.
+    boost::promise<int> p;
+    boost::future<int> f = twice(p.get_future());
+    BOOST_TEST(! f.is_ready());
+    p.set_value(3);
+    BOOST_TEST(f.is_ready());
+    BOOST_TEST(f.get() == 6);
+  }
+  {
+    // the shared state is destroyed by the thread satisfying it, once its mutex is unlocked.
+    boost::promise<int>* p = new boost::promise<int>();
+    int value = 0;
+    boost::future<void> f = delete_promise(p->get_future(), p, value);
+    p->set_value(7);
+    BOOST_TEST(f.is_ready());
+    BOOST_TEST(value == 7);
+  }
+  {
+    // awaiting a ready future doesn't suspend.
+    boost::future<int> f = twice(boost::make_ready_future(4));
+    BOOST_TEST(f.is_ready());
+    BOOST_TEST(f.get() == 8);
+  }
+  {
+    // awaiting a deferred future executes it.
+    boost::future<int> f = twice(boost::async(boost::launch::deferred, []() { return 5; }));
+    BOOST_TEST(f.get() == 10);
+  }
+  {
+    boost::promise<int> p;
+    boost::future<int> f = twice(boost::async(boost::launch::async, [&p]() { return p.get_future().get(); }));
+    p.set_value(7);
+    BOOST_TEST(f.get() == 14);
+  }
+  {
+    // the coroutine releases the last reference to the state of the task, once the pool worker has run it.
+    boost::basic_thread_pool ex(1);
+    boost::future<int> f = twice(boost::async(ex, []() { return 6; }));
+    BOOST_TEST(f.get() == 12);
+  }
+  {
+    // several coroutines can wait for the same shared_future.
+    boost::promise<int> p;
+    boost::shared_future<int> sf = p.get_future().share();
+    int sum = 0;
+    boost::future<void> f1 = add_to(sf, sum);
+    boost::future<void> f2 = add_to(sf, sum);
+    BOOST_TEST(! f1.is_ready());
+    p.set_value(2);
+    f1.get();
+    f2.get();
+    BOOST_TEST(sum == 4);
+  }
+  {
+    boost::promise<int> p;
+    boost::future<int> f = throws(p.get_future());
+    p.set_value(1);
+    try {
+      f.get();
+      BOOST_TEST(false);
+    } catch (int i) {
+      BOOST_TEST(i == 3);
+    }
+  }
+  {
+    boost::promise<int> p;
+    boost::future<int> f = twice(p.get_future());
+    p.set_exception(boost::copy_exception(std::logic_error("5")));
+    try {
+      f.get();
+      BOOST_TEST(false);
+    } catch (std::logic_error&) {
+    }
+  }
+  {
+    boost::basic_thread_pool ex(1);
+    boost::future<boost::thread::id> f = on_executor(ex);
+    BOOST_TEST(f.get() != boost::this_thread::get_id());
+  }
+  {
+    boost::loop_executor ex;
+    boost::future<int> f = on_loop(ex);
+    BOOST_TEST(! f.is_ready());
+    BOOST_TEST(ex.try_executing_one());
+    BOOST_TEST(f.get() == 1);
+  }
+  return boost::report_errors();
+}
+
+#else
+
+int main()
+{
+  return boost::report_errors();
+}
+#endif
@@ -0,0 +1,83 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/future.hpp>
+
+// class future<R>
+
+// template <class Executor>
+// R future::get(Executor& ex);
+// template <class Executor>
+// void future::wait(Executor& ex) const;
+
+#define BOOST_THREAD_VERSION 4
+#define BOOST_THREAD_PROVIDES_EXECUTORS
+
+#include <boost/thread/future.hpp>
+#include <boost/thread/executors/basic_thread_pool.hpp>
+#include <boost/thread/executors/loop_executor.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+#if defined BOOST_THREAD_PROVIDES_VARIADIC_THREAD
+boost::basic_thread_pool* pool = 0;
+
+// each task waits on the tasks it submits to a single-threaded pool, so that the worker thread must run them
+// while waiting.
+struct fib
+{
+  typedef int result_type;
+  int n;
+  explicit fib(int n) : n(n) {}
+  int operator()() const
+  {
+    if (n < 2) return n;
+    boost::future<int> f1 = boost::async(*pool, fib(n - 1));
+    boost::future<int> f2 = boost::async(*pool, fib(n - 2));
+    return f1.get() + f2.get();
+  }
+};
+#endif
+
+int seven()
+{
+  return 7;
+}
+
+int main()
+{
+#if defined BOOST_THREAD_PROVIDES_VARIADIC_THREAD
+  {
+    boost::basic_thread_pool ex(1);
+    pool = &ex;
+    boost::future<int> f = boost::async(ex, fib(10));
+    BOOST_TEST_EQ(f.get(), 55);
+  }
+  {
+    boost::basic_thread_pool ex(2);
+    pool = &ex;
+    boost::future<int> f = boost::async(ex, fib(12));
+    BOOST_TEST_EQ(f.get(ex), 144);
+  }
+#endif
+  {
+    boost::loop_executor ex;
+    boost::future<int> f = boost::async(ex, &seven);
+    BOOST_TEST_EQ(f.get(ex), 7);
+  }
+  {
+    boost::loop_executor ex;
+    boost::future<int> f = boost::async(ex, &seven);
+    f.wait(ex);
+    BOOST_TEST(f.is_ready());
+    BOOST_TEST_EQ(f.get(), 7);
+  }
+  {
+    boost::loop_executor ex;
+    boost::shared_future<int> f = boost::async(ex, &seven).share();
+    BOOST_TEST_EQ(f.get(ex), 7);
+    BOOST_TEST_EQ(f.get(), 7);
+  }
+  return boost::report_errors();
+}
@@ -0,0 +1,58 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/future.hpp>
+
+// class future<R>
+
+// template<typename Allocator, typename F>
+// auto then(allocator_arg_t, const Allocator& a, launch policy, F&& func) -> future<decltype(func(*this))>;
+
+#define BOOST_THREAD_VERSION 4
+#include <boost/config.hpp>
+#if ! defined  BOOST_NO_CXX11_DECLTYPE
+#define BOOST_RESULT_OF_USE_DECLTYPE
+#endif
+
+#include <boost/thread/future.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+#if defined BOOST_THREAD_PROVIDES_FUTURE_CONTINUATION && defined BOOST_THREAD_PROVIDES_FUTURE_CTOR_ALLOCATORS
+#include "../test_allocator.hpp"
+
+int p2(boost::future<int> f)
+{
+  return 2 * f.get();
+}
+
+int main()
+{
+  BOOST_TEST(test_alloc_base::count == 0);
+  {
+    boost::future<int> f1 = boost::make_ready_future(boost::allocator_arg, test_allocator<int>(), 1);
+    BOOST_TEST(test_alloc_base::count == 1);
+    BOOST_TEST(f1.is_ready());
+    boost::future<int> f2 = f1.then(boost::allocator_arg, test_allocator<int>(), boost::launch::deferred, &p2);
+    BOOST_TEST(test_alloc_base::count == 2);
+    BOOST_TEST(f2.get() == 2);
+  }
+  BOOST_TEST(test_alloc_base::count == 0);
+  {
+    boost::promise<int> p;
+    boost::future<int> f1 = p.get_future();
+    boost::future<int> f2 = f1.then(boost::allocator_arg, test_allocator<int>(), &p2);
+    p.set_value(3);
+    BOOST_TEST(f2.get() == 6);
+  }
+  return boost::report_errors();
+}
+
+#else
+
+int main()
+{
+  return 0;
+}
+#endif
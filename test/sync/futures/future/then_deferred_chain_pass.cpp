@@ -0,0 +1,80 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/future.hpp>
+
+// class future<R>
+
+// template<typename F>
+// auto then(launch::deferred, F&& func) -> future<decltype(func(*this))>;
+//
+// a chain of deferred continuations is evaluated in order, innermost stage first, when the last future is waited for.
+
+#define BOOST_THREAD_VERSION 4
+#include <boost/config.hpp>
+#if ! defined  BOOST_NO_CXX11_DECLTYPE
+#define BOOST_RESULT_OF_USE_DECLTYPE
+#endif
+
+#include <boost/thread/future.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+#if defined BOOST_THREAD_PROVIDES_FUTURE_CONTINUATION
+
+int calls = 0;
+
+int p2(boost::future<int> f)
+{
+  ++calls;
+  return f.get() + 1;
+}
+
+int p3(boost::future<int> f)
+{
+  int i = f.get();
+  BOOST_TEST(calls == i);
+  ++calls;
+  return i + 1;
+}
+
+int main()
+{
+  {
+    calls = 0;
+    boost::promise<int> p;
+    boost::future<int> f = p.get_future();
+    for (int i = 0; i < 10; ++i)
+    {
+      f = f.then(boost::launch::deferred, &p3);
+    }
+    p.set_value(0);
+    BOOST_TEST(calls == 0);
+    BOOST_TEST(f.get() == 10);
+    BOOST_TEST(calls == 10);
+  }
+  {
+    // deeper than the chain evaluated in a single round.
+    calls = 0;
+    boost::promise<int> p;
+    boost::future<int> f = p.get_future();
+    for (int i = 0; i < 100; ++i)
+    {
+      f = f.then(boost::launch::deferred, &p2);
+    }
+    p.set_value(0);
+    BOOST_TEST(calls == 0);
+    BOOST_TEST(f.get() == 100);
+    BOOST_TEST(calls == 100);
+  }
+  return boost::report_errors();
+}
+
+#else
+
+int main()
+{
+  return 0;
+}
+#endif
@@ -0,0 +1,112 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/future.hpp>
+
+// class future<R>
+
+// template<typename Ex, typename F>
+// auto then(Ex& ex, cancellation_token const& token, F&& func) -> future<decltype(func(*this))>;
+
+#define BOOST_THREAD_VERSION 4
+#define BOOST_THREAD_PROVIDES_EXECUTORS
+#include <boost/config.hpp>
+#if ! defined  BOOST_NO_CXX11_DECLTYPE
+#define BOOST_RESULT_OF_USE_DECLTYPE
+#endif
+
+#include <boost/thread/future.hpp>
+#include <boost/thread/executors/basic_thread_pool.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+#if defined BOOST_THREAD_PROVIDES_FUTURE_CONTINUATION
+
+int invoked = 0;
+
+int p2(boost::future<int> f)
+{
+  ++invoked;
+  return 2 * f.get();
+}
+
+void p3(boost::future<int> f)
+{
+  ++invoked;
+  f.get();
+}
+
+int sp1(boost::shared_future<int> f)
+{
+  return f.get() + 1;
+}
+
+int main()
+{
+  {
+    boost::basic_thread_pool ex(1);
+    boost::promise<int> p;
+    boost::future<int> f1 = p.get_future();
+    boost::future<int> f2 = f1.then(ex, &p2);
+    p.set_value(3);
+    BOOST_TEST(f2.get() == 6);
+  }
+  {
+    invoked = 0;
+    boost::basic_thread_pool ex(1);
+    boost::cancellation_source src;
+    boost::promise<int> p;
+    boost::future<int> f1 = p.get_future();
+    boost::future<int> f2 = f1.then(ex, src.get_token(), &p2);
+    boost::future<void> f3 = f2.then(ex, src.get_token(), &p3);
+    src.request_cancellation();
+    p.set_value(3);
+    try {
+      f3.get();
+      BOOST_TEST(false);
+    } catch (boost::future_cancelled&) {
+    }
+    BOOST_TEST(invoked == 0);
+    BOOST_TEST(src.shed_count() == 2);
+  }
+  {
+    // the cancellation of the parent cascades to the continuations having a token.
+    invoked = 0;
+    boost::basic_thread_pool ex(1);
+    boost::cancellation_source src1;
+    boost::cancellation_source src2;
+    boost::promise<int> p;
+    boost::future<int> f1 = p.get_future();
+    boost::future<int> f2 = f1.then(ex, src1.get_token(), &p2);
+    boost::future<int> f3 = f2.then(ex, src2.get_token(), &p2);
+    src1.request_cancellation();
+    p.set_value(3);
+    try {
+      f3.get();
+      BOOST_TEST(false);
+    } catch (boost::future_cancelled&) {
+    }
+    BOOST_TEST(invoked == 0);
+    BOOST_TEST(src1.shed_count() == 1);
+    BOOST_TEST(src2.shed_count() == 1);
+  }
+  {
+    boost::basic_thread_pool ex(1);
+    boost::promise<int> p;
+    boost::shared_future<int> f1 = p.get_future().share();
+    boost::cancellation_source src;
+    boost::future<int> f2 = f1.then(ex, src.get_token(), &sp1);
+    p.set_value(1);
+    BOOST_TEST(f2.get() == 2);
+  }
+  return boost::report_errors();
+}
+
+#else
+
+int main()
+{
+  return 0;
+}
+#endif
@@ -0,0 +1,105 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/executors/executor_ref.hpp>
+
+// class executor_ref
+
+// template<typename F>
+// auto future<R>::then(executor_ref& ex, F&& func) -> future<decltype(func(*this))>;
+
+#define BOOST_THREAD_VERSION 4
+#define BOOST_THREAD_PROVIDES_EXECUTORS
+#include <boost/config.hpp>
+#if ! defined  BOOST_NO_CXX11_DECLTYPE
+#define BOOST_RESULT_OF_USE_DECLTYPE
+#endif
+
+#include <boost/thread/future.hpp>
+#include <boost/thread/executors/executor_ref.hpp>
+#include <boost/thread/executors/basic_thread_pool.hpp>
+#include <boost/thread/executors/loop_executor.hpp>
+#include <boost/thread/executors/serial_executor.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+#if defined BOOST_THREAD_PROVIDES_FUTURE_CONTINUATION
+
+int p1()
+{
+  return 1;
+}
+
+int p2(boost::future<int> f)
+{
+  return 2 * f.get();
+}
+
+int counter = 0;
+
+void increment()
+{
+  ++counter;
+}
+
+boost::executor_ref make_ref(boost::basic_thread_pool& pool)
+{
+  return boost::executor_ref(pool);
+}
+
+int main()
+{
+  {
+    boost::loop_executor ex;
+    boost::executor_ref ref(ex);
+    boost::executor_ref copy(ref);
+    copy.submit(&increment);
+    BOOST_TEST(ref.try_executing_one());
+    BOOST_TEST(! copy.try_executing_one());
+    BOOST_TEST_EQ(counter, 1);
+    BOOST_TEST(! ref.closed());
+    ref.close();
+    BOOST_TEST(ex.closed());
+  }
+  {
+    boost::basic_thread_pool pool(1);
+    boost::executor_ref ref(pool);
+    boost::future<int> f1 = boost::async(ref, &p1);
+    boost::future<int> f2 = f1.then(ref, &p2);
+    BOOST_TEST_EQ(f2.get(), 2);
+  }
+  {
+    boost::basic_thread_pool pool(1);
+    boost::promise<int> p;
+    boost::future<int> f2;
+    {
+      // the continuation stores a copy of the reference, not a pointer to it.
+      boost::executor_ref ref = make_ref(pool);
+      f2 = p.get_future().then(ref, &p2);
+    }
+    p.set_value(3);
+    BOOST_TEST_EQ(f2.get(), 6);
+  }
+  {
+    boost::basic_thread_pool pool(2);
+    counter = 0;
+    {
+      boost::serial_executor serial(pool);
+      for (int i = 0; i < 10; ++i)
+      {
+        serial.submit(&increment);
+      }
+    }
+    BOOST_TEST_EQ(counter, 10);
+  }
+  return boost::report_errors();
+}
+
+#else
+
+int main()
+{
+  return 0;
+}
+#endif
@@ -39,6 +39,11 @@ int p2(boost::future<int> f)
   return 2 * i;
 }
 
+int p4(boost::future<int> f)
+{
+  return f.get() + 1;
+}
+
 void p3(boost::future<int> f)
 {
   BOOST_THREAD_LOG << "p3 <" << &f << BOOST_THREAD_END_LOG;
@@ -117,6 +122,13 @@ int main()
     boost::future<int> f2 = boost::async(p1).then(&p2).then(&p2);
     BOOST_TEST(f2.get()==4);
   }
+  BOOST_THREAD_LOG << BOOST_THREAD_END_LOG;
+  for (int i = 0; i < 1000; ++i)
+  {
+    // the continuation can consume and destroy the ready parent before then() returns.
+    boost::future<int> f2 = boost::make_ready_future(1).then(boost::launch::async, &p4);
+    BOOST_TEST(f2.get()==2);
+  }
 
   return boost::report_errors();
 }
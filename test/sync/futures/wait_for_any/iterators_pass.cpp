@@ -0,0 +1,73 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/future.hpp>
+
+// template<typename Iterator>
+// Iterator wait_for_any(Iterator begin, Iterator end);
+
+#define BOOST_THREAD_VERSION 4
+
+#include <boost/thread/future.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/detail/lightweight_test.hpp>
+#include <vector>
+
+const unsigned n = 1000;
+
+void set_one(boost::promise<int>* p, int v)
+{
+  boost::this_thread::sleep_for(boost::chrono::milliseconds(50));
+  p->set_value(v);
+}
+
+int main()
+{
+  {
+    // the only future becoming ready is the last one registered
+    boost::promise<int> promises[n];
+    std::vector<boost::shared_future<int> > futures;
+    for (unsigned i = 0; i < n; ++i)
+      futures.push_back(promises[i].get_future().share());
+    boost::thread t(set_one, &promises[n - 1], 42);
+    std::vector<boost::shared_future<int> >::iterator it = boost::wait_for_any(futures.begin(), futures.end());
+    BOOST_TEST(it == futures.begin() + (n - 1));
+    BOOST_TEST(it->get() == 42);
+    t.join();
+  }
+  {
+    // futures already ready are found while registering
+    boost::promise<int> promises[n];
+    std::vector<boost::shared_future<int> > futures;
+    for (unsigned i = 0; i < n; ++i)
+      futures.push_back(promises[i].get_future().share());
+    promises[n / 2].set_value(1);
+    promises[n / 3].set_value(2);
+    std::vector<boost::shared_future<int> >::iterator it = boost::wait_for_any(futures.begin(), futures.end());
+    BOOST_TEST(it == futures.begin() + n / 3);
+  }
+  {
+    // the same shared state can be waited for several times
+    boost::promise<int> p;
+    std::vector<boost::shared_future<int> > futures(3, p.get_future().share());
+    boost::thread t(set_one, &p, 3);
+    std::vector<boost::shared_future<int> >::iterator it = boost::wait_for_any(futures.begin(), futures.end());
+    BOOST_TEST(it != futures.end());
+    BOOST_TEST(it->get() == 3);
+    t.join();
+  }
+  {
+    // the waiter can be reused once unregistered from the previous call
+    boost::promise<int> p1;
+    boost::promise<int> p2;
+    boost::shared_future<int> f1 = p1.get_future().share();
+    boost::shared_future<int> f2 = p2.get_future().share();
+    p2.set_value(2);
+    BOOST_TEST(boost::wait_for_any(f1, f2) == 1u);
+    p1.set_value(1);
+    BOOST_TEST(boost::wait_for_any(f1, f2) == 0u);
+  }
+  return boost::report_errors();
+}
@@ -0,0 +1,20 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/fast_mutex.hpp>
+
+// class fast_mutex;
+
+// fast_mutex(const fast_mutex&) = delete;
+
+#include <boost/thread/fast_mutex.hpp>
+
+int main()
+{
+  boost::fast_mutex m0;
+  boost::fast_mutex m1(m0);
+}
+
+#include "../../../remove_error_code_unused_warning.hpp"
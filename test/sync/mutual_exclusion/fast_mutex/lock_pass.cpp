@@ -0,0 +1,81 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/fast_mutex.hpp>
+
+// class fast_mutex;
+
+// void lock();
+// void unlock();
+
+#include <boost/thread/fast_mutex.hpp>
+#include <boost/thread/lock_types.hpp>
+#include <boost/thread/lock_algorithms.hpp>
+#include <boost/thread/lockable_concepts.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+BOOST_CONCEPT_ASSERT(( boost::Lockable<boost::fast_mutex> ));
+
+boost::fast_mutex m;
+
+typedef boost::chrono::steady_clock Clock;
+typedef Clock::time_point time_point;
+typedef boost::chrono::milliseconds ms;
+
+const int N_THREADS = 4;
+const int N_LOCKS = 20000;
+long counter = 0;
+
+void f()
+{
+  time_point t0 = Clock::now();
+  m.lock();
+  time_point t1 = Clock::now();
+  m.unlock();
+  BOOST_TEST(t1 - t0 >= ms(200));
+}
+
+void increment()
+{
+  for (int i = 0; i < N_LOCKS; ++i)
+  {
+    boost::unique_lock<boost::fast_mutex> lk(m);
+    ++counter;
+  }
+}
+
+int main()
+{
+  {
+    m.lock();
+    boost::thread t(f);
+    boost::this_thread::sleep_for(ms(250));
+    m.unlock();
+    t.join();
+  }
+  {
+    // contended: the unlock wakes the blocked threads.
+    boost::thread_group g;
+    for (int i = 0; i < N_THREADS; ++i) g.create_thread(increment);
+    g.join_all();
+    BOOST_TEST_EQ(counter, N_THREADS * N_LOCKS);
+  }
+  {
+    boost::fast_mutex m2;
+    boost::lock(m, m2);
+    m.unlock();
+    m2.unlock();
+  }
+  {
+    // a condition_variable_any waits on any lockable.
+    boost::condition_variable_any cv;
+    boost::unique_lock<boost::fast_mutex> lk(m);
+    BOOST_TEST(cv.wait_for(lk, ms(10)) == boost::cv_status::timeout);
+    BOOST_TEST(lk.owns_lock());
+  }
+  return boost::report_errors();
+}
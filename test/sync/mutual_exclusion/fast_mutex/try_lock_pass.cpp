@@ -0,0 +1,40 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/fast_mutex.hpp>
+
+// class fast_mutex;
+
+// bool try_lock();
+
+#include <boost/thread/fast_mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+boost::fast_mutex m;
+
+typedef boost::chrono::milliseconds ms;
+
+void f()
+{
+  BOOST_TEST(!m.try_lock());
+  BOOST_TEST(!m.try_lock());
+  while (!m.try_lock())
+    ;
+  m.unlock();
+}
+
+int main()
+{
+  m.lock();
+  boost::thread t(f);
+  boost::this_thread::sleep_for(ms(250));
+  m.unlock();
+  t.join();
+  BOOST_TEST(m.try_lock());
+  m.unlock();
+
+  return boost::report_errors();
+}
@@ -0,0 +1,65 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/fast_mutex.hpp>
+
+// class fast_timed_mutex;
+
+// template <class Rep, class Period>
+//     bool try_lock_for(const chrono::duration<Rep, Period>& rel_time);
+
+#include <boost/thread/fast_mutex.hpp>
+#include <boost/thread/lockable_concepts.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+BOOST_CONCEPT_ASSERT(( boost::TimedLockable<boost::fast_timed_mutex> ));
+
+boost::fast_timed_mutex m;
+
+typedef boost::chrono::steady_clock Clock;
+typedef Clock::time_point time_point;
+typedef boost::chrono::milliseconds ms;
+
+void f1()
+{
+  time_point t0 = Clock::now();
+  BOOST_TEST(m.try_lock_for(ms(300)+ms(1000)) == true);
+  time_point t1 = Clock::now();
+  m.unlock();
+  BOOST_TEST(t1 - t0 >= ms(200));
+  BOOST_TEST(t1 - t0 < ms(300)+ms(1000));
+}
+
+void f2()
+{
+  time_point t0 = Clock::now();
+  BOOST_TEST(m.try_lock_for(ms(250)) == false);
+  time_point t1 = Clock::now();
+  BOOST_TEST(t1 - t0 >= ms(250));
+  // This test is spurious as it depends on the time the thread system switches the threads
+  BOOST_TEST(t1 - t0 < ms(250)+ms(1000));
+}
+
+int main()
+{
+  {
+    m.lock();
+    boost::thread t(f1);
+    boost::this_thread::sleep_for(ms(250));
+    m.unlock();
+    t.join();
+  }
+  {
+    m.lock();
+    boost::thread t(f2);
+    t.join();
+    m.unlock();
+  }
+  BOOST_TEST(m.try_lock_for(ms(10)));
+  m.unlock();
+
+  return boost::report_errors();
+}
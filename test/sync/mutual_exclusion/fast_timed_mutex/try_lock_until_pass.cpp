@@ -0,0 +1,93 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/fast_mutex.hpp>
+
+// class fast_timed_mutex;
+
+// template <class Clock, class Duration>
+//     bool try_lock_until(const chrono::time_point<Clock, Duration>& abs_time);
+// bool timed_lock(system_time const& abs_time);
+
+#include <boost/thread/fast_mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+boost::fast_timed_mutex m;
+
+typedef boost::chrono::milliseconds ms;
+
+template <class Clock>
+void times_out()
+{
+  typename Clock::time_point t0 = Clock::now();
+  BOOST_TEST(m.try_lock_until(t0 + ms(250)) == false);
+  typename Clock::time_point t1 = Clock::now();
+  BOOST_TEST(t1 - t0 >= ms(250));
+  // This test is spurious as it depends on the time the thread system switches the threads
+  BOOST_TEST(t1 - t0 < ms(250)+ms(1000));
+}
+
+// the deadline is before the epoch of the steady clock once converted.
+template <class Clock>
+void times_out_in_the_past()
+{
+  BOOST_TEST(m.try_lock_until(typename Clock::time_point()) == false);
+  BOOST_TEST(m.try_lock_until(Clock::now() - ms(250)) == false);
+}
+
+template <class Clock>
+void succeeds()
+{
+  BOOST_TEST(m.try_lock_until(Clock::now() + ms(250)+ms(1000)) == true);
+  m.unlock();
+}
+
+#if defined BOOST_THREAD_USES_DATETIME
+void timed_lock_times_out()
+{
+  BOOST_TEST(m.timed_lock(boost::get_system_time() + boost::posix_time::milliseconds(100)) == false);
+}
+#endif
+
+template <class Clock>
+void test_clock()
+{
+  {
+    m.lock();
+    boost::thread t(times_out<Clock>);
+    t.join();
+    m.unlock();
+  }
+  {
+    m.lock();
+    boost::thread t(times_out_in_the_past<Clock>);
+    t.join();
+    m.unlock();
+  }
+  {
+    m.lock();
+    boost::thread t(succeeds<Clock>);
+    boost::this_thread::sleep_for(ms(250));
+    m.unlock();
+    t.join();
+  }
+}
+
+int main()
+{
+  test_clock<boost::chrono::steady_clock>();
+  test_clock<boost::chrono::system_clock>();
+#if defined BOOST_THREAD_USES_DATETIME
+  {
+    m.lock();
+    boost::thread t(timed_lock_times_out);
+    t.join();
+    m.unlock();
+  }
+#endif
+
+  return boost::report_errors();
+}
@@ -0,0 +1,115 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/once.hpp>
+
+// template<class Callable, class ...Args>
+//   void call_once(once_flag& flag, Callable&& func, Args&&... args);
+
+// The threads waiting for the initialization of a flag don't depend on the other flags.
+
+#define BOOST_THREAD_PROVIDES_ONCE_CXX11
+
+#include <boost/thread/once.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/atomic.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+typedef boost::chrono::milliseconds ms;
+
+const int N_THREADS = 4;
+
+// the initialization of slow_flag lasts until the initializations of the fast flags are done.
+boost::once_flag slow_flag;
+boost::atomic<bool> fast_done(false);
+boost::atomic<int> slow_called(0);
+boost::atomic<int> slow_returned(0);
+
+void slow_init()
+{
+    ++slow_called;
+    while (!fast_done.load())
+        boost::this_thread::sleep_for(ms(1));
+}
+
+void slow_caller()
+{
+    boost::call_once(slow_flag, slow_init);
+    ++slow_returned;
+}
+
+const int N_FLAGS = 64;
+boost::once_flag fast_flags[N_FLAGS];
+boost::atomic<int> fast_called(0);
+
+void fast_init()
+{
+    ++fast_called;
+}
+
+void fast_caller()
+{
+    for (int i = 0; i < N_FLAGS; ++i)
+        boost::call_once(fast_flags[i], fast_init);
+}
+
+// the first initialization of failing_flag throws, the waiters retry.
+boost::once_flag failing_flag;
+boost::atomic<int> failing_called(0);
+boost::atomic<int> failing_completed(0);
+
+void failing_init()
+{
+    if (++failing_called == 1)
+    {
+        boost::this_thread::sleep_for(ms(50));
+        throw 1;
+    }
+    ++failing_completed;
+}
+
+void failing_caller()
+{
+    try
+    {
+        boost::call_once(failing_flag, failing_init);
+    }
+    catch (...)
+    {
+    }
+}
+
+int main()
+{
+    {
+        boost::thread_group slow;
+        for (int i = 0; i < N_THREADS; ++i)
+            slow.create_thread(&slow_caller);
+        while (slow_called.load() == 0)
+            boost::this_thread::sleep_for(ms(1));
+
+        boost::thread_group fast;
+        for (int i = 0; i < N_THREADS; ++i)
+            fast.create_thread(&fast_caller);
+        fast.join_all();
+        BOOST_TEST_EQ(fast_called.load(), N_FLAGS);
+        BOOST_TEST_EQ(slow_returned.load(), 0);
+
+        fast_done.store(true);
+        slow.join_all();
+        BOOST_TEST_EQ(slow_called.load(), 1);
+        BOOST_TEST_EQ(slow_returned.load(), N_THREADS);
+    }
+    {
+        boost::thread_group g;
+        for (int i = 0; i < N_THREADS; ++i)
+            g.create_thread(&failing_caller);
+        g.join_all();
+        BOOST_TEST_EQ(failing_called.load(), 2);
+        BOOST_TEST_EQ(failing_completed.load(), 1);
+    }
+
+    return boost::report_errors();
+}
@@ -0,0 +1,20 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/reader_biased_shared_mutex.hpp>
+
+// class reader_biased_shared_mutex;
+
+// reader_biased_shared_mutex(const reader_biased_shared_mutex&) = delete;
+
+#include <boost/thread/reader_biased_shared_mutex.hpp>
+
+int main()
+{
+  boost::reader_biased_shared_mutex m0;
+  boost::reader_biased_shared_mutex m1(m0);
+}
+
+#include "../../../remove_error_code_unused_warning.hpp"
@@ -0,0 +1,35 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/reader_biased_shared_mutex.hpp>
+
+// class reader_biased_shared_mutex;
+
+// reader_biased_shared_mutex();
+
+#include <boost/thread/reader_biased_shared_mutex.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+int main()
+{
+  boost::reader_biased_shared_mutex m;
+  m.lock_shared();
+  BOOST_TEST(m.try_lock_shared());
+  BOOST_TEST(!m.try_lock());
+  m.unlock_shared();
+  m.unlock_shared();
+  BOOST_TEST(m.try_lock());
+  BOOST_TEST(!m.try_lock_shared());
+  m.unlock();
+  m.lock();
+  m.unlock();
+  // the readers go through the underlying mutex after a revocation, then restore the bias.
+  for (long i = 0; i < 2 * boost::reader_biased_shared_mutex::inhibit_reads; ++i)
+  {
+    m.lock_shared();
+    m.unlock_shared();
+  }
+  return boost::report_errors();
+}
@@ -0,0 +1,75 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/reader_biased_shared_mutex.hpp>
+
+// class reader_biased_shared_mutex;
+
+// void lock();
+// void lock_shared();
+
+#include <boost/thread/reader_biased_shared_mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/chrono/thread_clock.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+boost::reader_biased_shared_mutex m;
+
+typedef boost::chrono::steady_clock Clock;
+typedef Clock::time_point time_point;
+typedef boost::chrono::milliseconds ms;
+
+void writer()
+{
+#if defined BOOST_CHRONO_HAS_THREAD_CLOCK
+  boost::chrono::thread_clock::time_point c0 = boost::chrono::thread_clock::now();
+#endif
+  time_point t0 = Clock::now();
+  m.lock();
+  time_point t1 = Clock::now();
+  m.unlock();
+  // the writer waits for the reader recorded in its slot.
+  BOOST_TEST(t1 - t0 >= ms(200));
+#if defined BOOST_CHRONO_HAS_THREAD_CLOCK
+  // blocked, not spinning, while the reader holds the lock.
+  BOOST_TEST(boost::chrono::thread_clock::now() - c0 < ms(100));
+#endif
+}
+
+void reader()
+{
+  time_point t0 = Clock::now();
+  m.lock_shared();
+  time_point t1 = Clock::now();
+  m.unlock_shared();
+  BOOST_TEST(t1 - t0 >= ms(200));
+}
+
+int main()
+{
+  {
+    m.lock_shared();
+    boost::thread t(writer);
+    boost::this_thread::sleep_for(ms(250));
+    m.unlock_shared();
+    t.join();
+  }
+  {
+    m.lock();
+    boost::thread t(reader);
+    boost::this_thread::sleep_for(ms(250));
+    m.unlock();
+    t.join();
+  }
+  {
+    // a second reader does not wait.
+    m.lock_shared();
+    boost::thread t(&boost::reader_biased_shared_mutex::lock_shared, &m);
+    t.join();
+    m.unlock_shared();
+    BOOST_TEST(!m.try_lock());
+  }
+  return boost::report_errors();
+}
@@ -0,0 +1,91 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/reader_biased_shared_mutex.hpp>
+
+// class reader_biased_shared_mutex;
+
+// readers and writers mixing the biased and the revoked states.
+
+#include <boost/thread/reader_biased_shared_mutex.hpp>
+#include <boost/thread/lock_types.hpp>
+#include <boost/thread/shared_lock_guard.hpp>
+#include <boost/thread/synchronized_value.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/atomic.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+namespace
+{
+  const int N_READERS = 4;
+  const int N_WRITERS = 2;
+  const int READS = 20000;
+  const int WRITES = 500;
+
+  boost::reader_biased_shared_mutex m;
+  // both values are always equal outside of a critical section.
+  long a = 0;
+  long b = 0;
+  boost::atomic<int> broken(0);
+
+  void reader()
+  {
+    for (int i = 0; i < READS; ++i)
+    {
+      boost::shared_lock_guard<boost::reader_biased_shared_mutex> lk(m);
+      if (a != b) ++broken;
+    }
+  }
+
+  void writer()
+  {
+    for (int i = 0; i < WRITES; ++i)
+    {
+      boost::unique_lock<boost::reader_biased_shared_mutex> lk(m);
+      ++a;
+      boost::this_thread::yield();
+      ++b;
+    }
+  }
+
+  boost::synchronized_value<int, boost::reader_biased_shared_mutex> counter(0);
+
+  struct incr
+  {
+    typedef void result_type;
+    void operator()(int& v) const
+    {
+      ++v;
+    }
+  };
+
+  void increment()
+  {
+    for (int i = 0; i < WRITES; ++i)
+    {
+      counter(incr());
+    }
+  }
+}
+
+int main()
+{
+  {
+    boost::thread_group g;
+    for (int i = 0; i < N_READERS; ++i) g.create_thread(reader);
+    for (int i = 0; i < N_WRITERS; ++i) g.create_thread(writer);
+    g.join_all();
+  }
+  BOOST_TEST_EQ(broken, 0);
+  BOOST_TEST_EQ(a, N_WRITERS * WRITES);
+  BOOST_TEST_EQ(b, N_WRITERS * WRITES);
+  {
+    boost::thread_group g;
+    for (int i = 0; i < N_WRITERS; ++i) g.create_thread(increment);
+    g.join_all();
+  }
+  BOOST_TEST_EQ(counter.get(), N_WRITERS * WRITES);
+  return boost::report_errors();
+}
@@ -0,0 +1,74 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/reader_biased_shared_mutex.hpp>
+
+// class reader_biased_shared_mutex;
+
+// template <class Rep, class Period>
+//     bool try_lock_for(const chrono::duration<Rep, Period>& rel_time);
+// template <class Rep, class Period>
+//     bool try_lock_shared_for(const chrono::duration<Rep, Period>& rel_time);
+
+#include <boost/thread/reader_biased_shared_mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+boost::reader_biased_shared_mutex m;
+
+typedef boost::chrono::steady_clock Clock;
+typedef Clock::time_point time_point;
+typedef boost::chrono::milliseconds ms;
+
+void writer_times_out()
+{
+  time_point t0 = Clock::now();
+  BOOST_TEST(m.try_lock_for(ms(250)) == false);
+  time_point t1 = Clock::now();
+  BOOST_TEST(t1 - t0 >= ms(250));
+  BOOST_TEST(t1 - t0 < ms(250) + ms(1000));
+}
+
+void writer_succeeds()
+{
+  BOOST_TEST(m.try_lock_for(ms(250) + ms(1000)) == true);
+  m.unlock();
+}
+
+void reader_times_out()
+{
+  time_point t0 = Clock::now();
+  BOOST_TEST(m.try_lock_shared_for(ms(250)) == false);
+  time_point t1 = Clock::now();
+  BOOST_TEST(t1 - t0 >= ms(250));
+}
+
+int main()
+{
+  {
+    // a reader recorded in its slot.
+    m.lock_shared();
+    boost::thread t(writer_times_out);
+    t.join();
+    m.unlock_shared();
+  }
+  {
+    // the bias has been revoked: the reader goes through the underlying mutex.
+    m.lock_shared();
+    boost::thread t(writer_succeeds);
+    boost::this_thread::sleep_for(ms(250));
+    m.unlock_shared();
+    t.join();
+  }
+  {
+    m.lock();
+    boost::thread t(reader_times_out);
+    t.join();
+    m.unlock();
+  }
+  BOOST_TEST(m.try_lock_shared_for(ms(10)));
+  m.unlock_shared();
+  return boost::report_errors();
+}
@@ -0,0 +1,90 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/reader_biased_shared_mutex.hpp>
+
+// class reader_biased_shared_mutex;
+
+// void lock_upgrade();
+// void unlock_upgrade_and_lock();
+// bool try_unlock_shared_and_lock();
+// ...
+
+#define BOOST_THREAD_PROVIDES_SHARED_MUTEX_UPWARDS_CONVERSIONS
+
+#include <boost/thread/reader_biased_shared_mutex.hpp>
+#include <boost/thread/lock_types.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+boost::reader_biased_shared_mutex m;
+
+typedef boost::chrono::steady_clock Clock;
+typedef Clock::time_point time_point;
+typedef boost::chrono::milliseconds ms;
+
+void upgrader()
+{
+  boost::upgrade_lock<boost::reader_biased_shared_mutex> lk(m);
+  time_point t0 = Clock::now();
+  // waits for the reader recorded in its slot.
+  boost::upgrade_to_unique_lock<boost::reader_biased_shared_mutex> ulk(lk);
+  time_point t1 = Clock::now();
+  BOOST_TEST(t1 - t0 >= ms(200));
+}
+
+void reader_converts_while_held()
+{
+  // the upgrade ownership of the main thread is compatible with the readers.
+  m.lock_shared();
+  BOOST_TEST(!m.try_unlock_shared_and_lock_upgrade());
+  BOOST_TEST(!m.try_unlock_shared_and_lock());
+  m.unlock_shared();
+}
+
+int main()
+{
+  {
+    m.lock_shared();
+    boost::thread t(upgrader);
+    boost::this_thread::sleep_for(ms(250));
+    m.unlock_shared();
+    t.join();
+  }
+  {
+    // shared -> upgrade -> exclusive -> shared, from a reader recorded in its slot or not.
+    for (int i = 0; i < 2; ++i)
+    {
+      m.lock_shared();
+      BOOST_TEST(m.try_unlock_shared_and_lock_upgrade());
+      m.unlock_upgrade_and_lock();
+      BOOST_TEST(!m.try_lock_shared());
+      m.unlock_and_lock_shared();
+      BOOST_TEST(m.try_unlock_shared_and_lock());
+      m.unlock_and_lock_upgrade();
+      m.unlock_upgrade_and_lock_shared();
+      m.unlock_shared();
+    }
+  }
+  {
+    m.lock_upgrade();
+    boost::thread t(reader_converts_while_held);
+    t.join();
+    BOOST_TEST(m.try_unlock_upgrade_and_lock());
+    m.unlock();
+  }
+  {
+    m.lock_upgrade();
+    BOOST_TEST(m.try_unlock_upgrade_and_lock_for(ms(10)));
+    m.unlock_and_lock_upgrade();
+    m.unlock_upgrade();
+  }
+  {
+    BOOST_TEST(m.try_lock_upgrade());
+    BOOST_TEST(!m.try_lock_upgrade_for(ms(10)));
+    m.unlock_upgrade();
+  }
+  return boost::report_errors();
+}
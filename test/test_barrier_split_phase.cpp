@@ -0,0 +1,168 @@
+// (C) Copyright 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#define BOOST_THREAD_VERSION 4
+#define BOOST_THREAD_PROVIDES_INTERRUPTIONS
+
+#include <boost/thread/detail/config.hpp>
+
+#include <boost/thread/thread.hpp>
+#include <boost/thread/barrier.hpp>
+#include <boost/thread/latch.hpp>
+#include <boost/thread/executors/basic_thread_pool.hpp>
+#include <boost/atomic.hpp>
+#include <stdexcept>
+
+#include <boost/detail/lightweight_test.hpp>
+
+namespace {
+
+const int N_THREADS=4;
+const int N_PHASES=20;
+
+boost::atomic<int> arrivals(0);
+boost::atomic<int> errors(0);
+
+// arrives, does some work overlapping the other arrivals, and waits for the phase.
+void split_phase_thread(boost::barrier* b)
+{
+    for (int i = 0; i < N_PHASES; ++i)
+    {
+        arrivals.fetch_add(1);
+        boost::barrier::arrival_token token = b->arrive();
+        b->wait(token);
+        // all the threads have arrived at phase i.
+        if (arrivals.load() < N_THREADS * (i + 1)) errors.fetch_add(1);
+    }
+}
+
+// takes part in the first phase only.
+void drop_thread(boost::barrier* b)
+{
+    b->arrive_and_drop();
+}
+
+void stay_thread(boost::barrier* b)
+{
+    for (int i = 0; i < N_PHASES; ++i)
+    {
+        b->count_down_and_wait();
+    }
+}
+
+boost::latch* continued = 0;
+boost::atomic<int> continuations(0);
+
+void continuation()
+{
+    continuations.fetch_add(1);
+    continued->count_down();
+}
+
+int submissions_run = 0;
+
+void submitted()
+{
+    ++submissions_run;
+}
+
+// runs the closures in place, except the first one whose submission fails.
+struct failing_executor
+{
+    int submissions;
+    failing_executor() : submissions(0) {}
+    template <typename Closure>
+    void submit(Closure closure)
+    {
+        if (submissions++ == 0) throw std::runtime_error("submission failure");
+        closure();
+    }
+};
+
+} // namespace
+
+void test_arrive_and_wait()
+{
+    boost::barrier b(N_THREADS);
+    boost::thread_group g;
+    for (int i = 0; i < N_THREADS; ++i)
+        g.create_thread(boost::bind(&split_phase_thread, &b));
+    g.join_all();
+    BOOST_TEST(arrivals.load() == N_THREADS * N_PHASES);
+    BOOST_TEST(errors.load() == 0);
+}
+
+void test_arrive_and_drop()
+{
+    boost::barrier b(N_THREADS);
+    boost::thread_group g;
+    g.create_thread(boost::bind(&drop_thread, &b));
+    for (int i = 1; i < N_THREADS; ++i)
+        g.create_thread(boost::bind(&stay_thread, &b));
+    // would block for ever if the dropped thread was still expected.
+    g.join_all();
+}
+
+void test_wait_completed_phase()
+{
+    boost::barrier b(1);
+    boost::barrier::arrival_token token = b.arrive();
+    // the phase is already completed.
+    b.wait(token);
+    BOOST_TEST(b.wait());
+}
+
+void test_async_wait()
+{
+    boost::basic_thread_pool pool(2);
+    // the two continuations and this thread.
+    boost::latch done(3);
+    continued = &done;
+    boost::barrier b(2);
+
+    boost::barrier::arrival_token token = b.arrive();
+    // submitted by the second arrival.
+    b.async_wait(pool, token, &continuation);
+    BOOST_TEST(continuations.load() == 0);
+    boost::barrier::arrival_token token2 = b.arrive();
+    b.wait(token2);
+    // submitted at once.
+    b.async_wait(pool, token, &continuation);
+    done.count_down_and_wait();
+    BOOST_TEST(continuations.load() == 2);
+}
+
+void test_failing_submission()
+{
+    failing_executor ex;
+    boost::barrier b(2);
+    boost::barrier::arrival_token token = b.arrive();
+    b.async_wait(ex, token, &submitted);
+    b.async_wait(ex, token, &submitted);
+    try
+    {
+        b.arrive();
+        BOOST_TEST(false);
+    }
+    catch (std::runtime_error&)
+    {
+    }
+    // the second closure has been submitted in spite of the failure of the first submission.
+    BOOST_TEST(ex.submissions == 2);
+    BOOST_TEST(submissions_run == 1);
+    // the barrier is usable.
+    b.arrive();
+    BOOST_TEST(b.wait());
+}
+
+int main()
+{
+    test_arrive_and_wait();
+    test_arrive_and_drop();
+    test_wait_completed_phase();
+    test_async_wait();
+    test_failing_submission();
+    return boost::report_errors();
+}
@@ -0,0 +1,107 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+// (C) Copyright 2014 Vicente J. Botet Escriba
+
+#include <boost/thread/detail/config.hpp>
+
+#include <boost/thread/thread.hpp>
+#include <boost/thread/counting_semaphore.hpp>
+#include <boost/atomic.hpp>
+
+#include <boost/detail/lightweight_test.hpp>
+
+namespace
+{
+  const int N_THREADS = 4;
+  const int N_ACQUIRES = 10000;
+
+  // at most N_PERMITS threads between acquire() and release().
+  const int N_PERMITS = 2;
+  boost::counting_semaphore permits(N_PERMITS);
+  boost::atomic<int> inside(0);
+  boost::atomic<int> too_many(0);
+
+  void permit_thread()
+  {
+    for (int i = 0; i < N_ACQUIRES; ++i)
+    {
+      permits.acquire();
+      if (inside.fetch_add(1) >= N_PERMITS) too_many.fetch_add(1);
+      inside.fetch_sub(1);
+      permits.release();
+    }
+  }
+
+  // each item released by the producer is acquired by exactly one consumer.
+  boost::counting_semaphore items(0);
+  boost::atomic<int> consumed(0);
+
+  void consumer_thread()
+  {
+    for (int i = 0; i < N_ACQUIRES; ++i)
+    {
+      items.acquire();
+      consumed.fetch_add(1);
+    }
+  }
+
+} // namespace
+
+void test_mutual_exclusion()
+{
+  boost::thread_group g;
+  for (int i = 0; i < N_THREADS; ++i)
+    g.create_thread(&permit_thread);
+  g.join_all();
+  BOOST_TEST_EQ(too_many.load(), 0);
+  BOOST_TEST(permits.try_acquire());
+  BOOST_TEST(permits.try_acquire());
+  BOOST_TEST(! permits.try_acquire());
+  permits.release(N_PERMITS);
+}
+
+void test_producer_consumers()
+{
+  boost::thread_group g;
+  for (int i = 0; i < N_THREADS; ++i)
+    g.create_thread(&consumer_thread);
+  for (int i = 0; i < N_THREADS * N_ACQUIRES; i += 3)
+    items.release((std::min)(3, N_THREADS * N_ACQUIRES - i));
+  g.join_all();
+  BOOST_TEST_EQ(consumed.load(), N_THREADS * N_ACQUIRES);
+  BOOST_TEST(! items.try_acquire());
+}
+
+void test_timed_acquire()
+{
+  boost::counting_semaphore s(1);
+  BOOST_TEST(s.try_acquire_for(boost::chrono::milliseconds(100)));
+  boost::chrono::steady_clock::time_point t0 = boost::chrono::steady_clock::now();
+  BOOST_TEST(! s.try_acquire_for(boost::chrono::milliseconds(100)));
+  BOOST_TEST(boost::chrono::steady_clock::now() - t0 >= boost::chrono::milliseconds(100));
+  BOOST_TEST(! s.try_acquire_until(boost::chrono::system_clock::now() + boost::chrono::milliseconds(10)));
+  s.release();
+  BOOST_TEST(s.try_acquire_until(boost::chrono::steady_clock::now() + boost::chrono::milliseconds(100)));
+}
+
+void test_negative_count()
+{
+  try
+  {
+    boost::counting_semaphore s(-1);
+    BOOST_TEST(false);
+  }
+  catch (boost::thread_exception&)
+  {
+  }
+}
+
+int main()
+{
+  test_mutual_exclusion();
+  test_producer_consumers();
+  test_timed_acquire();
+  test_negative_count();
+  return boost::report_errors();
+}
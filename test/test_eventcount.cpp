@@ -0,0 +1,118 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+// (C) Copyright 2014 Vicente J. Botet Escriba
+
+#include <boost/thread/detail/config.hpp>
+
+#include <boost/thread/thread.hpp>
+#include <boost/thread/eventcount.hpp>
+#include <boost/atomic.hpp>
+
+#include <boost/detail/lightweight_test.hpp>
+
+namespace
+{
+  const int N_THREADS = 4;
+  const int N_ITEMS = 20000;
+
+  // a lock-free stock of items, the consumers block on the event count when it is empty.
+  boost::atomic<int> stock(0);
+  boost::atomic<int> consumed(0);
+  boost::eventcount ec;
+
+  bool try_take()
+  {
+    int s = stock.load();
+    while (s > 0)
+    {
+      if (stock.compare_exchange_weak(s, s - 1)) return true;
+    }
+    return false;
+  }
+
+  void take()
+  {
+    while (! try_take())
+    {
+      boost::eventcount::key_type key = ec.prepare_wait();
+      if (try_take())
+      {
+        ec.cancel_wait();
+        return;
+      }
+      ec.commit_wait(key);
+    }
+  }
+
+  void consumer_thread()
+  {
+    for (int i = 0; i < N_ITEMS; ++i)
+    {
+      take();
+      consumed.fetch_add(1);
+    }
+  }
+
+  boost::atomic<bool> done(false);
+
+  void all_waiter_thread()
+  {
+    while (! done.load())
+    {
+      boost::eventcount::key_type key = ec.prepare_wait();
+      if (done.load())
+      {
+        ec.cancel_wait();
+        return;
+      }
+      ec.commit_wait(key);
+    }
+  }
+
+} // namespace
+
+void test_notify_one()
+{
+  boost::thread_group g;
+  for (int i = 0; i < N_THREADS; ++i)
+    g.create_thread(&consumer_thread);
+  for (int i = 0; i < N_THREADS * N_ITEMS; ++i)
+  {
+    stock.fetch_add(1);
+    ec.notify_one();
+  }
+  g.join_all();
+  BOOST_TEST_EQ(consumed.load(), N_THREADS * N_ITEMS);
+  BOOST_TEST_EQ(stock.load(), 0);
+}
+
+void test_notify_all()
+{
+  boost::thread_group g;
+  for (int i = 0; i < N_THREADS; ++i)
+    g.create_thread(&all_waiter_thread);
+  boost::this_thread::sleep_for(boost::chrono::milliseconds(50));
+  done.store(true);
+  ec.notify_all();
+  g.join_all();
+}
+
+void test_notify_without_waiters()
+{
+  boost::eventcount e;
+  e.notify_one();
+  e.notify_all();
+  boost::eventcount::key_type key = e.prepare_wait();
+  e.notify_one();
+  // the notification is posterior to prepare_wait(): doesn't block.
+  e.commit_wait(key);
+}
+
+int main()
+{
+  test_notify_one();
+  test_notify_all();
+  test_notify_without_waiters();
+  return boost::report_errors();
+}
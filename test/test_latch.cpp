@@ -32,8 +32,36 @@ namespace
     //do something else
   }
 
+  // Shared variables for fan-in latch test
+  const int N_COUNT_DOWNS = 10000;
+  boost::latch fan_in_latch(N_THREADS * N_COUNT_DOWNS + 1);
+
+  void fan_in_thread()
+  {
+    for (int i = 0; i < N_COUNT_DOWNS; ++i)
+      fan_in_latch.count_down();
+  }
+
 } // namespace
 
+void test_latch_fan_in()
+{
+  boost::thread_group g;
+  for (int i = 0; i < N_THREADS; ++i)
+    g.create_thread(&fan_in_thread);
+  // the last count down is either this one or wakes this thread up.
+  fan_in_latch.count_down_and_wait();
+  BOOST_TEST(fan_in_latch.try_wait());
+  BOOST_TEST(fan_in_latch.try_count_down());
+  g.join_all();
+
+  fan_in_latch.reset(2);
+  BOOST_TEST(! fan_in_latch.try_wait());
+  BOOST_TEST(! fan_in_latch.try_count_down());
+  BOOST_TEST(fan_in_latch.try_count_down());
+  BOOST_TEST(fan_in_latch.try_wait());
+}
+
 void test_latch()
 {
   boost::thread_group g;
@@ -64,6 +92,7 @@ void test_latch()
 int main()
 {
   test_latch();
+  test_latch_fan_in();
   return boost::report_errors();
 }
 
@@ -0,0 +1,147 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+// (C) Copyright 2014 Vicente J. Botet Escriba
+
+#define BOOST_THREAD_VERSION 4
+
+#include <boost/thread/detail/config.hpp>
+
+#include <boost/thread/executors/numa_thread_pool.hpp>
+#include <boost/thread/detail/numa.hpp>
+#include <boost/atomic.hpp>
+
+#include <boost/detail/lightweight_test.hpp>
+
+namespace
+{
+  const int N_TASKS = 1000;
+
+  boost::numa_thread_pool* pool = 0;
+  boost::atomic<int> done(0);
+  boost::atomic<int> wrong_node(0);
+
+  void task()
+  {
+    ++done;
+  }
+
+  void check_node()
+  {
+    // a closure stolen by another node runs on the node of the thief.
+    if (pool->current_node() >= pool->node_count()) ++wrong_node;
+    ++done;
+  }
+
+  void nested()
+  {
+    // submitted from a worker: stays on the node of the worker.
+    pool->submit(task);
+    ++done;
+  }
+
+  void nop()
+  {
+  }
+
+} // namespace
+
+void test_submit()
+{
+  done = 0;
+  {
+    boost::numa_thread_pool p(2);
+    pool = &p;
+    BOOST_TEST(p.node_count() >= 1);
+    BOOST_TEST(p.current_node() < p.node_count());
+    for (int i = 0; i < N_TASKS; ++i)
+    {
+      p.submit(task);
+      p.submit(nested);
+    }
+    // the pool is not closed before the nested submissions.
+    while (done != 3 * N_TASKS)
+    {
+      boost::this_thread::yield();
+    }
+  }
+  BOOST_TEST_EQ(done, 3 * N_TASKS);
+}
+
+void test_submit_on_node()
+{
+  done = 0;
+  {
+    boost::numa_thread_pool p(1, 1);
+    pool = &p;
+    for (int i = 0; i < N_TASKS; ++i)
+    {
+      p.submit_on_node(i % p.node_count(), check_node);
+    }
+  }
+  BOOST_TEST_EQ(done, N_TASKS);
+  BOOST_TEST_EQ(wrong_node, 0);
+}
+
+void test_closed()
+{
+  boost::numa_thread_pool p(1);
+  p.close();
+  BOOST_TEST(p.closed());
+  try
+  {
+    p.submit(nop);
+    BOOST_TEST(false);
+  }
+  catch (boost::sync_queue_is_closed&)
+  {
+  }
+}
+
+void test_restricted_affinity()
+{
+#if defined BOOST_THREAD_LINUX && defined CPU_ISSET
+  // restricted to the CPUs of a single node, as by taskset or a cpuset.
+  cpu_set_t saved;
+  CPU_ZERO(&saved);
+  BOOST_TEST(sched_getaffinity(0, sizeof(saved), &saved) == 0);
+  boost::this_system::cpu_topology const& topo = boost::this_system::topology();
+  std::vector<unsigned> cpus;
+  for (std::size_t n = 0; n < topo.numa_nodes().size() && cpus.empty(); ++n)
+  {
+    for (std::size_t c = 0; c < topo.numa_nodes()[n].size(); ++c)
+    {
+      if (CPU_ISSET(topo.numa_nodes()[n][c], &saved)) cpus.push_back(topo.numa_nodes()[n][c]);
+    }
+  }
+  if (cpus.empty()) return;
+  cpu_set_t restricted;
+  CPU_ZERO(&restricted);
+  CPU_SET(cpus[0], &restricted);
+  BOOST_TEST(sched_setaffinity(0, sizeof(restricted), &restricted) == 0);
+  done = 0;
+  {
+    boost::numa_thread_pool p;
+    pool = &p;
+    BOOST_TEST_EQ(p.node_count(), 1u);
+    for (int i = 0; i < N_TASKS; ++i)
+    {
+      p.submit(task);
+    }
+    while (done != N_TASKS)
+    {
+      boost::this_thread::yield();
+    }
+  }
+  BOOST_TEST(sched_setaffinity(0, sizeof(saved), &saved) == 0);
+#endif
+}
+
+int main()
+{
+  test_submit();
+  test_submit_on_node();
+  test_closed();
+  test_restricted_affinity();
+  return boost::report_errors();
+}
@@ -0,0 +1,204 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+// (C) Copyright 2014 Vicente J. Botet Escriba
+
+#define BOOST_THREAD_VERSION 4
+#define BOOST_THREAD_PROVIDES_EXECUTORS
+#define BOOST_THREAD_USES_CHRONO
+
+#include <boost/thread/detail/config.hpp>
+
+#include <boost/thread/executors/shard_runtime.hpp>
+#include <boost/thread/detail/numa.hpp>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+
+#include <boost/detail/lightweight_test.hpp>
+#include <vector>
+
+namespace
+{
+  const int N_SHARDS = 3;
+  const int N_TASKS = 1000;
+
+  boost::shard_runtime* runtime = 0;
+  // per-shard state only accessed by the thread of the shard.
+  std::vector<int> last_seen(N_SHARDS, -1);
+  boost::atomic<int> out_of_order(0);
+  boost::atomic<int> wrong_shard(0);
+  boost::atomic<int> done(0);
+
+  void ordered_task(std::size_t s, int seq)
+  {
+    if (runtime->this_shard() != s) ++wrong_shard;
+    if (last_seen[s] != seq - 1) ++out_of_order;
+    last_seen[s] = seq;
+    ++done;
+  }
+
+  // bounces between the shards until hops reaches 0.
+  void bounce(int hops)
+  {
+    ++done;
+    if (hops == 0) return;
+    std::size_t next = (runtime->this_shard() + 1) % runtime->shard_count();
+    runtime->submit_to(next, boost::bind(bounce, hops - 1));
+  }
+
+  void nop()
+  {
+  }
+
+  int shard_index()
+  {
+    return static_cast<int>(runtime->this_shard());
+  }
+
+  // run by shard 1 while shard 0 waits for it.
+  int call_back_shard_0()
+  {
+    return runtime->call(0, shard_index).get() + 10;
+  }
+
+  int call_shard_1()
+  {
+    return runtime->call(1, call_back_shard_0).get() + 100;
+  }
+
+  int current_cpu()
+  {
+    return boost::detail::get_current_cpu();
+  }
+
+  boost::atomic<int> timer_fired(0);
+  void on_timer()
+  {
+    if (runtime->this_shard() != 1) ++wrong_shard;
+    ++timer_fired;
+  }
+
+} // namespace
+
+void test_submit_to_order()
+{
+  {
+    boost::shard_runtime rt(N_SHARDS);
+    runtime = &rt;
+    BOOST_TEST_EQ(rt.shard_count(), std::size_t(N_SHARDS));
+    BOOST_TEST_EQ(rt.this_shard(), rt.shard_count());
+    for (int i = 0; i < N_TASKS; ++i)
+    {
+      for (int s = 0; s < N_SHARDS; ++s)
+      {
+        rt.submit_to(s, boost::bind(ordered_task, std::size_t(s), i));
+      }
+    }
+  }
+  BOOST_TEST_EQ(done, N_TASKS * N_SHARDS);
+  BOOST_TEST_EQ(out_of_order, 0);
+  BOOST_TEST_EQ(wrong_shard, 0);
+}
+
+void test_cross_shard_messages_complete_before_destruction()
+{
+  done = 0;
+  {
+    boost::shard_runtime rt(N_SHARDS, 4);
+    runtime = &rt;
+    // more messages than the queues between two shards can store.
+    for (int i = 0; i < 100; ++i)
+    {
+      rt.submit_to(i % N_SHARDS, boost::bind(bounce, 50));
+    }
+  }
+  BOOST_TEST_EQ(done, 100 * 51);
+}
+
+void test_call()
+{
+  boost::shard_runtime rt(N_SHARDS);
+  runtime = &rt;
+  boost::future<int> f = rt.call(2, shard_index);
+  BOOST_TEST_EQ(f.get(), 2);
+}
+
+void test_nested_call()
+{
+  boost::shard_runtime rt(2);
+  runtime = &rt;
+  // each shard waits for a call to the other one.
+  boost::future<int> f = rt.call(0, call_shard_1);
+  BOOST_TEST_EQ(f.get(), 110);
+}
+
+void test_submit_after()
+{
+  boost::shard_runtime rt(N_SHARDS);
+  runtime = &rt;
+  boost::shard_runtime::clock::time_point start = boost::shard_runtime::clock::now();
+  rt.submit_after(1, boost::chrono::milliseconds(20), on_timer);
+  while (timer_fired == 0)
+  {
+    boost::this_thread::yield();
+  }
+  BOOST_TEST(boost::shard_runtime::clock::now() - start >= boost::chrono::milliseconds(20));
+  BOOST_TEST_EQ(wrong_shard, 0);
+}
+
+void test_closed()
+{
+  boost::shard_runtime rt(N_SHARDS);
+  rt.close();
+  BOOST_TEST(rt.closed());
+  try
+  {
+    rt.submit_to(0, nop);
+    BOOST_TEST(false);
+  }
+  catch (boost::sync_queue_is_closed&)
+  {
+  }
+}
+
+void test_restricted_affinity()
+{
+#if defined BOOST_THREAD_LINUX && defined CPU_ISSET
+  // restricted to the last allowed CPU, as by taskset or a cpuset: the shards are bound to it.
+  cpu_set_t saved;
+  CPU_ZERO(&saved);
+  BOOST_TEST(sched_getaffinity(0, sizeof(saved), &saved) == 0);
+  int last = -1;
+  for (int id = 0; id < CPU_SETSIZE; ++id)
+  {
+    if (CPU_ISSET(id, &saved)) last = id;
+  }
+  if (last < 0) return;
+  cpu_set_t restricted;
+  CPU_ZERO(&restricted);
+  CPU_SET(last, &restricted);
+  BOOST_TEST(sched_setaffinity(0, sizeof(restricted), &restricted) == 0);
+  {
+    boost::shard_runtime rt(2);
+    runtime = &rt;
+    if (boost::detail::get_current_cpu() >= 0)
+    {
+      BOOST_TEST_EQ(rt.call(0, current_cpu).get(), last);
+      BOOST_TEST_EQ(rt.call(1, current_cpu).get(), last);
+    }
+  }
+  BOOST_TEST(sched_setaffinity(0, sizeof(saved), &saved) == 0);
+#endif
+}
+
+int main()
+{
+  test_submit_to_order();
+  test_cross_shard_messages_complete_before_destruction();
+  test_call();
+  test_nested_call();
+  test_submit_after();
+  test_closed();
+  test_restricted_affinity();
+  return boost::report_errors();
+}
@@ -0,0 +1,110 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+// (C) Copyright 2014 Vicente J. Botet Escriba
+
+#define BOOST_THREAD_VERSION 4
+
+#include <boost/thread/detail/config.hpp>
+
+#include <boost/thread/executors/sharded_executor.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/lock_guard.hpp>
+#include <boost/thread/tss.hpp>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+
+#include <boost/detail/lightweight_test.hpp>
+#include <vector>
+
+namespace
+{
+  const int N_KEYS = 8;
+  const int N_TASKS = 1000;
+
+  // per-key state only accessed by the thread of the key shard.
+  std::vector<int> last_seen(N_KEYS, -1);
+  // the index of the first worker thread that ran a task of the key.
+  std::vector<int> owner(N_KEYS, -1);
+  boost::atomic<int> out_of_order(0);
+  boost::atomic<int> wrong_thread(0);
+  boost::atomic<int> any_done(0);
+
+  boost::atomic<int> n_workers(0);
+  boost::thread_specific_ptr<int> worker_index;
+
+  int current_worker()
+  {
+    if (worker_index.get() == 0) worker_index.reset(new int(n_workers.fetch_add(1)));
+    return *worker_index;
+  }
+
+  void keyed_task(int key, int seq)
+  {
+    if (last_seen[key] != seq - 1) ++out_of_order;
+    last_seen[key] = seq;
+    if (seq == 0) owner[key] = current_worker();
+    else if (owner[key] != current_worker()) ++wrong_thread;
+  }
+
+  void any_task()
+  {
+    ++any_done;
+  }
+
+  void nop()
+  {
+  }
+
+} // namespace
+
+void test_keyed_order()
+{
+  {
+    boost::sharded_executor ex(4);
+    BOOST_TEST_EQ(ex.shard_count(), 4u);
+    for (int i = 0; i < N_TASKS; ++i)
+    {
+      for (int k = 0; k < N_KEYS; ++k)
+      {
+        ex.submit(k, boost::bind(keyed_task, k, i));
+      }
+      ex.submit_any(&any_task);
+    }
+  }
+  BOOST_TEST_EQ(out_of_order.load(), 0);
+  BOOST_TEST_EQ(wrong_thread.load(), 0);
+  BOOST_TEST_EQ(any_done.load(), N_TASKS);
+  for (int k = 0; k < N_KEYS; ++k)
+  {
+    BOOST_TEST_EQ(last_seen[k], N_TASKS - 1);
+  }
+}
+
+void test_depth()
+{
+  boost::sharded_executor ex(2);
+  std::size_t const s = ex.shard_of(42);
+  BOOST_TEST(s < 2u);
+  BOOST_TEST_EQ(ex.shard_of(42), s);
+  BOOST_TEST_EQ(ex.depth(0) + ex.depth(1), 0u);
+  ex.close();
+  BOOST_TEST(ex.closed());
+  bool thrown = false;
+  try
+  {
+    ex.submit(42, &nop);
+  }
+  catch (...)
+  {
+    thrown = true;
+  }
+  BOOST_TEST(thrown);
+}
+
+int main()
+{
+  test_keyed_order();
+  test_depth();
+  return boost::report_errors();
+}
@@ -0,0 +1,98 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#define BOOST_THREAD_PROVIDES_INTERRUPTIONS
+
+#include <boost/thread/detail/config.hpp>
+
+#include <boost/thread/thread.hpp>
+#include <boost/thread/tree_barrier.hpp>
+#include <boost/atomic.hpp>
+
+#include <boost/detail/lightweight_test.hpp>
+#include <vector>
+
+namespace {
+
+// Shared variables for generation barrier test
+const int N_THREADS=3;
+boost::tree_barrier gen_barrier(N_THREADS);
+boost::mutex mutex;
+long global_parameter;
+
+void barrier_thread()
+{
+    for (int i = 0; i < 5; ++i)
+    {
+        if (gen_barrier.wait())
+        {
+            boost::unique_lock<boost::mutex> lock(mutex);
+            global_parameter++;
+        }
+    }
+}
+
+// Shared variables for the many threads barrier test, with an odd number of threads
+const int N_MANY_THREADS=17;
+const int N_PHASES=200;
+boost::tree_barrier many_barrier(N_MANY_THREADS);
+boost::atomic<long> arrivals(0);
+boost::atomic<long> completions(0);
+boost::atomic<long> errors(0);
+
+void many_barrier_thread()
+{
+    for (long i = 0; i < N_PHASES; ++i)
+    {
+        arrivals.fetch_add(1);
+        if (many_barrier.wait()) completions.fetch_add(1);
+        // all the threads have arrived at this phase, and none can have arrived twice at the next one.
+        long const a = arrivals.load();
+        if (a < N_MANY_THREADS * (i + 1) || a > N_MANY_THREADS * (i + 2)) errors.fetch_add(1);
+    }
+}
+
+} // namespace
+
+void test_many_threads()
+{
+    boost::thread_group g;
+    for (int i = 0; i < N_MANY_THREADS; ++i)
+        g.create_thread(&many_barrier_thread);
+    g.join_all();
+    BOOST_TEST_EQ(errors.load(), 0);
+    BOOST_TEST_EQ(completions.load(), N_PHASES);
+}
+
+void test_barrier()
+{
+    boost::thread_group g;
+    global_parameter = 0;
+
+    try
+    {
+        for (int i = 0; i < N_THREADS; ++i)
+            g.create_thread(&barrier_thread);
+        g.join_all();
+    }
+    catch(...)
+    {
+        g.interrupt_all();
+        g.join_all();
+        throw;
+    }
+
+    BOOST_TEST(global_parameter==5);
+
+}
+
+int main()
+{
+
+    test_barrier();
+    test_many_threads();
+    return boost::report_errors();
+}
+
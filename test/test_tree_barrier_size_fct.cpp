@@ -0,0 +1,99 @@
+// (C) Copyright 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#define BOOST_THREAD_PROVIDES_INTERRUPTIONS
+
+#include <boost/thread/detail/config.hpp>
+
+#include <boost/thread/thread.hpp>
+#include <boost/thread/tree_barrier.hpp>
+
+#include <boost/detail/lightweight_test.hpp>
+#include <vector>
+
+namespace {
+
+
+// Shared variables for generation barrier test
+long global_parameter;
+const int N_THREADS=3;
+
+unsigned int size_fct() {
+  global_parameter++;
+  return N_THREADS;
+}
+
+boost::tree_barrier gen_barrier(N_THREADS, &size_fct);
+
+void barrier_thread()
+{
+    for (int i = 0; i < 5; ++i)
+    {
+        gen_barrier.count_down_and_wait();
+    }
+}
+
+// Shared variables for the resized barrier test
+int resizes = 0;
+
+unsigned int resize_fct() {
+  ++resizes;
+  return 3;
+}
+
+boost::tree_barrier resized_barrier(2, &resize_fct);
+
+void resized_barrier_thread(int waits)
+{
+    for (int i = 0; i < waits; ++i)
+    {
+        resized_barrier.wait();
+    }
+}
+
+} // namespace
+
+void test_resized_barrier()
+{
+    // 2 threads at the first phase, 3 at the second one.
+    boost::thread t1(&resized_barrier_thread, 2);
+    resized_barrier.wait();
+    boost::thread t2(&resized_barrier_thread, 1);
+    resized_barrier.wait();
+    t1.join();
+    t2.join();
+    BOOST_TEST_EQ(resizes, 2);
+}
+
+void test_barrier()
+{
+    boost::thread_group g;
+    global_parameter = 0;
+
+    try
+    {
+        for (int i = 0; i < N_THREADS; ++i)
+            g.create_thread(&barrier_thread);
+        g.join_all();
+    }
+    catch(...)
+    {
+        g.interrupt_all();
+        g.join_all();
+        throw;
+    }
+
+    BOOST_TEST(global_parameter==5);
+
+}
+
+int main()
+{
+
+    test_barrier();
+    test_resized_barrier();
+    return boost::report_errors();
+}
+
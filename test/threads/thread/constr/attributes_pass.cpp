@@ -0,0 +1,130 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+// (C) Copyright 2014 Vicente J. Botet Escriba
+
+// <boost/thread/thread.hpp>
+
+// class thread
+
+// template <class F> thread(attributes const& attrs, F f);
+
+#define BOOST_THREAD_VERSION 4
+#define BOOST_THREAD_PROVIDES_EXECUTORS
+
+#include <boost/thread/thread_only.hpp>
+#include <boost/thread/executors/basic_thread_pool.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/lock_guard.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/detail/lightweight_test.hpp>
+#include <string>
+#include <set>
+
+#if defined BOOST_THREAD_LINUX && defined __GLIBC__
+#define CHECK_NATIVE_NAME
+#endif
+
+std::string native_name()
+{
+#if defined CHECK_NATIVE_NAME
+  char name[16];
+  if (pthread_getname_np(pthread_self(), name, sizeof(name)) == 0) return name;
+#endif
+  return std::string();
+}
+
+std::string seen_name;
+bool on_cpu0 = false;
+
+void record_attributes()
+{
+  seen_name = native_name();
+#if defined BOOST_THREAD_DEFINES_THREAD_ATTRIBUTES_CPU_SET
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  on_cpu0 = pthread_getaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0
+      && CPU_ISSET(0, &cpus) && CPU_COUNT(&cpus) == 1;
+#endif
+}
+
+boost::mutex names_mtx;
+std::set<std::string> worker_names;
+
+void record_worker_name()
+{
+  boost::lock_guard<boost::mutex> lk(names_mtx);
+  worker_names.insert(native_name());
+}
+
+struct name_workers
+{
+  void operator()(unsigned worker, boost::thread_attributes& attrs) const
+  {
+    attrs.set_name("worker-" + boost::lexical_cast<std::string>(worker));
+    attrs.set_affinity(0u);
+  }
+};
+
+int main()
+{
+  {
+    boost::thread_attributes attrs;
+    BOOST_TEST_EQ(attrs.get_numa_node(), -1);
+    attrs.set_numa_node(0);
+    BOOST_TEST_EQ(attrs.get_numa_node(), 0);
+  }
+  {
+    boost::thread_attributes attrs;
+    try
+    {
+      attrs.set_sched_policy(-1, 0);
+      BOOST_TEST(false);
+    }
+    catch (boost::thread_resource_error&)
+    {
+    }
+    try
+    {
+      attrs.set_sched_policy(SCHED_FIFO, sched_get_priority_max(SCHED_FIFO) + 1);
+      BOOST_TEST(false);
+    }
+    catch (boost::thread_resource_error&)
+    {
+    }
+    // the invalid policies have not been kept.
+    boost::thread t(attrs, record_attributes);
+    t.join();
+  }
+  {
+    boost::thread_attributes attrs;
+    attrs.set_name("a-very-long-thread-name");
+    BOOST_TEST(attrs.get_name() == "a-very-long-thread-name");
+    attrs.set_affinity(0u);
+    boost::thread t(attrs, record_attributes);
+    t.join();
+#if defined CHECK_NATIVE_NAME
+    BOOST_TEST_EQ(seen_name, std::string("a-very-long-thr"));
+#endif
+#if defined BOOST_THREAD_DEFINES_THREAD_ATTRIBUTES_CPU_SET
+    BOOST_TEST(on_cpu0);
+#endif
+  }
+  {
+    {
+      boost::basic_thread_pool pool(3, boost::make_worker_attributes(name_workers()));
+      for (int i = 0; i < 30; ++i)
+      {
+        pool.submit(record_worker_name);
+      }
+    }
+#if defined CHECK_NATIVE_NAME
+    BOOST_TEST(! worker_names.empty());
+    for (std::set<std::string>::const_iterator it = worker_names.begin(); it != worker_names.end(); ++it)
+    {
+      BOOST_TEST_EQ(it->substr(0, 7), std::string("worker-"));
+    }
+#endif
+  }
+  return boost::report_errors();
+}
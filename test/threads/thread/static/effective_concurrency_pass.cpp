@@ -0,0 +1,29 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/topology.hpp>
+
+// unsigned this_system::effective_concurrency();
+// unsigned this_system::refresh_effective_concurrency();
+
+#include <boost/thread/thread_only.hpp>
+#include <boost/thread/topology.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+int main()
+{
+  unsigned n = boost::this_system::effective_concurrency();
+  BOOST_TEST(n >= 1);
+  if (boost::thread::hardware_concurrency() != 0)
+  {
+    BOOST_TEST(n <= boost::thread::hardware_concurrency());
+  }
+  // the value is cached.
+  BOOST_TEST_EQ(boost::this_system::effective_concurrency(), n);
+  // nothing has changed the affinity or the quota of the process.
+  BOOST_TEST_EQ(boost::this_system::refresh_effective_concurrency(), n);
+  BOOST_TEST_EQ(boost::this_system::effective_concurrency(), n);
+  return boost::report_errors();
+}
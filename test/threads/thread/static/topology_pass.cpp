@@ -0,0 +1,45 @@
+// Copyright (C) 2014 Vicente J. Botet Escriba
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/topology.hpp>
+
+// this_system::cpu_topology const& this_system::topology();
+
+#include <boost/thread/thread_only.hpp>
+#include <boost/thread/topology.hpp>
+#include <boost/detail/lightweight_test.hpp>
+#include <algorithm>
+
+typedef boost::this_system::cpu_topology topology_t;
+
+bool contains(topology_t::cpu_list const& l, unsigned id)
+{
+  return std::find(l.begin(), l.end(), id) != l.end();
+}
+
+int main()
+{
+  topology_t const& t = boost::this_system::topology();
+  // a snapshot: the same object is returned each time.
+  BOOST_TEST(&t == &boost::this_system::topology());
+
+  BOOST_TEST(t.logical_cpu_count() > 0);
+  BOOST_TEST(t.physical_core_count() > 0);
+  BOOST_TEST(t.physical_core_count() <= t.logical_cpu_count());
+  BOOST_TEST_EQ(boost::thread::physical_concurrency(), t.physical_core_count());
+  BOOST_TEST(! t.numa_nodes().empty());
+  BOOST_TEST_EQ(t.numa_nodes().size(), t.numa_node_ids().size());
+
+  for (std::size_t i = 0; i < t.cpus().size(); ++i)
+  {
+    topology_t::cpu const& c = t.cpus()[i];
+    BOOST_TEST(t.find(c.id) == &c);
+    BOOST_TEST(c.core < t.cores().size() && contains(t.cores()[c.core], c.id));
+    BOOST_TEST(c.l2 < t.l2_groups().size() && contains(t.l2_groups()[c.l2], c.id));
+    BOOST_TEST(c.l3 < t.l3_groups().size() && contains(t.l3_groups()[c.l3], c.id));
+    BOOST_TEST(c.numa_node < t.numa_nodes().size());
+  }
+  return boost::report_errors();
+}